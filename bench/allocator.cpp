@@ -0,0 +1,204 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+// Cost of the storage behind short-lived buffers.
+// Each request builds some buffers, fills them,
+// drains them and destroys them, as a server does
+// for every message it handles:
+//
+//  multi   16KB written in 1KB pieces into a
+//          multi_buffer of 4KB blocks
+//  flat    64KB written in 512 byte pieces into
+//          a growing dynamic_flat_buffer
+//  rope    32 pieces of 256 bytes appended to a
+//          buffer_rope, each copied into a block
+//
+// The storage comes from new and delete through
+// std::allocator, from a block_pool, and from a
+// monotonic arena which is reset after every
+// request. When the standard library provides
+// <memory_resource> the same buffers are also
+// run through std::pmr::polymorphic_allocator
+// over several resources.
+//
+// usage: bench_allocator [requests]
+
+#include <boost/buffers/block_pool.hpp>
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/buffer_rope.hpp>
+#include <boost/buffers/dynamic_flat_buffer.hpp>
+#include <boost/buffers/monotonic_arena.hpp>
+#include <boost/buffers/multi_buffer.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace buffers = boost::buffers;
+using clock_type = std::chrono::steady_clock;
+
+namespace {
+
+unsigned char const src[1024] = {};
+
+template<class DynamicBuffer>
+std::size_t
+fill(
+    DynamicBuffer& b,
+    std::size_t total,
+    std::size_t piece)
+{
+    for(std::size_t i = 0; i < total; i += piece)
+        b.commit(buffers::buffer_copy(
+            b.prepare(piece),
+            buffers::const_buffer(src, piece)));
+    auto const n = b.size();
+    b.consume(n);
+    return n;
+}
+
+template<class Allocator>
+std::size_t
+do_multi(Allocator const& alloc)
+{
+    buffers::basic_multi_buffer<Allocator> b(
+        std::size_t(-1), 4096, alloc);
+    return fill(b, 16 * 1024, 1024);
+}
+
+template<class Allocator>
+std::size_t
+do_flat(Allocator const& alloc)
+{
+    buffers::basic_dynamic_flat_buffer<Allocator> b(
+        std::size_t(-1), 2, alloc);
+    return fill(b, 64 * 1024, 512);
+}
+
+template<class Allocator>
+std::size_t
+do_rope(Allocator const& alloc)
+{
+    buffers::basic_buffer_rope<true, Allocator> r(alloc);
+    for(int i = 0; i < 32; ++i)
+        r.append(buffers::const_buffer(src, 256));
+    return r.size();
+}
+
+struct no_reset
+{
+    void operator()() const noexcept
+    {
+    }
+};
+
+// nanoseconds per request
+template<class Allocator, class Reset>
+double
+measure(
+    std::size_t (*f)(Allocator const&),
+    Allocator const& alloc,
+    Reset const& reset,
+    std::size_t requests)
+{
+    std::size_t total = 0;
+    // warm up
+    for(std::size_t i = 0; i < requests / 10 + 1; ++i)
+    {
+        total += f(alloc);
+        reset();
+    }
+    auto const t0 = clock_type::now();
+    for(std::size_t i = 0; i < requests; ++i)
+    {
+        total += f(alloc);
+        reset();
+    }
+    auto const ns = std::chrono::duration_cast<
+        std::chrono::nanoseconds>(
+            clock_type::now() - t0).count();
+    if(total == 0)
+        std::printf("\n");
+    return double(ns) / double(requests);
+}
+
+template<class Allocator, class Reset = no_reset>
+void
+run(
+    char const* name,
+    Allocator const& alloc,
+    std::size_t requests,
+    Reset const& reset = {})
+{
+    auto const multi = measure(
+        &do_multi<Allocator>, alloc, reset, requests);
+    auto const flat = measure(
+        &do_flat<Allocator>, alloc, reset, requests);
+    auto const rope = measure(
+        &do_rope<Allocator>, alloc, reset, requests);
+    std::printf("  %-28s %9.0f %9.0f %9.0f\n",
+        name, multi, flat, rope);
+}
+
+} // (anon)
+
+int
+main(int argc, char** argv)
+{
+    std::size_t requests = 100000;
+    if(argc > 1)
+        requests = static_cast<std::size_t>(
+            std::strtoul(argv[1], nullptr, 10));
+
+    std::printf("%zu requests, ns per request\n", requests);
+    std::printf("  %-28s %9s %9s %9s\n",
+        "", "multi", "flat", "rope");
+
+    run("std::allocator", std::allocator<
+        unsigned char>(), requests);
+
+    buffers::block_pool pool;
+    run("block_pool_allocator",
+        buffers::block_pool_allocator<
+            unsigned char>(pool), requests);
+
+    buffers::monotonic_arena arena;
+    run("monotonic_allocator",
+        buffers::monotonic_allocator<
+            unsigned char>(arena), requests,
+        [&arena]{ arena.reset(); });
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+    using pmr_alloc =
+        std::pmr::polymorphic_allocator<unsigned char>;
+
+    run("pmr new_delete_resource",
+        pmr_alloc(std::pmr::new_delete_resource()),
+        requests);
+
+    {
+        std::pmr::unsynchronized_pool_resource mr;
+        run("pmr unsynchronized_pool",
+            pmr_alloc(&mr), requests);
+    }
+
+    {
+        buffers::block_pool_resource mr(pool);
+        run("pmr block_pool_resource",
+            pmr_alloc(&mr), requests);
+    }
+
+    {
+        buffers::monotonic_resource mr(arena);
+        run("pmr monotonic_resource",
+            pmr_alloc(&mr), requests,
+            [&arena]{ arena.reset(); });
+    }
+#endif
+}
@@ -0,0 +1,229 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+// Streaming parse throughput of flat buffers.
+// A stream of newline-terminated records is
+// read in fixed size chunks; after each read
+// every complete record is parsed and consumed,
+// leaving a partial record in the buffer.
+
+#include <boost/buffers/dynamic_flat_buffer.hpp>
+#include <boost/buffers/flat_buffer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace buffers = boost::buffers;
+using clock_type = std::chrono::steady_clock;
+
+namespace {
+
+// records with lengths drawn from [lo, hi],
+// and one record of `big` bytes every `every`
+std::string
+make_stream(
+    std::size_t total,
+    std::size_t lo,
+    std::size_t hi,
+    std::size_t big,
+    std::size_t every)
+{
+    std::string s;
+    s.reserve(total + big + hi);
+    std::uint32_t seed = 1;
+    std::size_t i = 0;
+    while(s.size() < total)
+    {
+        seed = seed * 1103515245 + 12345;
+        auto n = lo + (seed >> 8) % (hi - lo + 1);
+        if(every != 0 && ++i % every == 0)
+            n = big;
+        s.append(n - 1, 'a' + i % 26);
+        s.push_back('\n');
+    }
+    return s;
+}
+
+// consumes on every record, so each
+// consume moves the rest of the data
+struct string_strategy
+{
+    std::string s;
+
+    static char const* name() { return "std::string erase"; }
+
+    char*
+    prepare(std::size_t n)
+    {
+        s.resize(s.size() + n);
+        return &s[s.size() - n];
+    }
+
+    void
+    commit(std::size_t n, std::size_t prepared)
+    {
+        s.resize(s.size() - prepared + n);
+    }
+
+    buffers::const_buffer
+    data() const
+    {
+        return { s.data(), s.size() };
+    }
+
+    void
+    consume(std::size_t n)
+    {
+        s.erase(0, n);
+    }
+
+    std::size_t
+    capacity() const
+    {
+        return s.capacity();
+    }
+};
+
+template<class Buffer>
+struct buffer_strategy
+{
+    Buffer b;
+
+    char*
+    prepare(std::size_t n)
+    {
+        return static_cast<char*>(
+            b.prepare(n).data());
+    }
+
+    void
+    commit(std::size_t n, std::size_t)
+    {
+        b.commit(n);
+    }
+
+    buffers::const_buffer
+    data() const
+    {
+        return b.data();
+    }
+
+    void
+    consume(std::size_t n)
+    {
+        b.consume(n);
+    }
+
+    std::size_t
+    capacity() const
+    {
+        return b.capacity();
+    }
+};
+
+template<class Strategy>
+void
+run(
+    Strategy& st,
+    char const* name,
+    std::string const& in,
+    std::size_t read_size)
+{
+    std::size_t records = 0;
+    std::size_t peak = 0;
+    auto const t0 = clock_type::now();
+    std::size_t pos = 0;
+    while(pos < in.size())
+    {
+        // read
+        auto n = in.size() - pos;
+        if(n > read_size)
+            n = read_size;
+        std::memcpy(st.prepare(read_size),
+            in.data() + pos, n);
+        st.commit(n, read_size);
+        pos += n;
+        if(peak < st.capacity())
+            peak = st.capacity();
+
+        // parse
+        for(;;)
+        {
+            auto const b = st.data();
+            auto const p = static_cast<
+                char const*>(b.data());
+            auto const e = static_cast<char const*>(
+                std::memchr(p, '\n', b.size()));
+            if(! e)
+                break;
+            ++records;
+            st.consume(e - p + 1);
+        }
+    }
+    auto const us = std::chrono::duration_cast<
+        std::chrono::microseconds>(
+            clock_type::now() - t0).count();
+    std::printf(
+        "  %-28s %8.1f MB/s  %8zu records"
+        "  peak capacity %9zu\n",
+        name, us > 0 ? in.size() / double(us) : 0.0,
+        records, peak);
+}
+
+void
+run_all(
+    char const* workload,
+    std::string const& in,
+    std::size_t read_size)
+{
+    std::printf("%s, %zu byte reads:\n",
+        workload, read_size);
+    {
+        string_strategy st;
+        run(st, st.name(), in, read_size);
+    }
+    {
+        buffer_strategy<buffers::dynamic_flat_buffer> st{
+            buffers::dynamic_flat_buffer(
+                std::size_t(-1), 2) };
+        run(st, "dynamic_flat_buffer x2", in, read_size);
+    }
+    {
+        buffer_strategy<buffers::dynamic_flat_buffer> st{
+            buffers::dynamic_flat_buffer(
+                std::size_t(-1), 1.5) };
+        run(st, "dynamic_flat_buffer x1.5", in, read_size);
+    }
+    {
+        std::vector<unsigned char> v(4 * 1024 * 1024);
+        buffer_strategy<buffers::flat_buffer> st{
+            buffers::flat_buffer(v.data(), v.size()) };
+        run(st, "flat_buffer (4MB fixed)", in, read_size);
+    }
+}
+
+} // (anon)
+
+int
+main()
+{
+    std::size_t const total = 32 * 1024 * 1024;
+    run_all("short records",
+        make_stream(total, 16, 128, 0, 0), 4096);
+    run_all("short records",
+        make_stream(total, 16, 128, 0, 0), 65536);
+    run_all("records with 256KB bodies",
+        make_stream(total, 16, 512, 256 * 1024, 2000), 16384);
+    run_all("1MB records",
+        make_stream(total, 1024 * 1024,
+            1024 * 1024, 0, 0), 65536);
+}
@@ -0,0 +1,249 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+// TLB behaviour of buffer_copy with and without
+// huge pages. Two large flat buffers are filled,
+// then small buffer_copy calls move bytes between
+// random offsets, so nearly every copy touches a
+// page whose translation is not cached, and large
+// sequential copies stream through both buffers.
+// The storage comes from std::allocator, and from
+// a huge_page_arena; the arena reports which path
+// its allocations took. Where the kernel allows
+// it, dTLB load misses are counted as well.
+//
+// usage: bench_huge_page_arena [megabytes]
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/dynamic_flat_buffer.hpp>
+#include <boost/buffers/huge_page_arena.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace buffers = boost::buffers;
+using clock_type = std::chrono::steady_clock;
+
+namespace {
+
+// counts dTLB load misses of this thread,
+// if the kernel permits it
+class tlb_counter
+{
+    int fd_ = -1;
+
+public:
+    tlb_counter()
+    {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config =
+            PERF_COUNT_HW_CACHE_DTLB |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(::syscall(
+            __NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~tlb_counter()
+    {
+#if defined(__linux__)
+        if(fd_ != -1)
+            ::close(fd_);
+#endif
+    }
+
+    bool
+    available() const noexcept
+    {
+        return fd_ != -1;
+    }
+
+    void
+    start() noexcept
+    {
+#if defined(__linux__)
+        if(fd_ == -1)
+            return;
+        ::ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    std::uint64_t
+    stop() noexcept
+    {
+        std::uint64_t n = 0;
+#if defined(__linux__)
+        if(fd_ == -1)
+            return 0;
+        ::ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if(::read(fd_, &n, sizeof(n)) != sizeof(n))
+            n = 0;
+#endif
+        return n;
+    }
+};
+
+template<class Buffer>
+void
+fill(Buffer& b, std::size_t n, int c)
+{
+    b.reserve(n);
+    auto const mb = b.prepare(n);
+    std::memset(mb.data(), c, n);
+    b.commit(n);
+}
+
+template<class Buffer>
+void
+run(
+    char const* name,
+    Buffer& src,
+    Buffer& dst,
+    tlb_counter& tlb)
+{
+    auto const n = src.size();
+    auto const s = static_cast<unsigned char const*>(
+        src.data().data());
+    auto const d = static_cast<unsigned char*>(
+        dst.prepare(n).data());
+
+    // random small copies
+    std::size_t const count = 4000000;
+    std::size_t const len = 64;
+    std::uint64_t seed = 1;
+    auto const rand = [&seed]
+        {
+            seed = seed * 6364136223846793005ULL +
+                1442695040888963407ULL;
+            return static_cast<std::size_t>(seed >> 17);
+        };
+    std::size_t total = 0;
+    tlb.start();
+    auto t0 = clock_type::now();
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        auto const from = rand() % (n - len);
+        auto const to = rand() % (n - len);
+        total += buffers::buffer_copy(
+            buffers::mutable_buffer(d + to, len),
+            buffers::const_buffer(s + from, len));
+    }
+    auto ns = std::chrono::duration_cast<
+        std::chrono::nanoseconds>(
+            clock_type::now() - t0).count();
+    auto misses = tlb.stop();
+    std::printf(
+        "  %-16s random %zu-byte copies: %6.1f ns/copy",
+        name, len, double(ns) / count);
+    if(tlb.available())
+        std::printf(", %5.2f dTLB misses/copy",
+            double(misses) / count);
+    std::printf("\n");
+
+    // sequential large copies
+    std::size_t const chunk = 1024 * 1024;
+    int const passes = 4;
+    tlb.start();
+    t0 = clock_type::now();
+    for(int p = 0; p < passes; ++p)
+        for(std::size_t i = 0; i + chunk <= n; i += chunk)
+            total += buffers::buffer_copy(
+                buffers::mutable_buffer(d + i, chunk),
+                buffers::const_buffer(s + i, chunk));
+    ns = std::chrono::duration_cast<
+        std::chrono::nanoseconds>(
+            clock_type::now() - t0).count();
+    misses = tlb.stop();
+    auto const bytes = double(n / chunk * chunk) * passes;
+    std::printf(
+        "  %-16s sequential 1MB copies:  %6.0f MB/s",
+        name, ns > 0 ? bytes * 1000 / ns : 0.0);
+    if(tlb.available())
+        std::printf(", %5.2f dTLB misses/MB",
+            double(misses) / (bytes / chunk));
+    std::printf("\n");
+    if(total == 0)
+        std::printf("\n");
+}
+
+} // (anon)
+
+int
+main(int argc, char** argv)
+{
+    std::size_t mb = 512;
+    if(argc > 1)
+        mb = static_cast<std::size_t>(
+            std::strtoul(argv[1], nullptr, 10));
+    auto const n = mb * 1024 * 1024;
+
+    tlb_counter tlb;
+    std::printf("two %zuMB buffers, huge page size %zuKB%s\n",
+        mb, buffers::huge_page_arena::
+            default_huge_page_size() / 1024,
+        tlb.available() ? "" :
+            " (dTLB counters unavailable)");
+
+    {
+        buffers::dynamic_flat_buffer src(n);
+        buffers::dynamic_flat_buffer dst(n);
+        fill(src, n, 'a');
+        fill(dst, n, 'b');
+        dst.consume(n);
+        run("std::allocator", src, dst, tlb);
+    }
+
+    {
+        using buffer_type =
+            buffers::basic_dynamic_flat_buffer<
+                buffers::huge_page_allocator<
+                    unsigned char>>;
+        buffers::huge_page_arena arena;
+        buffers::huge_page_allocator<
+            unsigned char> alloc(arena);
+        buffer_type src(n, 2, alloc);
+        buffer_type dst(n, 2, alloc);
+        fill(src, n, 'a');
+        fill(dst, n, 'b');
+        dst.consume(n);
+        run("huge_page_arena", src, dst, tlb);
+
+        auto const st = arena.stats();
+        std::printf(
+            "  arena: %llu hugetlb, %llu transparent,"
+            " %llu normal, %llu small, %zuMB mapped\n",
+            static_cast<unsigned long long>(
+                st.hugetlb_allocations),
+            static_cast<unsigned long long>(
+                st.transparent_allocations),
+            static_cast<unsigned long long>(
+                st.normal_allocations),
+            static_cast<unsigned long long>(
+                st.small_allocations),
+            st.bytes_mapped / (1024 * 1024));
+    }
+}
@@ -0,0 +1,266 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+// Wakeup latency of a single-producer,
+// single-consumer ring under different
+// blocking strategies, in an idle regime
+// (one message per millisecond) and a
+// saturated regime (back to back).
+
+#include <boost/buffers/ring_waiter.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace buffers = boost::buffers;
+using clock_type = std::chrono::steady_clock;
+
+namespace {
+
+std::uint64_t
+now_ns()
+{
+    return std::chrono::duration_cast<
+        std::chrono::nanoseconds>(
+            clock_type::now().time_since_epoch()).count();
+}
+
+// CPU time consumed by the calling thread
+double
+thread_cpu_ms()
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+#else
+    return 0;
+#endif
+}
+
+// log2 latency histogram
+class histogram
+{
+    std::uint64_t n_[64] = {};
+    std::uint64_t count_ = 0;
+    std::uint64_t max_ = 0;
+
+public:
+    void
+    insert(std::uint64_t ns) noexcept
+    {
+        unsigned i = 0;
+        while((ns >> i) > 1 && i < 63)
+            ++i;
+        ++n_[i];
+        ++count_;
+        if(max_ < ns)
+            max_ = ns;
+    }
+
+    // upper bound of the bucket holding p
+    std::uint64_t
+    percentile(double p) const noexcept
+    {
+        auto const target = static_cast<
+            std::uint64_t>(p * count_);
+        std::uint64_t sum = 0;
+        for(unsigned i = 0; i < 64; ++i)
+        {
+            sum += n_[i];
+            if(sum > target)
+                return std::uint64_t(2) << i;
+        }
+        return max_;
+    }
+
+    void
+    print() const
+    {
+        std::printf(
+            "  p50 <%8llu  p99 <%8llu  p99.9 <%8llu"
+            "  max %9llu ns\n",
+            (unsigned long long)percentile(0.5),
+            (unsigned long long)percentile(0.99),
+            (unsigned long long)percentile(0.999),
+            (unsigned long long)max_);
+        for(unsigned i = 0; i < 64; ++i)
+        {
+            if(n_[i] == 0)
+                continue;
+            std::printf("    [%9llu, %9llu) %9llu\n",
+                (unsigned long long)(std::uint64_t(1) << i),
+                (unsigned long long)(std::uint64_t(2) << i),
+                (unsigned long long)n_[i]);
+        }
+    }
+};
+
+//------------------------------------------------
+
+struct spin_strategy
+{
+    static char const* name() { return "busy poll"; }
+
+    template<class Pred>
+    void wait(Pred pred)
+    {
+        while(! pred())
+        {
+        }
+    }
+
+    void notify() {}
+};
+
+struct waiter_strategy
+{
+    buffers::ring_waiter w;
+    buffers::wait_options opt;
+
+    static char const* name() { return "ring_waiter"; }
+
+    template<class Pred>
+    void wait(Pred pred)
+    {
+        w.wait(pred, opt);
+    }
+
+    void notify()
+    {
+        w.notify();
+    }
+};
+
+struct park_strategy : waiter_strategy
+{
+    static char const* name() { return "ring_waiter (park only)"; }
+
+    park_strategy()
+    {
+        opt.spin_time = std::chrono::nanoseconds(0);
+        opt.yield_count = 0;
+    }
+};
+
+struct condvar_strategy
+{
+    std::mutex m;
+    std::condition_variable cv;
+
+    static char const* name() { return "condition_variable"; }
+
+    template<class Pred>
+    void wait(Pred pred)
+    {
+        if(pred())
+            return;
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, pred);
+    }
+
+    void notify()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+        }
+        cv.notify_one();
+    }
+};
+
+//------------------------------------------------
+
+template<class Strategy>
+void
+run(
+    char const* regime,
+    std::size_t count,
+    std::chrono::microseconds gap)
+{
+    std::size_t const cap = 1024;
+    std::vector<std::uint64_t> slots(cap);
+    std::atomic<std::size_t> head{0};
+    std::atomic<std::size_t> tail{0};
+    Strategy empty;
+    Strategy full;
+    histogram h;
+    double cpu = 0;
+
+    std::thread consumer([&]
+        {
+            auto const cpu0 = thread_cpu_ms();
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                empty.wait([&]
+                    {
+                        return head.load(
+                            std::memory_order_acquire) != i;
+                    });
+                h.insert(now_ns() - slots[i % cap]);
+                tail.store(i + 1,
+                    std::memory_order_release);
+                full.notify();
+            }
+            cpu = thread_cpu_ms() - cpu0;
+        });
+
+    auto const t0 = clock_type::now();
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        if(gap.count() > 0)
+            std::this_thread::sleep_for(gap);
+        full.wait([&]
+            {
+                return i - tail.load(
+                    std::memory_order_acquire) < cap;
+            });
+        slots[i % cap] = now_ns();
+        head.store(i + 1,
+            std::memory_order_release);
+        empty.notify();
+    }
+    consumer.join();
+    auto const ms = std::chrono::duration_cast<
+        std::chrono::milliseconds>(
+            clock_type::now() - t0).count();
+
+    std::printf(
+        "%s, %s: %zu messages in %lld ms,"
+        " consumer cpu %.1f ms\n",
+        regime, Strategy::name(), count,
+        (long long)ms, cpu);
+    h.print();
+}
+
+template<class Strategy>
+void
+run_all()
+{
+    run<Strategy>("idle", 2000,
+        std::chrono::microseconds(1000));
+    run<Strategy>("saturated", 2000000,
+        std::chrono::microseconds(0));
+}
+
+} // (anon)
+
+int
+main()
+{
+    run_all<waiter_strategy>();
+    run_all<park_strategy>();
+    run_all<condvar_strategy>();
+    run_all<spin_strategy>();
+}
@@ -11,22 +11,46 @@
 #define BOOST_BUFFERS_HPP
 
 #include <boost/buffers/algorithm.hpp>
+#include <boost/buffers/aligned_allocator.hpp>
+#include <boost/buffers/async_writer.hpp>
+#include <boost/buffers/bip_buffer.hpp>
+#include <boost/buffers/block_pool.hpp>
 #include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/buffer_rope.hpp>
 #include <boost/buffers/buffer_size.hpp>
 #include <boost/buffers/circular_buffer.hpp>
 #include <boost/buffers/const_buffer.hpp>
 #include <boost/buffers/const_buffer_pair.hpp>
 #include <boost/buffers/const_buffer_span.hpp>
 #include <boost/buffers/const_buffer_subspan.hpp>
+#include <boost/buffers/direct_writer.hpp>
+#include <boost/buffers/dynamic_circular_buffer.hpp>
+#include <boost/buffers/dynamic_flat_buffer.hpp>
 #include <boost/buffers/flat_buffer.hpp>
+#include <boost/buffers/huge_page_arena.hpp>
+#include <boost/buffers/iovec.hpp>
 #include <boost/buffers/make_buffer.hpp>
+#include <boost/buffers/mapped_file.hpp>
+#include <boost/buffers/monotonic_arena.hpp>
+#include <boost/buffers/multi_buffer.hpp>
 #include <boost/buffers/mutable_buffer.hpp>
 #include <boost/buffers/mutable_buffer_pair.hpp>
 #include <boost/buffers/mutable_buffer_span.hpp>
 #include <boost/buffers/mutable_buffer_subspan.hpp>
+#include <boost/buffers/persistent_ring.hpp>
+#include <boost/buffers/pinned_pool.hpp>
 #include <boost/buffers/range.hpp>
+#include <boost/buffers/record_ring.hpp>
+#include <boost/buffers/ring_waiter.hpp>
+#include <boost/buffers/shared_buffer.hpp>
+#include <boost/buffers/shared_ring.hpp>
+#include <boost/buffers/spill_buffer.hpp>
+#include <boost/buffers/splice.hpp>
+#include <boost/buffers/static_buffer.hpp>
+#include <boost/buffers/static_circular_buffer.hpp>
 #include <boost/buffers/string_buffer.hpp>
 #include <boost/buffers/tag_invoke.hpp>
 #include <boost/buffers/type_traits.hpp>
+#include <boost/buffers/vector_buffer.hpp>
 
 #endif
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_ALIGNED_ALLOCATOR_HPP
+#define BOOST_BUFFERS_ALIGNED_ALLOCATOR_HPP
+
+#include <boost/buffers/detail/config.hpp>
+#include <boost/throw_exception.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace boost {
+namespace buffers {
+
+/** An allocator which returns memory with a given alignment.
+
+    Every allocation starts at a multiple of
+    `Alignment`. With an alignment of the page
+    size or of the logical block size of a device,
+    an owning buffer such as
+    `basic_dynamic_flat_buffer<aligned_allocator<unsigned char, 4096>>`
+    holds storage which may be used for I/O with
+    `O_DIRECT`, whose address must be aligned.
+    The readable bytes of that buffer start at
+    the beginning of its storage whenever it has
+    just grown or reclaimed consumed space.
+
+    @tparam T The type of object allocated.
+
+    @tparam Alignment The alignment, which must be
+    a power of two no smaller than that of `T`.
+
+    @see direct_writer
+*/
+template<
+    class T,
+    std::size_t Alignment>
+class aligned_allocator
+{
+    static_assert(
+        Alignment > 0 &&
+        (Alignment & (Alignment - 1)) == 0,
+        "Alignment must be a power of two");
+
+    static_assert(
+        Alignment >= alignof(T),
+        "Alignment is weaker than that of T");
+
+    // the address returned by operator new
+    // is kept just before the aligned memory
+    static constexpr std::size_t extra =
+        Alignment + sizeof(void*);
+
+public:
+    using value_type = T;
+
+    /** The alignment of every allocation.
+    */
+    static constexpr std::size_t
+        alignment = Alignment;
+
+    template<class U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+    /** Constructor.
+    */
+    aligned_allocator() = default;
+
+    /** Constructor.
+    */
+    template<class U>
+    aligned_allocator(
+        aligned_allocator<U, Alignment> const&) noexcept
+    {
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        if(n > (std::size_t(-1) - extra) / sizeof(T))
+            throw_exception(std::bad_alloc());
+        auto const raw = static_cast<unsigned char*>(
+            ::operator new(n * sizeof(T) + extra));
+        auto const a = reinterpret_cast<std::uintptr_t>(
+            raw + sizeof(void*));
+        auto const p = raw + sizeof(void*) + static_cast<
+            std::size_t>((Alignment - a % Alignment) % Alignment);
+        std::memcpy(p - sizeof(void*),
+            &raw, sizeof(void*));
+        return reinterpret_cast<T*>(p);
+    }
+
+    void
+    deallocate(T* p, std::size_t) noexcept
+    {
+        void* raw;
+        std::memcpy(&raw, reinterpret_cast<
+            unsigned char*>(p) - sizeof(void*),
+                sizeof(void*));
+        ::operator delete(raw);
+    }
+
+    template<class U>
+    bool
+    operator==(
+        aligned_allocator<U, Alignment> const&) const noexcept
+    {
+        return true;
+    }
+
+    template<class U>
+    bool
+    operator!=(
+        aligned_allocator<U, Alignment> const&) const noexcept
+    {
+        return false;
+    }
+};
+
+template<class T, std::size_t Alignment>
+constexpr std::size_t
+aligned_allocator<T, Alignment>::alignment;
+
+} // buffers
+} // boost
+
+#endif
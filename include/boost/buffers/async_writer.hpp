@@ -0,0 +1,254 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_ASYNC_WRITER_HPP
+#define BOOST_BUFFERS_ASYNC_WRITER_HPP
+
+#include <boost/buffers/detail/config.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/flat_buffer.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace boost {
+namespace buffers {
+
+/** A file writer which flushes from a background thread.
+
+    The writer owns two or more @ref flat_buffer
+    objects of equal capacity. The producer appends
+    to the active one through @ref prepare and
+    @ref commit, which touch nothing shared with
+    the background thread. When @ref prepare needs
+    more space than the active buffer has free, the
+    active buffer is handed to the background
+    thread and a free one takes its place. The
+    background thread writes every buffer handed
+    to it with a single `pwritev`, then returns
+    them to the free list.
+
+    When every buffer is waiting to be written,
+    @ref prepare blocks until one is returned, so
+    a producer which outruns the disk is held back
+    rather than buffering without bound. The time
+    spent waiting, and the latency of each write,
+    are reported by @ref stats.
+
+    Bytes are written in the order committed, from
+    the start of the file.
+
+    @par Exception Safety
+    An error from a write in the background is
+    reported by throwing `system_error` from the
+    next call to @ref flush or @ref close, or to
+    @ref prepare which hands off a buffer. Bytes
+    committed after the error are discarded.
+
+    @par Thread Safety
+    Distinct objects: Safe.@n
+    Shared objects: Unsafe.
+*/
+class async_writer
+{
+public:
+    using mutable_buffers_type = mutable_buffer;
+
+    /** Options for constructing a writer.
+    */
+    struct options
+    {
+        /** The capacity of each buffer.
+        */
+        std::size_t buffer_size = 1024 * 1024;
+
+        /** The number of buffers, at least two.
+        */
+        std::size_t buffers = 2;
+    };
+
+    /** Counters describing a writer.
+    */
+    struct stats_type
+    {
+        /** Buffers handed to the background thread.
+        */
+        std::uint64_t swaps = 0;
+
+        /** Swaps which waited for a free buffer.
+        */
+        std::uint64_t swap_waits = 0;
+
+        /** Nanoseconds spent waiting for a free buffer.
+        */
+        std::uint64_t swap_wait_ns = 0;
+
+        /** Calls to `pwritev` which completed.
+        */
+        std::uint64_t flushes = 0;
+
+        /** Nanoseconds spent in `pwritev`, in total.
+        */
+        std::uint64_t flush_ns = 0;
+
+        /** Nanoseconds spent in the slowest `pwritev`.
+        */
+        std::uint64_t max_flush_ns = 0;
+
+        /** Bytes written to the file.
+        */
+        std::uint64_t bytes_written = 0;
+    };
+
+    /** Destructor.
+
+        If the file is open, it is closed as if
+        by @ref close, ignoring any error.
+    */
+    BOOST_BUFFERS_DECL
+    ~async_writer();
+
+    /** Constructor.
+
+        The file is created if it does not
+        exist, and truncated if it does.
+
+        @throws system_error if the file
+        cannot be opened.
+    */
+    BOOST_BUFFERS_DECL
+    explicit
+    async_writer(char const* path);
+
+    /** Constructor.
+
+        The file is created if it does not
+        exist, and truncated if it does.
+
+        @throws std::invalid_argument if there
+        are fewer than two buffers, or their
+        capacity is zero.
+
+        @throws system_error if the file
+        cannot be opened.
+    */
+    BOOST_BUFFERS_DECL
+    async_writer(
+        char const* path,
+        options const& opt);
+
+    /** Constructor.
+    */
+    async_writer(async_writer const&) = delete;
+
+    /** Assignment.
+    */
+    async_writer& operator=(async_writer const&) = delete;
+
+    /** Return the capacity of each buffer.
+    */
+    std::size_t
+    buffer_size() const noexcept
+    {
+        return size_;
+    }
+
+    /** Return the number of bytes committed.
+    */
+    std::uint64_t
+    size() const noexcept
+    {
+        return committed_ + active_->size();
+    }
+
+    /** Return writable space.
+
+        If the active buffer lacks the space, it
+        is handed to the background thread first,
+        waiting for a free buffer if necessary.
+
+        @throws std::length_error
+        `n > buffer_size()`
+
+        @throws system_error if a buffer is
+        handed off after a write in the
+        background failed.
+    */
+    BOOST_BUFFERS_DECL
+    mutable_buffers_type
+    prepare(std::size_t n);
+
+    /** Append bytes from the prepared space.
+    */
+    void
+    commit(std::size_t n) noexcept
+    {
+        active_->commit(n);
+    }
+
+    /** Wait until every committed byte is written.
+
+        @throws system_error if a write
+        in the background failed.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    flush();
+
+    /** Flush, stop the background thread and close the file.
+
+        @throws system_error if a write
+        in the background failed. The file
+        is closed regardless.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    close();
+
+    /** Return a snapshot of the counters.
+    */
+    BOOST_BUFFERS_DECL
+    stats_type
+    stats() const;
+
+private:
+    void swap();
+    void stop() noexcept;
+    void run() noexcept;
+
+    int fd_ = -1;
+    std::size_t size_;
+    std::unique_ptr<unsigned char[]> mem_;
+    std::vector<flat_buffer> bufs_;
+    flat_buffer* active_ = nullptr;
+    std::uint64_t committed_ = 0;
+
+    mutable std::mutex m_;
+    std::condition_variable cv_;
+    std::vector<flat_buffer*> free_;
+    std::vector<flat_buffer*> full_;
+    std::size_t writing_ = 0;
+    int error_ = 0;
+    bool stop_ = false;
+    stats_type st_;
+    std::thread t_;
+};
+
+} // buffers
+} // boost
+
+#endif
+
+#endif
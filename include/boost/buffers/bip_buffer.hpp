@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_BIP_BUFFER_HPP
+#define BOOST_BUFFERS_BIP_BUFFER_HPP
+
+#include <boost/buffers/detail/config.hpp>
+#include <boost/buffers/const_buffer_pair.hpp>
+#include <boost/buffers/mutable_buffer.hpp>
+#include <boost/buffers/detail/except.hpp>
+
+namespace boost {
+namespace buffers {
+
+/** A bipartite circular buffer.
+
+    This implements a fixed-size circular
+    buffer in which every output sequence is
+    a single contiguous region, so it may be
+    passed directly to `recv` without a
+    scatter list and without mapping the
+    storage twice.
+
+    The input sequence is held in up to two
+    regions: region A, and region B which
+    starts at the beginning of the storage.
+    When a call to @ref prepare does not fit
+    after region A but fits before it, the
+    output sequence is placed in region B
+    and the bytes between the end of region A
+    and the end of the storage are skipped.
+    That amount is reported by @ref waste
+    until region A is consumed.
+
+    Buffer sequences returned from @ref data
+    always have length two.
+*/
+class bip_buffer
+{
+    unsigned char* base_ = nullptr;
+    std::size_t cap_ = 0;
+    std::size_t a_pos_ = 0;
+    std::size_t a_len_ = 0;
+    std::size_t b_len_ = 0;
+    std::size_t waste_ = 0;
+    std::size_t out_size_ = 0;
+    bool wrapped_ = false;
+    bool out_wrapped_ = false;
+
+public:
+    using const_buffers_type =
+        const_buffer_pair;
+
+    using mutable_buffers_type =
+        mutable_buffer;
+
+    /** Constructor.
+    */
+    bip_buffer() = default;
+
+    /** Constructor.
+    */
+    bip_buffer(
+        bip_buffer const&) = default;
+
+    /** Constructor.
+    */
+    bip_buffer(
+        void* base,
+        std::size_t capacity,
+        std::size_t initial_size = 0)
+        : base_(static_cast<
+            unsigned char*>(base))
+        , cap_(capacity)
+        , a_len_(initial_size)
+    {
+        // initial size too large
+        if(a_len_ > cap_)
+            detail::throw_invalid_argument();
+    }
+
+    /** Constructor.
+    */
+    explicit
+    bip_buffer(
+        mutable_buffer const& b,
+        std::size_t initial_size = 0)
+        : bip_buffer(
+            b.data(),
+            b.size(),
+            initial_size)
+    {
+    }
+
+    /** Assignment.
+    */
+    bip_buffer& operator=(
+        bip_buffer const&) = default;
+
+    std::size_t
+    size() const noexcept
+    {
+        return a_len_ + b_len_;
+    }
+
+    std::size_t
+    max_size() const noexcept
+    {
+        return cap_;
+    }
+
+    /** Return the largest size accepted by @ref prepare.
+    */
+    std::size_t
+    capacity() const noexcept
+    {
+        if(wrapped_)
+            return a_pos_ - b_len_;
+        auto const tail =
+            cap_ - a_pos_ - a_len_;
+        if(tail >= a_pos_)
+            return tail;
+        return a_pos_;
+    }
+
+    /** Return the number of unusable bytes at the end.
+
+        This is the space between the end of
+        region A and the end of the storage,
+        which is skipped while region B is in
+        use. It becomes available again once
+        region A is fully consumed.
+    */
+    std::size_t
+    waste() const noexcept
+    {
+        return waste_;
+    }
+
+    BOOST_BUFFERS_DECL
+    const_buffers_type
+    data() const noexcept;
+
+    BOOST_BUFFERS_DECL
+    mutable_buffers_type
+    prepare(std::size_t n);
+
+    BOOST_BUFFERS_DECL
+    void
+    commit(std::size_t n) noexcept;
+
+    BOOST_BUFFERS_DECL
+    void
+    consume(std::size_t n) noexcept;
+};
+
+} // buffers
+} // boost
+
+#endif
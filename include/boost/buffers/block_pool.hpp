@@ -0,0 +1,435 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_BLOCK_POOL_HPP
+#define BOOST_BUFFERS_BLOCK_POOL_HPP
+
+#include <boost/buffers/detail/config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+#include <memory_resource>
+#endif
+
+namespace boost {
+namespace buffers {
+
+namespace detail {
+struct pool_block;
+struct pool_cache;
+struct pool_thread;
+} // detail
+
+/** A pool of memory blocks with per-thread caches.
+
+    Requests are rounded up to one of a set of
+    size classes. Each thread which allocates
+    from the pool gets its own cache, holding a
+    magazine of free blocks for every size class,
+    which it uses without locking or atomic
+    read-modify-write operations.
+
+    A block freed by the thread which allocated
+    it goes back to that thread's magazine. A
+    block freed by any other thread is pushed
+    onto a lock-free list belonging to the
+    allocating thread's cache, which collects
+    the whole list at once the next time one of
+    its magazines runs dry.
+
+    When a magazine grows past the high
+    watermark, it is cut down to the low
+    watermark by moving blocks to a shared depot.
+    An empty magazine is refilled from the depot
+    before blocks are requested from the global
+    heap. When a thread exits, its cache is
+    emptied into the depot and given to the next
+    thread which uses the pool.
+
+    Requests larger than the largest size class
+    bypass the caches.
+
+    The counters returned by @ref stats tell the
+    storage bound to its users apart from the
+    storage held idle by the pool. Dynamic
+    buffers which release their storage when
+    drained, such as @ref basic_dynamic_flat_buffer
+    or @ref basic_dynamic_circular_buffer
+    with an idle capacity of zero, let many
+    mostly idle connections share one pool.
+
+    @par Thread Safety
+    Distinct objects: Safe.@n
+    Shared objects: Safe.
+
+    @see block_pool_allocator
+*/
+class block_pool
+{
+public:
+    /** Options for constructing a pool.
+    */
+    struct options
+    {
+        /** The block sizes, in increasing order.
+        */
+        std::vector<std::size_t> size_classes =
+            { 256, 1024, 4096, 16384, 65536 };
+
+        /** The most free blocks a magazine holds.
+        */
+        std::size_t high_watermark = 64;
+
+        /** The free blocks a magazine keeps when trimmed.
+
+            This is also the number of blocks taken
+            from the depot to refill a magazine.
+        */
+        std::size_t low_watermark = 16;
+    };
+
+    /** Counters describing the use of a pool.
+    */
+    struct stats_type
+    {
+        /** The number of calls to allocate.
+        */
+        std::uint64_t allocations = 0;
+
+        /** Allocations served by a thread's magazine.
+        */
+        std::uint64_t cache_hits = 0;
+
+        /** Allocations served from the depot.
+        */
+        std::uint64_t depot_hits = 0;
+
+        /** Allocations served by the global heap.
+        */
+        std::uint64_t heap_allocations = 0;
+
+        /** Blocks freed by a thread other than the allocator.
+        */
+        std::uint64_t remote_frees = 0;
+
+        /** Blocks allocated and not yet deallocated.
+        */
+        std::size_t blocks_in_use = 0;
+
+        /** Bytes held in blocks allocated and not yet deallocated.
+        */
+        std::size_t bytes_in_use = 0;
+
+        /** Bytes held in free blocks.
+        */
+        std::size_t bytes_retained = 0;
+
+        /** Return the fraction of allocations served by a magazine.
+        */
+        double
+        hit_rate() const noexcept
+        {
+            if(allocations == 0)
+                return 0;
+            return static_cast<double>(cache_hits) /
+                static_cast<double>(allocations);
+        }
+    };
+
+    /** Destructor.
+
+        All blocks are returned to the global
+        heap.
+
+        @par Preconditions
+        Every block allocated from the pool
+        has been deallocated.
+    */
+    BOOST_BUFFERS_DECL
+    ~block_pool();
+
+    /** Constructor.
+    */
+    BOOST_BUFFERS_DECL
+    block_pool();
+
+    /** Constructor.
+
+        @throws std::invalid_argument if the
+        size classes are empty or not increasing,
+        or the low watermark exceeds the high one.
+    */
+    BOOST_BUFFERS_DECL
+    explicit
+    block_pool(options const& opt);
+
+    /** Constructor.
+    */
+    block_pool(block_pool const&) = delete;
+
+    /** Assignment.
+    */
+    block_pool& operator=(block_pool const&) = delete;
+
+    /** Allocate a block of at least `n` bytes.
+
+        The returned pointer is suitably aligned
+        for any fundamental type.
+
+        @throws std::bad_alloc on failure.
+    */
+    BOOST_BUFFERS_DECL
+    void*
+    allocate(std::size_t n);
+
+    /** Deallocate a block.
+
+        This may be called from any thread.
+
+        @param p A pointer returned by
+        @ref allocate on this pool.
+
+        @param n The size passed to @ref allocate.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    deallocate(
+        void* p,
+        std::size_t n) noexcept;
+
+    /** Return the size of block used for a request of `n` bytes.
+    */
+    BOOST_BUFFERS_DECL
+    std::size_t
+    block_size(std::size_t n) const noexcept;
+
+    /** Return the counters.
+
+        The values are gathered from every
+        cache without stopping other threads,
+        so they are approximate while the pool
+        is in use.
+    */
+    BOOST_BUFFERS_DECL
+    stats_type
+    stats() const;
+
+    /** Return the blocks in the depot to the global heap.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    trim() noexcept;
+
+private:
+    friend struct detail::pool_thread;
+
+    using header = detail::pool_block;
+    using cache = detail::pool_cache;
+
+    cache&
+    local();
+
+    cache*
+    find_local() const noexcept;
+
+    void
+    retire(cache& c) noexcept;
+
+    void
+    drain_remote(cache& c) noexcept;
+
+    void
+    spill(
+        cache& c,
+        std::size_t cls) noexcept;
+
+    void
+    to_depot(
+        std::size_t cls,
+        header* head,
+        std::size_t n) noexcept;
+
+    std::size_t
+    from_depot(
+        std::size_t cls,
+        header*& head) noexcept;
+
+    std::uint64_t const id_;
+    std::vector<std::size_t> const classes_;
+    std::size_t const high_;
+    std::size_t const low_;
+
+    mutable std::mutex m_;
+    std::vector<cache*> caches_;
+    std::vector<cache*> orphans_;
+    std::vector<header*> depot_;
+    std::vector<std::size_t> depot_count_;
+};
+
+//------------------------------------------------
+
+/** An allocator which obtains memory from a block_pool.
+
+    This allows the dynamic buffers in this
+    library to draw their storage from a
+    @ref block_pool, for example
+    `basic_multi_buffer<block_pool_allocator<unsigned char>>`.
+*/
+template<class T>
+class block_pool_allocator
+{
+    block_pool* pool_;
+
+    template<class U>
+    friend class block_pool_allocator;
+
+public:
+    using value_type = T;
+
+    /** Constructor.
+    */
+    explicit
+    block_pool_allocator(
+        block_pool& pool) noexcept
+        : pool_(&pool)
+    {
+    }
+
+    /** Constructor.
+    */
+    template<class U>
+    block_pool_allocator(
+        block_pool_allocator<U> const& other) noexcept
+        : pool_(other.pool_)
+    {
+    }
+
+    /** Return the pool.
+    */
+    block_pool&
+    pool() const noexcept
+    {
+        return *pool_;
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        return static_cast<T*>(
+            pool_->allocate(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        pool_->deallocate(p, n * sizeof(T));
+    }
+
+    template<class U>
+    bool
+    operator==(
+        block_pool_allocator<U> const& other) const noexcept
+    {
+        return pool_ == other.pool_;
+    }
+
+    template<class U>
+    bool
+    operator!=(
+        block_pool_allocator<U> const& other) const noexcept
+    {
+        return pool_ != other.pool_;
+    }
+};
+
+//------------------------------------------------
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+
+/** A polymorphic memory resource over a block_pool.
+
+    This allows the `pmr` buffers and containers
+    to draw their storage from a @ref block_pool.
+    Requests for an alignment stricter than that
+    of any fundamental type are passed to
+    `std::pmr::new_delete_resource()`.
+
+    This type is only available when the standard
+    library provides `<memory_resource>`.
+*/
+class block_pool_resource
+    : public std::pmr::memory_resource
+{
+    block_pool* pool_;
+
+public:
+    /** Constructor.
+    */
+    explicit
+    block_pool_resource(
+        block_pool& pool) noexcept
+        : pool_(&pool)
+    {
+    }
+
+    /** Return the pool.
+    */
+    block_pool&
+    pool() const noexcept
+    {
+        return *pool_;
+    }
+
+private:
+    void*
+    do_allocate(
+        std::size_t n,
+        std::size_t align) override
+    {
+        if(align > alignof(std::max_align_t))
+            return std::pmr::new_delete_resource()->
+                allocate(n, align);
+        return pool_->allocate(n);
+    }
+
+    void
+    do_deallocate(
+        void* p,
+        std::size_t n,
+        std::size_t align) override
+    {
+        if(align > alignof(std::max_align_t))
+        {
+            std::pmr::new_delete_resource()->
+                deallocate(p, n, align);
+            return;
+        }
+        pool_->deallocate(p, n);
+    }
+
+    bool
+    do_is_equal(
+        std::pmr::memory_resource const&
+            other) const noexcept override
+    {
+        auto const p = dynamic_cast<
+            block_pool_resource const*>(&other);
+        return p && p->pool_ == pool_;
+    }
+};
+
+#endif
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,915 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_BUFFER_ROPE_HPP
+#define BOOST_BUFFERS_BUFFER_ROPE_HPP
+
+#include <boost/buffers/detail/config.hpp>
+#include <boost/buffers/shared_buffer.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <boost/assert.hpp>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+#include <memory_resource>
+#endif
+
+namespace boost {
+namespace buffers {
+
+/** A sequence of shared buffers supporting edits at byte offsets.
+
+    The bytes are held as a sequence of pieces,
+    each referring to a range of a
+    @ref basic_shared_block, arranged in a balanced
+    tree ordered by position. Inserting, erasing,
+    or replacing a range of bytes cuts at most two
+    pieces and relinks the tree, in logarithmic time
+    in the number of pieces on average. Bytes outside
+    the edited range are never copied.
+
+    Objects of this type meet the requirements of
+    <em>ConstBufferSequence</em>; iteration visits
+    each piece in order as a @ref const_buffer.
+
+    Iterators are invalidated by any modification.
+
+    @tparam ThreadSafe Selects the reference count
+    of the shared blocks, as for @ref basic_shared_block.
+
+    @tparam Allocator The allocator used for the
+    nodes of the tree, and for the blocks made
+    when bytes are copied in.
+*/
+template<
+    bool ThreadSafe = true,
+    class Allocator = std::allocator<unsigned char>>
+class basic_buffer_rope
+{
+public:
+    /** The type of block holding the bytes.
+    */
+    using block_type =
+        basic_shared_block<ThreadSafe>;
+
+    /** The type of a single piece.
+    */
+    using buffer_type =
+        basic_shared_buffer<ThreadSafe>;
+
+    /** The type of a sequence of pieces.
+    */
+    using buffers_type =
+        basic_shared_buffers<ThreadSafe, Allocator>;
+
+    using allocator_type = Allocator;
+
+private:
+    struct node
+    {
+        block_type block;
+        const_buffer b;
+        node* left = nullptr;
+        node* right = nullptr;
+        node* parent = nullptr;
+        std::size_t bytes = 0; // in this subtree
+        std::uint32_t prio = 0;
+    };
+
+    using alloc_type = typename
+        std::allocator_traits<Allocator>::
+            template rebind_alloc<node>;
+
+    using alloc_traits =
+        std::allocator_traits<alloc_type>;
+
+    // unused nodes kept for reuse
+    static constexpr std::size_t max_free = 16;
+
+    alloc_type alloc_;
+    node* root_ = nullptr;
+    node* free_ = nullptr;
+    std::size_t nfree_ = 0;
+    std::size_t pieces_ = 0;
+    std::uint32_t seed_ = 2463534242u;
+
+public:
+    /** The type of buffer.
+    */
+    using value_type = const_buffer;
+
+    /** A bidirectional iterator over the pieces.
+    */
+    class const_iterator
+    {
+        node const* n_ = nullptr;
+        basic_buffer_rope const* r_ = nullptr;
+
+        friend class basic_buffer_rope;
+
+        const_iterator(
+            node const* n,
+            basic_buffer_rope const* r) noexcept
+            : n_(n)
+            , r_(r)
+        {
+        }
+
+    public:
+        using value_type = const_buffer;
+        using reference = const_buffer const&;
+        using pointer = const_buffer const*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category =
+            std::bidirectional_iterator_tag;
+
+        const_iterator() = default;
+
+        bool
+        operator==(
+            const_iterator const& other) const noexcept
+        {
+            return n_ == other.n_ && r_ == other.r_;
+        }
+
+        bool
+        operator!=(
+            const_iterator const& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+        reference
+        operator*() const noexcept
+        {
+            return n_->b;
+        }
+
+        pointer
+        operator->() const noexcept
+        {
+            return &n_->b;
+        }
+
+        const_iterator&
+        operator++() noexcept
+        {
+            if(n_->right)
+            {
+                n_ = leftmost(n_->right);
+                return *this;
+            }
+            auto p = n_->parent;
+            while(p && n_ == p->right)
+            {
+                n_ = p;
+                p = p->parent;
+            }
+            n_ = p;
+            return *this;
+        }
+
+        const_iterator
+        operator++(int) noexcept
+        {
+            auto temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        const_iterator&
+        operator--() noexcept
+        {
+            if(! n_)
+            {
+                n_ = rightmost(r_->root_);
+                return *this;
+            }
+            if(n_->left)
+            {
+                n_ = rightmost(n_->left);
+                return *this;
+            }
+            auto p = n_->parent;
+            while(p && n_ == p->left)
+            {
+                n_ = p;
+                p = p->parent;
+            }
+            n_ = p;
+            return *this;
+        }
+
+        const_iterator
+        operator--(int) noexcept
+        {
+            auto temp = *this;
+            --(*this);
+            return temp;
+        }
+    };
+
+    /** Destructor.
+    */
+    ~basic_buffer_rope()
+    {
+        destroy(root_);
+        free_nodes();
+    }
+
+    /** Constructor.
+    */
+    basic_buffer_rope() = default;
+
+    /** Constructor.
+
+        @param alloc The allocator to use.
+    */
+    explicit
+    basic_buffer_rope(
+        Allocator const& alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    /** Constructor.
+
+        The pieces are shared with `other`;
+        no bytes are copied.
+    */
+    basic_buffer_rope(
+        basic_buffer_rope const& other)
+        : basic_buffer_rope(Allocator(alloc_traits::
+            select_on_container_copy_construction(
+                other.alloc_)))
+    {
+        reserve_nodes(other.pieces_);
+        root_ = clone(other.root_);
+    }
+
+    /** Constructor.
+
+        The pieces are shared with `other`;
+        no bytes are copied.
+
+        @param other The rope to copy.
+
+        @param alloc The allocator to use.
+    */
+    basic_buffer_rope(
+        basic_buffer_rope const& other,
+        Allocator const& alloc)
+        : basic_buffer_rope(alloc)
+    {
+        reserve_nodes(other.pieces_);
+        root_ = clone(other.root_);
+    }
+
+    /** Constructor.
+    */
+    basic_buffer_rope(
+        basic_buffer_rope&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , root_(other.root_)
+        , pieces_(other.pieces_)
+    {
+        other.root_ = nullptr;
+        other.pieces_ = 0;
+    }
+
+    /** Assignment.
+    */
+    basic_buffer_rope&
+    operator=(
+        basic_buffer_rope const& other)
+    {
+        if(this == &other)
+            return *this;
+        using propagate = typename alloc_traits::
+            propagate_on_container_copy_assignment;
+        basic_buffer_rope temp(other,
+            propagate::value ? other.alloc_ : alloc_);
+        swap_all(temp, propagate{});
+        return *this;
+    }
+
+    /** Assignment.
+
+        If the allocators differ and do not
+        propagate, the pieces are copied, which
+        shares them without copying any bytes.
+    */
+    basic_buffer_rope&
+    operator=(
+        basic_buffer_rope&& other) noexcept(
+            alloc_traits::
+                propagate_on_container_move_assignment::value)
+    {
+        using propagate = typename alloc_traits::
+            propagate_on_container_move_assignment;
+        if(! propagate::value &&
+            alloc_ != other.alloc_)
+        {
+            basic_buffer_rope temp(other, alloc_);
+            swap_all(temp, std::false_type{});
+            return *this;
+        }
+        swap_all(other, propagate{});
+        return *this;
+    }
+
+    /** Return the allocator.
+    */
+    allocator_type
+    get_allocator() const noexcept
+    {
+        return allocator_type(alloc_);
+    }
+
+    /** Return an iterator to the beginning.
+    */
+    const_iterator
+    begin() const noexcept
+    {
+        return { leftmost(root_), this };
+    }
+
+    /** Return an iterator to the end.
+    */
+    const_iterator
+    end() const noexcept
+    {
+        return { nullptr, this };
+    }
+
+    /** Return the number of bytes.
+    */
+    std::size_t
+    size() const noexcept
+    {
+        return bytes(root_);
+    }
+
+    /** Return true if there are no bytes.
+    */
+    bool
+    empty() const noexcept
+    {
+        return root_ == nullptr;
+    }
+
+    /** Return the number of pieces.
+    */
+    std::size_t
+    pieces() const noexcept
+    {
+        return pieces_;
+    }
+
+    /** Insert a shared buffer at a byte offset.
+
+        The buffer is linked in without copying.
+
+        @throws std::invalid_argument `pos > size()`
+    */
+    void
+    insert(
+        std::size_t pos,
+        buffer_type const& b)
+    {
+        replace(pos, 0, b);
+    }
+
+    /** Insert shared buffers at a byte offset.
+
+        The buffers are linked in without copying.
+
+        @throws std::invalid_argument `pos > size()`
+    */
+    void
+    insert(
+        std::size_t pos,
+        buffers_type const& bs)
+    {
+        replace(pos, 0, bs);
+    }
+
+    /** Insert the pieces of a rope at a byte offset.
+
+        The pieces are shared; no bytes are copied.
+
+        @throws std::invalid_argument `pos > size()`
+    */
+    void
+    insert(
+        std::size_t pos,
+        basic_buffer_rope const& other)
+    {
+        replace(pos, 0, other);
+    }
+
+    /** Insert a copy of a buffer sequence at a byte offset.
+
+        The bytes are copied into a new block.
+
+        @throws std::invalid_argument `pos > size()`
+    */
+    template<
+        class ConstBufferSequence
+        , class = typename std::enable_if<
+            is_const_buffer_sequence<
+                ConstBufferSequence>::value
+        >::type
+    >
+    void
+    insert(
+        std::size_t pos,
+        ConstBufferSequence const& bs)
+    {
+        replace(pos, 0, bs);
+    }
+
+    /** Append to the end.
+    */
+    template<class Buffers>
+    void
+    append(Buffers const& bs)
+    {
+        insert(size(), bs);
+    }
+
+    /** Remove bytes.
+
+        At most `n` bytes starting at `pos`
+        are removed.
+
+        @throws std::invalid_argument `pos > size()`
+    */
+    void
+    erase(
+        std::size_t pos,
+        std::size_t n)
+    {
+        check(pos);
+        reserve_nodes(2);
+        edit(pos, n, nullptr);
+    }
+
+    /** Remove bytes from the beginning.
+    */
+    void
+    consume(std::size_t n) noexcept
+    {
+        root_ = drop_front(root_, n);
+        if(root_)
+            root_->parent = nullptr;
+    }
+
+    /** Replace bytes with a shared buffer.
+
+        At most `n` bytes starting at `pos`
+        are replaced.
+
+        @throws std::invalid_argument `pos > size()`
+    */
+    void
+    replace(
+        std::size_t pos,
+        std::size_t n,
+        buffer_type const& b)
+    {
+        check(pos);
+        reserve_nodes(3);
+        node* t = nullptr;
+        if(b.size() > 0)
+            t = make_node(b.block(), b);
+        edit(pos, n, t);
+    }
+
+    /** Replace bytes with shared buffers.
+
+        At most `n` bytes starting at `pos`
+        are replaced.
+
+        @throws std::invalid_argument `pos > size()`
+    */
+    void
+    replace(
+        std::size_t pos,
+        std::size_t n,
+        buffers_type const& bs)
+    {
+        check(pos);
+        reserve_nodes(bs.length() + 2);
+        node* t = nullptr;
+        for(std::size_t i = 0; i < bs.length(); ++i)
+        {
+            auto const b = bs[i];
+            t = merge(t, make_node(b.block(), b));
+        }
+        edit(pos, n, t);
+    }
+
+    /** Replace bytes with the pieces of a rope.
+
+        At most `n` bytes starting at `pos`
+        are replaced.
+
+        @throws std::invalid_argument `pos > size()`
+    */
+    void
+    replace(
+        std::size_t pos,
+        std::size_t n,
+        basic_buffer_rope const& other)
+    {
+        check(pos);
+        reserve_nodes(other.pieces_ + 2);
+        edit(pos, n, clone(other.root_));
+    }
+
+    /** Replace bytes with a copy of a buffer sequence.
+
+        At most `n` bytes starting at `pos`
+        are replaced.
+
+        @throws std::invalid_argument `pos > size()`
+    */
+    template<
+        class ConstBufferSequence
+        , class = typename std::enable_if<
+            is_const_buffer_sequence<
+                ConstBufferSequence>::value
+        >::type
+    >
+    void
+    replace(
+        std::size_t pos,
+        std::size_t n,
+        ConstBufferSequence const& bs)
+    {
+        check(pos);
+        replace(pos, n,
+            buffer_type(block_type(bs, alloc_)));
+    }
+
+    /** Remove every piece.
+    */
+    void
+    clear() noexcept
+    {
+        destroy(root_);
+        root_ = nullptr;
+    }
+
+    friend
+    basic_buffer_rope
+    tag_invoke(
+        prefix_tag const&,
+        basic_buffer_rope const& r,
+        std::size_t n)
+    {
+        basic_buffer_rope r1(r);
+        if(n < r1.size())
+            r1.erase(n, r1.size() - n);
+        return r1;
+    }
+
+    friend
+    basic_buffer_rope
+    tag_invoke(
+        suffix_tag const&,
+        basic_buffer_rope const& r,
+        std::size_t n)
+    {
+        basic_buffer_rope r1(r);
+        if(n < r1.size())
+            r1.consume(r1.size() - n);
+        return r1;
+    }
+
+private:
+    static
+    std::size_t
+    bytes(node const* t) noexcept
+    {
+        return t ? t->bytes : 0;
+    }
+
+    static
+    node const*
+    leftmost(node const* t) noexcept
+    {
+        if(t)
+            while(t->left)
+                t = t->left;
+        return t;
+    }
+
+    static
+    node const*
+    rightmost(node const* t) noexcept
+    {
+        if(t)
+            while(t->right)
+                t = t->right;
+        return t;
+    }
+
+    static
+    void
+    update(node* t) noexcept
+    {
+        t->bytes = bytes(t->left) +
+            t->b.size() + bytes(t->right);
+        if(t->left)
+            t->left->parent = t;
+        if(t->right)
+            t->right->parent = t;
+    }
+
+    void
+    check(std::size_t pos) const
+    {
+        if(pos > size())
+            detail::throw_invalid_argument();
+    }
+
+    // xorshift32
+    std::uint32_t
+    next_prio() noexcept
+    {
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+        return seed_;
+    }
+
+    // ensure that n nodes can be made
+    // without allocating
+    void
+    reserve_nodes(std::size_t n)
+    {
+        while(nfree_ < n)
+        {
+            auto const t = ::new(
+                alloc_traits::allocate(alloc_, 1)) node;
+            t->right = free_;
+            free_ = t;
+            ++nfree_;
+        }
+    }
+
+    node*
+    make_node(
+        block_type const& block,
+        const_buffer b) noexcept
+    {
+        BOOST_ASSERT(free_);
+        auto const t = free_;
+        free_ = t->right;
+        --nfree_;
+        t->block = block;
+        t->b = b;
+        t->left = nullptr;
+        t->right = nullptr;
+        t->parent = nullptr;
+        t->prio = next_prio();
+        update(t);
+        ++pieces_;
+        return t;
+    }
+
+    void
+    release(node* t) noexcept
+    {
+        --pieces_;
+        if(nfree_ < max_free)
+        {
+            t->block = block_type();
+            t->right = free_;
+            free_ = t;
+            ++nfree_;
+            return;
+        }
+        t->~node();
+        alloc_traits::deallocate(alloc_, t, 1);
+    }
+
+    void
+    free_nodes() noexcept
+    {
+        while(free_)
+        {
+            auto const t = free_;
+            free_ = t->right;
+            t->~node();
+            alloc_traits::deallocate(alloc_, t, 1);
+        }
+        nfree_ = 0;
+    }
+
+    // the spare nodes belong to the allocator,
+    // so they move with it; when it does not
+    // propagate, the allocators are equal
+    void
+    swap_all(
+        basic_buffer_rope& other,
+        std::true_type) noexcept
+    {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        swap_all(other, std::false_type{});
+    }
+
+    void
+    swap_all(
+        basic_buffer_rope& other,
+        std::false_type) noexcept
+    {
+        using std::swap;
+        swap(root_, other.root_);
+        swap(free_, other.free_);
+        swap(nfree_, other.nfree_);
+        swap(pieces_, other.pieces_);
+    }
+
+    void
+    destroy(node* t) noexcept
+    {
+        if(! t)
+            return;
+        destroy(t->left);
+        destroy(t->right);
+        release(t);
+    }
+
+    // remove the first k bytes of t, trimming
+    // the piece which straddles the cut in place
+    node*
+    drop_front(
+        node* t,
+        std::size_t k) noexcept
+    {
+        if(! t || k == 0)
+            return t;
+        auto const lb = bytes(t->left);
+        if(k <= lb)
+        {
+            t->left = drop_front(t->left, k);
+            update(t);
+            return t;
+        }
+        destroy(t->left);
+        t->left = nullptr;
+        auto const n = t->b.size();
+        if(k >= lb + n)
+        {
+            auto const r = t->right;
+            release(t);
+            return drop_front(r, k - lb - n);
+        }
+        t->b += k - lb;
+        update(t);
+        return t;
+    }
+
+    node*
+    clone(node const* t) noexcept
+    {
+        if(! t)
+            return nullptr;
+        auto const c = make_node(t->block, t->b);
+        c->prio = t->prio;
+        c->left = clone(t->left);
+        c->right = clone(t->right);
+        update(c);
+        return c;
+    }
+
+    // every key in a precedes every key in b
+    static
+    node*
+    merge(node* a, node* b) noexcept
+    {
+        if(! a)
+            return b;
+        if(! b)
+            return a;
+        if(a->prio > b->prio)
+        {
+            a->right = merge(a->right, b);
+            update(a);
+            return a;
+        }
+        b->left = merge(a, b->left);
+        update(b);
+        return b;
+    }
+
+    // the first k bytes of t go to l, the rest
+    // to r. a piece which straddles the cut is
+    // split using a node from the free list.
+    void
+    split(
+        node* t,
+        std::size_t k,
+        node*& l,
+        node*& r) noexcept
+    {
+        if(! t)
+        {
+            l = nullptr;
+            r = nullptr;
+            return;
+        }
+        auto const lb = bytes(t->left);
+        if(k <= lb)
+        {
+            split(t->left, k, l, t->left);
+            update(t);
+            r = t;
+            return;
+        }
+        auto const n = t->b.size();
+        if(k >= lb + n)
+        {
+            split(t->right, k - lb - n, t->right, r);
+            update(t);
+            l = t;
+            return;
+        }
+        auto const off = k - lb;
+        auto const s = make_node(t->block, t->b + off);
+        t->b = const_buffer(t->b.data(), off);
+        r = merge(s, t->right);
+        t->right = nullptr;
+        update(t);
+        l = t;
+    }
+
+    // replace n bytes at pos with the tree t
+    void
+    edit(
+        std::size_t pos,
+        std::size_t n,
+        node* t) noexcept
+    {
+        BOOST_ASSERT(nfree_ >= 2);
+        if(n == 0 && ! t)
+            return;
+        node* a;
+        node* b;
+        node* m;
+        node* c;
+        split(root_, pos, a, b);
+        if(n > 0)
+        {
+            split(b, n, m, c);
+            destroy(m);
+        }
+        else
+        {
+            c = b;
+        }
+        root_ = merge(merge(a, t), c);
+        if(root_)
+            root_->parent = nullptr;
+    }
+};
+
+//------------------------------------------------
+
+/** A rope of shared buffers with an atomic reference count.
+*/
+using buffer_rope = basic_buffer_rope<true>;
+
+/** A rope of shared buffers for use by a single thread.
+*/
+using local_buffer_rope = basic_buffer_rope<false>;
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+namespace pmr {
+
+/** A rope of shared buffers using a polymorphic allocator.
+*/
+using buffer_rope = basic_buffer_rope<true,
+    std::pmr::polymorphic_allocator<unsigned char>>;
+
+} // pmr
+#endif
+
+} // buffers
+} // boost
+
+#endif
@@ -126,6 +126,37 @@ public:
     BOOST_BUFFERS_DECL
     void
     consume(std::size_t n) noexcept;
+
+    /** Make the readable bytes contiguous.
+
+        The readable bytes are rotated in place
+        so that the second buffer returned by
+        @ref data is empty. When the free space
+        can hold the smaller of the two pieces,
+        each byte is moved once. Otherwise the
+        storage is rotated by swapping blocks.
+
+        Buffer sequences previously returned by
+        @ref data or @ref prepare are invalidated.
+
+        @return A buffer holding the readable bytes.
+    */
+    BOOST_BUFFERS_DECL
+    const_buffer
+    linearize() noexcept;
+
+    /** Return a contiguous prefix of the readable bytes.
+
+        The storage is only rotated, as if by
+        @ref linearize, when the first `n`
+        readable bytes straddle the end of the
+        storage.
+
+        @throws std::invalid_argument `n > size()`
+    */
+    BOOST_BUFFERS_DECL
+    const_buffer
+    peek_contiguous(std::size_t n);
 };
 
 } // buffers
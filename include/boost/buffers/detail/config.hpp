@@ -60,6 +60,32 @@ namespace buffers {
 
 //------------------------------------------------
 
+// Memory mapping, shared memory and file
+// facilities which require a POSIX system
+#if ! defined(BOOST_BUFFERS_NO_POSIX) && \
+    (defined(__unix__) || defined(__APPLE__))
+# define BOOST_BUFFERS_HAS_POSIX
+#endif
+
+// Moving pages between pipes and other
+// files with splice and vmsplice
+#if defined(BOOST_BUFFERS_HAS_POSIX) && \
+    defined(__linux__)
+# define BOOST_BUFFERS_HAS_SPLICE
+#endif
+
+// Polymorphic memory resources, which
+// require the C++17 standard library
+#if ! defined(BOOST_BUFFERS_NO_PMR) && defined(__has_include)
+# if __has_include(<memory_resource>) && ( \
+    __cplusplus >= 201703L || \
+    (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#  define BOOST_BUFFERS_HAS_PMR
+# endif
+#endif
+
+//------------------------------------------------
+
 // avoid all of Boost.TypeTraits for just this
 template<class...> struct make_void { typedef void type; };
 template<class... Ts> using void_t = typename make_void<Ts...>::type;
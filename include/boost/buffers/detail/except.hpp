@@ -29,6 +29,14 @@ BOOST_NORETURN
 throw_length_error(
     source_location const& loc = BOOST_CURRENT_LOCATION);
 
+// ev is an errno value
+BOOST_BUFFERS_DECL
+void
+BOOST_NORETURN
+throw_system_error(
+    int ev,
+    source_location const& loc = BOOST_CURRENT_LOCATION);
+
 } // detail
 } // buffers
 } // boost
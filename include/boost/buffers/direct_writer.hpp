@@ -0,0 +1,242 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_DIRECT_WRITER_HPP
+#define BOOST_BUFFERS_DIRECT_WRITER_HPP
+
+#include <boost/buffers/detail/config.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/mutable_buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace boost {
+namespace buffers {
+
+/** A file writer which bypasses the page cache.
+
+    Bytes are appended through @ref prepare and
+    @ref commit into a buffer whose address and
+    size are multiples of the block size. When
+    @ref prepare needs more space than is free,
+    the whole blocks in the buffer are written
+    with `pwrite` at a block-aligned offset, and
+    the partial block which remains is moved to
+    the front of the buffer.
+
+    @ref flush also writes the partial tail
+    block, padded with zeros to the block size,
+    then truncates the file to the bytes
+    committed. The tail stays in the buffer, and
+    is written again in place once it is full,
+    so every write the kernel sees is aligned
+    in address, size and offset, as `O_DIRECT`
+    requires.
+
+    The file is opened with `O_DIRECT`, or on
+    Apple systems given `F_NOCACHE`. When the
+    file system rejects direct I/O, as tmpfs
+    did before Linux 6.6, either when the file
+    is opened or on a write, the writer falls back to
+    buffered I/O and @ref is_direct returns
+    `false`.
+
+    @par Exception Safety
+    Errors from the file system are reported by
+    throwing `system_error`.
+
+    @par Example
+    @code
+    direct_writer w("journal.log");
+    for(auto const& rec : records)
+        w.commit(buffer_copy(
+            w.prepare(buffer_size(rec)), rec));
+    w.close();
+    @endcode
+
+    @see aligned_allocator
+*/
+class direct_writer
+{
+public:
+    using mutable_buffers_type = mutable_buffer;
+
+    /** Options for constructing a writer.
+    */
+    struct options
+    {
+        /** The alignment of addresses, sizes and offsets.
+
+            This must be a power of two, and a
+            multiple of the logical block size
+            of the device.
+        */
+        std::size_t block_size = 4096;
+
+        /** The size of the buffer.
+
+            This is rounded up to a whole
+            number of blocks.
+        */
+        std::size_t buffer_size = 1024 * 1024;
+
+        /** Whether to try to bypass the page cache.
+        */
+        bool direct = true;
+    };
+
+    /** Destructor.
+
+        If the file is open, it is closed as if
+        by @ref close, ignoring any error.
+    */
+    BOOST_BUFFERS_DECL
+    ~direct_writer();
+
+    /** Constructor.
+
+        The file is created if it does not
+        exist, and truncated if it does.
+
+        @throws system_error if the file
+        cannot be opened.
+    */
+    BOOST_BUFFERS_DECL
+    explicit
+    direct_writer(char const* path);
+
+    /** Constructor.
+
+        The file is created if it does not
+        exist, and truncated if it does.
+
+        @throws std::invalid_argument if the
+        block size is not a power of two.
+
+        @throws system_error if the file
+        cannot be opened.
+    */
+    BOOST_BUFFERS_DECL
+    direct_writer(
+        char const* path,
+        options const& opt);
+
+    /** Constructor.
+    */
+    direct_writer(direct_writer const&) = delete;
+
+    /** Assignment.
+    */
+    direct_writer& operator=(direct_writer const&) = delete;
+
+    /** Return whether writes bypass the page cache.
+    */
+    bool
+    is_direct() const noexcept
+    {
+        return direct_;
+    }
+
+    /** Return the block size.
+    */
+    std::size_t
+    block_size() const noexcept
+    {
+        return block_;
+    }
+
+    /** Return the size of the buffer.
+    */
+    std::size_t
+    capacity() const noexcept
+    {
+        return cap_;
+    }
+
+    /** Return the number of bytes committed.
+    */
+    std::uint64_t
+    size() const noexcept
+    {
+        return off_ + len_;
+    }
+
+    /** Return the file descriptor.
+    */
+    int
+    native_handle() const noexcept
+    {
+        return fd_;
+    }
+
+    /** Return writable space.
+
+        Whole blocks are written to the file
+        first if the buffer lacks the space.
+
+        @throws std::length_error if `n` exceeds
+        the capacity less a partial block.
+
+        @throws system_error on a write error.
+    */
+    BOOST_BUFFERS_DECL
+    mutable_buffers_type
+    prepare(std::size_t n);
+
+    /** Append bytes from the prepared space.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    commit(std::size_t n) noexcept;
+
+    /** Write every committed byte to the file.
+
+        The file is truncated to @ref size.
+
+        @throws system_error on a write error.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    flush();
+
+    /** Flush and close the file.
+
+        @throws system_error on a write error.
+        The file is closed regardless.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    close();
+
+private:
+    void write_blocks();
+    void write_at(
+        unsigned char const* p,
+        std::size_t n,
+        std::uint64_t offset);
+    bool fall_back() noexcept;
+
+    int fd_ = -1;
+    unsigned char* buf_ = nullptr;
+    std::size_t block_;
+    std::size_t cap_;
+    std::size_t len_ = 0;
+    std::size_t out_ = 0;
+    std::uint64_t off_ = 0;
+    bool direct_ = false;
+};
+
+} // buffers
+} // boost
+
+#endif
+
+#endif
@@ -0,0 +1,497 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_DYNAMIC_CIRCULAR_BUFFER_HPP
+#define BOOST_BUFFERS_DYNAMIC_CIRCULAR_BUFFER_HPP
+
+#include <boost/buffers/detail/config.hpp>
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/circular_buffer.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <memory>
+#include <type_traits>
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+#include <memory_resource>
+#endif
+
+namespace boost {
+namespace buffers {
+
+/** A circular buffer which owns and grows its storage.
+
+    This is a @ref circular_buffer whose storage
+    is obtained from an allocator. When @ref prepare
+    needs more space than is free, the storage is
+    replaced by a larger allocation, at least
+    double the previous one and no larger than
+    @ref max_size. The readable bytes are copied
+    to the start of the new storage, so the first
+    buffer returned by @ref data holds all of them
+    until the buffer wraps again.
+
+    The storage is kept when the buffer becomes
+    empty, unless an idle capacity is set at
+    construction or with @ref idle_capacity. When
+    @ref consume leaves the buffer empty and the
+    storage is larger than the idle capacity, the
+    storage is released and allocated again on the
+    next @ref prepare. With an idle capacity of
+    zero, a buffer which is empty holds no storage
+    at all, so many mostly idle buffers drawing
+    from a shared @ref block_pool cost little more
+    than their own size. @ref shrink_to_fit
+    releases unused storage explicitly.
+
+    Buffer sequences returned from @ref prepare
+    and @ref data always have length two.
+
+    @tparam Allocator The allocator used to obtain
+    storage. It is rebound to `unsigned char`.
+*/
+template<
+    class Allocator = std::allocator<unsigned char>>
+class basic_dynamic_circular_buffer
+{
+    using alloc_type = typename
+        std::allocator_traits<Allocator>::
+            template rebind_alloc<unsigned char>;
+
+    using alloc_traits =
+        std::allocator_traits<alloc_type>;
+
+    alloc_type alloc_;
+    circular_buffer cb_;
+    unsigned char* p_ = nullptr;
+    std::size_t cap_ = 0;
+    std::size_t idle_ = std::size_t(-1);
+    std::size_t max_;
+
+    // smallest allocation made by prepare
+    static constexpr std::size_t min_alloc = 512;
+
+public:
+    using allocator_type = Allocator;
+
+    using const_buffers_type =
+        const_buffer_pair;
+
+    using mutable_buffers_type =
+        mutable_buffer_pair;
+
+    /** Destructor.
+    */
+    ~basic_dynamic_circular_buffer()
+    {
+        release();
+    }
+
+    /** Constructor.
+    */
+    basic_dynamic_circular_buffer() noexcept(
+        std::is_nothrow_default_constructible<
+            alloc_type>::value)
+        : max_(alloc_traits::max_size(alloc_))
+    {
+    }
+
+    /** Constructor.
+
+        @param alloc The allocator to use.
+    */
+    explicit
+    basic_dynamic_circular_buffer(
+        Allocator const& alloc) noexcept
+        : alloc_(alloc)
+        , max_(alloc_traits::max_size(alloc_))
+    {
+    }
+
+    /** Constructor.
+
+        @param max_size The largest size the
+        buffer is permitted to grow to.
+
+        @param idle_capacity Storage of up to
+        this size is allocated up front, and
+        kept when the buffer becomes empty. The
+        default allocates nothing, and keeps
+        all of the storage.
+
+        @param alloc The allocator to use.
+
+        @throws std::invalid_argument
+        `idle_capacity > max_size`, unless it
+        is the default.
+    */
+    explicit
+    basic_dynamic_circular_buffer(
+        std::size_t max_size,
+        std::size_t idle_capacity = std::size_t(-1),
+        Allocator const& alloc = Allocator())
+        : alloc_(alloc)
+        , idle_(idle_capacity)
+        , max_(max_size)
+    {
+        if(max_ > alloc_traits::max_size(alloc_))
+            max_ = alloc_traits::max_size(alloc_);
+        if( idle_ > max_ &&
+            idle_ != std::size_t(-1))
+            detail::throw_invalid_argument();
+        if(idle_storage() > 0)
+            reallocate(idle_);
+    }
+
+    /** Constructor.
+
+        The readable bytes are copied, into
+        storage no larger than needed.
+    */
+    basic_dynamic_circular_buffer(
+        basic_dynamic_circular_buffer const& other)
+        : alloc_(alloc_traits::
+            select_on_container_copy_construction(
+                other.alloc_))
+        , idle_(other.idle_)
+        , max_(other.max_)
+    {
+        auto const n = other.size() > idle_storage()
+            ? other.size() : idle_storage();
+        if(n > 0)
+            reallocate(n, other.data());
+    }
+
+    /** Constructor.
+
+        Ownership of the storage is transferred,
+        leaving `other` empty.
+    */
+    basic_dynamic_circular_buffer(
+        basic_dynamic_circular_buffer&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , cb_(other.cb_)
+        , p_(other.p_)
+        , cap_(other.cap_)
+        , idle_(other.idle_)
+        , max_(other.max_)
+    {
+        other.cb_ = {};
+        other.p_ = nullptr;
+        other.cap_ = 0;
+    }
+
+    /** Assignment.
+    */
+    basic_dynamic_circular_buffer&
+    operator=(
+        basic_dynamic_circular_buffer const& other)
+    {
+        if(this == &other)
+            return *this;
+        copy_alloc(other, std::integral_constant<bool,
+            alloc_traits::
+                propagate_on_container_copy_assignment::value>{});
+        idle_ = other.idle_;
+        max_ = other.max_;
+        if(cap_ >= other.size())
+        {
+            cb_ = circular_buffer(p_, cap_,
+                buffer_copy(mutable_buffer(
+                    p_, cap_), other.data()));
+            return *this;
+        }
+        reallocate(other.size(), other.data());
+        return *this;
+    }
+
+    /** Assignment.
+    */
+    basic_dynamic_circular_buffer&
+    operator=(
+        basic_dynamic_circular_buffer&& other) noexcept(
+            alloc_traits::
+                propagate_on_container_move_assignment::value)
+    {
+        if(this == &other)
+            return *this;
+        if(! alloc_traits::
+            propagate_on_container_move_assignment::value &&
+            alloc_ != other.alloc_)
+        {
+            // storage cannot change hands
+            *this = static_cast<
+                basic_dynamic_circular_buffer const&>(other);
+            other.consume(other.size());
+            return *this;
+        }
+        release();
+        move_alloc(other, std::integral_constant<bool,
+            alloc_traits::
+                propagate_on_container_move_assignment::value>{});
+        cb_ = other.cb_;
+        p_ = other.p_;
+        cap_ = other.cap_;
+        idle_ = other.idle_;
+        max_ = other.max_;
+        other.cb_ = {};
+        other.p_ = nullptr;
+        other.cap_ = 0;
+        return *this;
+    }
+
+    /** Return the allocator.
+    */
+    allocator_type
+    get_allocator() const noexcept
+    {
+        return allocator_type(alloc_);
+    }
+
+    /** Return the idle capacity.
+
+        When @ref consume leaves the buffer empty,
+        storage larger than this is released.
+    */
+    std::size_t
+    idle_capacity() const noexcept
+    {
+        return idle_;
+    }
+
+    /** Set the idle capacity.
+
+        When @ref consume leaves the buffer empty,
+        storage larger than `n` is released, and
+        allocated again by the next @ref prepare.
+        If the buffer is empty now, its storage
+        is released at once. Unlike the constructor,
+        this does not allocate. `std::size_t(-1)`
+        keeps the storage.
+    */
+    void
+    idle_capacity(std::size_t n) noexcept
+    {
+        idle_ = n;
+        if( cb_.size() == 0 &&
+            cap_ > idle_)
+            release();
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return cb_.size();
+    }
+
+    std::size_t
+    max_size() const noexcept
+    {
+        return max_;
+    }
+
+    /** Return the number of bytes writable without allocating.
+    */
+    std::size_t
+    capacity() const noexcept
+    {
+        return cb_.capacity();
+    }
+
+    const_buffers_type
+    data() const noexcept
+    {
+        return cb_.data();
+    }
+
+    /** Return writable space, growing the storage if needed.
+
+        @throws std::length_error
+        `size() + n > max_size()`
+    */
+    mutable_buffers_type
+    prepare(std::size_t n)
+    {
+        if(n > cb_.capacity())
+        {
+            auto const size = cb_.size();
+            if(n > max_ - size)
+                detail::throw_length_error();
+
+            // grow geometrically
+            std::size_t want = size + n;
+            if(want < min_alloc)
+                want = min_alloc;
+            if(want < idle_storage())
+                want = idle_storage();
+            if(cap_ <= max_ / 2 && want < 2 * cap_)
+                want = 2 * cap_;
+            if(want > max_)
+                want = max_;
+            reallocate(want, cb_.data());
+        }
+        return cb_.prepare(n);
+    }
+
+    void
+    commit(std::size_t n) noexcept
+    {
+        cb_.commit(n);
+    }
+
+    void
+    consume(std::size_t n) noexcept
+    {
+        cb_.consume(n);
+        if( cb_.size() == 0 &&
+            cap_ > idle_)
+        {
+            // release storage while idle
+            release();
+        }
+    }
+
+    /** Make the readable bytes contiguous.
+
+        @see circular_buffer::linearize
+    */
+    const_buffer
+    linearize() noexcept
+    {
+        return cb_.linearize();
+    }
+
+    /** Return a contiguous prefix of the readable bytes.
+
+        @see circular_buffer::peek_contiguous
+    */
+    const_buffer
+    peek_contiguous(std::size_t n)
+    {
+        return cb_.peek_contiguous(n);
+    }
+
+    /** Release storage which is not needed.
+
+        The storage is reallocated to hold exactly
+        the readable bytes, or the idle capacity
+        if that is larger, relinearizing them.
+    */
+    void
+    shrink_to_fit()
+    {
+        auto n = cb_.size();
+        if(n < idle_storage())
+            n = idle_storage();
+        if(n >= cap_)
+            return;
+        if(n == 0)
+        {
+            release();
+            return;
+        }
+        reallocate(n, cb_.data());
+    }
+
+private:
+    // the storage which allocations
+    // do not go below, if any
+    std::size_t
+    idle_storage() const noexcept
+    {
+        if( idle_ > max_ ||
+            idle_ == std::size_t(-1))
+            return 0;
+        return idle_;
+    }
+
+    void
+    copy_alloc(
+        basic_dynamic_circular_buffer const& other,
+        std::true_type) noexcept
+    {
+        if(alloc_ != other.alloc_)
+        {
+            release();
+            alloc_ = other.alloc_;
+        }
+    }
+
+    void
+    copy_alloc(
+        basic_dynamic_circular_buffer const&,
+        std::false_type) noexcept
+    {
+    }
+
+    void
+    move_alloc(
+        basic_dynamic_circular_buffer& other,
+        std::true_type) noexcept
+    {
+        alloc_ = std::move(other.alloc_);
+    }
+
+    void
+    move_alloc(
+        basic_dynamic_circular_buffer&,
+        std::false_type) noexcept
+    {
+    }
+
+    void
+    release() noexcept
+    {
+        if(p_)
+            alloc_traits::deallocate(
+                alloc_, p_, cap_);
+        p_ = nullptr;
+        cap_ = 0;
+        cb_ = {};
+    }
+
+    void
+    reallocate(
+        std::size_t n,
+        const_buffer_pair const& live = {})
+    {
+        auto const p = alloc_traits::allocate(alloc_, n);
+        auto const size = buffer_copy(
+            mutable_buffer(p, n), live);
+        release();
+        p_ = p;
+        cap_ = n;
+        cb_ = circular_buffer(p_, cap_, size);
+    }
+};
+
+template<class Allocator>
+constexpr std::size_t
+basic_dynamic_circular_buffer<Allocator>::min_alloc;
+
+/** A circular buffer using the default allocator.
+*/
+using dynamic_circular_buffer =
+    basic_dynamic_circular_buffer<>;
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+namespace pmr {
+
+/** A circular buffer using a polymorphic allocator.
+*/
+using dynamic_circular_buffer =
+    basic_dynamic_circular_buffer<
+        std::pmr::polymorphic_allocator<unsigned char>>;
+
+} // pmr
+#endif
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,524 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_DYNAMIC_FLAT_BUFFER_HPP
+#define BOOST_BUFFERS_DYNAMIC_FLAT_BUFFER_HPP
+
+#include <boost/buffers/detail/config.hpp>
+#include <boost/buffers/const_buffer.hpp>
+#include <boost/buffers/mutable_buffer.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+#include <memory_resource>
+#endif
+
+namespace boost {
+namespace buffers {
+
+/** A flat buffer which owns and grows its storage.
+
+    The readable bytes are always contiguous.
+    Consuming bytes leaves a hole at the front of
+    the storage. When @ref prepare needs more space
+    than is free at the back, the readable bytes are
+    moved to the front to reclaim the hole, but only
+    if there are no more of them than the hole is
+    large; otherwise the storage is replaced by a
+    larger allocation, growing by the growth factor
+    given at construction, and no larger than
+    @ref max_size.
+
+    Each byte moved to the front is paid for by a
+    byte consumed since the previous move, and the
+    storage grows geometrically, so the amortized
+    cost of both @ref prepare and @ref consume is
+    constant.
+
+    The storage is kept when the buffer becomes
+    empty, unless an idle capacity is set with
+    @ref idle_capacity. With an idle capacity of
+    zero, a buffer which is empty holds no
+    storage at all: it is allocated on the next
+    @ref prepare, and released as soon as
+    @ref consume drains the buffer. Many mostly
+    idle buffers drawing from a shared
+    @ref block_pool then cost little more than
+    their own size.
+
+    Buffer sequences returned from @ref prepare
+    and @ref data always have a single element.
+
+    @tparam Allocator The allocator used to obtain
+    storage. It is rebound to `unsigned char`.
+*/
+template<
+    class Allocator = std::allocator<unsigned char>>
+class basic_dynamic_flat_buffer
+{
+    using alloc_type = typename
+        std::allocator_traits<Allocator>::
+            template rebind_alloc<unsigned char>;
+
+    using alloc_traits =
+        std::allocator_traits<alloc_type>;
+
+    alloc_type alloc_;
+    unsigned char* p_ = nullptr;
+    std::size_t cap_ = 0;
+    std::size_t in_pos_ = 0;
+    std::size_t in_size_ = 0;
+    std::size_t out_size_ = 0;
+    std::size_t idle_ = std::size_t(-1);
+    std::size_t max_;
+    double growth_ = 2;
+
+    // smallest allocation made by prepare
+    static constexpr std::size_t min_alloc = 512;
+
+public:
+    using allocator_type = Allocator;
+
+    using const_buffers_type =
+        const_buffer;
+
+    using mutable_buffers_type =
+        mutable_buffer;
+
+    /** Destructor.
+    */
+    ~basic_dynamic_flat_buffer()
+    {
+        release();
+    }
+
+    /** Constructor.
+    */
+    basic_dynamic_flat_buffer() noexcept(
+        std::is_nothrow_default_constructible<
+            alloc_type>::value)
+        : max_(alloc_traits::max_size(alloc_))
+    {
+    }
+
+    /** Constructor.
+
+        @param alloc The allocator to use.
+    */
+    explicit
+    basic_dynamic_flat_buffer(
+        Allocator const& alloc) noexcept
+        : alloc_(alloc)
+        , max_(alloc_traits::max_size(alloc_))
+    {
+    }
+
+    /** Constructor.
+
+        @param max_size The largest size the
+        buffer is permitted to grow to.
+
+        @param growth_factor The factor by which
+        the storage grows when it is replaced.
+
+        @param alloc The allocator to use.
+
+        @throws std::invalid_argument
+        `growth_factor <= 1`
+    */
+    explicit
+    basic_dynamic_flat_buffer(
+        std::size_t max_size,
+        double growth_factor = 2,
+        Allocator const& alloc = Allocator())
+        : alloc_(alloc)
+        , max_(max_size)
+        , growth_(growth_factor)
+    {
+        if(max_ > alloc_traits::max_size(alloc_))
+            max_ = alloc_traits::max_size(alloc_);
+        if(!(growth_ > 1))
+            detail::throw_invalid_argument();
+    }
+
+    /** Constructor.
+
+        The readable bytes are copied, into
+        storage no larger than needed.
+    */
+    basic_dynamic_flat_buffer(
+        basic_dynamic_flat_buffer const& other)
+        : alloc_(alloc_traits::
+            select_on_container_copy_construction(
+                other.alloc_))
+        , idle_(other.idle_)
+        , max_(other.max_)
+        , growth_(other.growth_)
+    {
+        if(other.in_size_ > 0)
+            reallocate(other.in_size_, other.data());
+    }
+
+    /** Constructor.
+
+        Ownership of the storage is transferred,
+        leaving `other` empty.
+    */
+    basic_dynamic_flat_buffer(
+        basic_dynamic_flat_buffer&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , p_(other.p_)
+        , cap_(other.cap_)
+        , in_pos_(other.in_pos_)
+        , in_size_(other.in_size_)
+        , idle_(other.idle_)
+        , max_(other.max_)
+        , growth_(other.growth_)
+    {
+        other.p_ = nullptr;
+        other.cap_ = 0;
+        other.in_pos_ = 0;
+        other.in_size_ = 0;
+        other.out_size_ = 0;
+    }
+
+    /** Assignment.
+    */
+    basic_dynamic_flat_buffer&
+    operator=(
+        basic_dynamic_flat_buffer const& other)
+    {
+        if(this == &other)
+            return *this;
+        copy_alloc(other, std::integral_constant<bool,
+            alloc_traits::
+                propagate_on_container_copy_assignment::value>{});
+        idle_ = other.idle_;
+        max_ = other.max_;
+        growth_ = other.growth_;
+        out_size_ = 0;
+        if(cap_ >= other.in_size_)
+        {
+            if(other.in_size_ > 0)
+                std::memcpy(p_, other.p_ +
+                    other.in_pos_, other.in_size_);
+            in_pos_ = 0;
+            in_size_ = other.in_size_;
+            return *this;
+        }
+        reallocate(other.in_size_, other.data());
+        return *this;
+    }
+
+    /** Assignment.
+    */
+    basic_dynamic_flat_buffer&
+    operator=(
+        basic_dynamic_flat_buffer&& other) noexcept(
+            alloc_traits::
+                propagate_on_container_move_assignment::value)
+    {
+        if(this == &other)
+            return *this;
+        if(! alloc_traits::
+            propagate_on_container_move_assignment::value &&
+            alloc_ != other.alloc_)
+        {
+            // storage cannot change hands
+            *this = static_cast<
+                basic_dynamic_flat_buffer const&>(other);
+            other.consume(other.size());
+            return *this;
+        }
+        release();
+        move_alloc(other, std::integral_constant<bool,
+            alloc_traits::
+                propagate_on_container_move_assignment::value>{});
+        p_ = other.p_;
+        cap_ = other.cap_;
+        in_pos_ = other.in_pos_;
+        in_size_ = other.in_size_;
+        idle_ = other.idle_;
+        max_ = other.max_;
+        growth_ = other.growth_;
+        other.p_ = nullptr;
+        other.cap_ = 0;
+        other.in_pos_ = 0;
+        other.in_size_ = 0;
+        other.out_size_ = 0;
+        return *this;
+    }
+
+    /** Return the allocator.
+    */
+    allocator_type
+    get_allocator() const noexcept
+    {
+        return allocator_type(alloc_);
+    }
+
+    /** Return the idle capacity.
+
+        When @ref consume leaves the buffer empty,
+        storage larger than this is released.
+    */
+    std::size_t
+    idle_capacity() const noexcept
+    {
+        return idle_;
+    }
+
+    /** Set the idle capacity.
+
+        When @ref consume leaves the buffer empty,
+        storage larger than `n` is released, and
+        allocated again by the next @ref prepare.
+        If the buffer is empty now, its storage
+        is released at once. The default keeps
+        the storage.
+    */
+    void
+    idle_capacity(std::size_t n) noexcept
+    {
+        idle_ = n;
+        if( in_size_ == 0 &&
+            cap_ > idle_)
+            release();
+    }
+
+    /** Return the growth factor.
+    */
+    double
+    growth_factor() const noexcept
+    {
+        return growth_;
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return in_size_;
+    }
+
+    std::size_t
+    max_size() const noexcept
+    {
+        return max_;
+    }
+
+    /** Return the number of bytes the buffer holds without allocating.
+    */
+    std::size_t
+    capacity() const noexcept
+    {
+        return cap_;
+    }
+
+    const_buffers_type
+    data() const noexcept
+    {
+        return { p_ + in_pos_, in_size_ };
+    }
+
+    /** Return writable space, growing the storage if needed.
+
+        @throws std::length_error
+        `size() + n > max_size()`
+    */
+    mutable_buffers_type
+    prepare(std::size_t n)
+    {
+        if(n > cap_ - in_pos_ - in_size_)
+            make_room(n);
+        out_size_ = n;
+        return { p_ + in_pos_ + in_size_, n };
+    }
+
+    void
+    commit(std::size_t n) noexcept
+    {
+        if(n < out_size_)
+            in_size_ += n;
+        else
+            in_size_ += out_size_;
+        out_size_ = 0;
+    }
+
+    void
+    consume(std::size_t n) noexcept
+    {
+        if(n < in_size_)
+        {
+            in_pos_ += n;
+            in_size_ -= n;
+            return;
+        }
+        in_pos_ = 0;
+        in_size_ = 0;
+        if(cap_ > idle_)
+        {
+            // release storage while idle
+            release();
+        }
+    }
+
+    /** Ensure the buffer holds `n` bytes without allocating.
+
+        @throws std::length_error `n > max_size()`
+    */
+    void
+    reserve(std::size_t n)
+    {
+        if(n <= cap_)
+            return;
+        if(n > max_)
+            detail::throw_length_error();
+        reallocate(n, data());
+    }
+
+    /** Release storage which is not needed.
+
+        The storage is reallocated to hold
+        exactly the readable bytes.
+    */
+    void
+    shrink_to_fit()
+    {
+        if(in_size_ >= cap_)
+            return;
+        if(in_size_ == 0)
+        {
+            release();
+            return;
+        }
+        reallocate(in_size_, data());
+    }
+
+private:
+    void
+    copy_alloc(
+        basic_dynamic_flat_buffer const& other,
+        std::true_type) noexcept
+    {
+        if(alloc_ != other.alloc_)
+        {
+            release();
+            alloc_ = other.alloc_;
+        }
+    }
+
+    void
+    copy_alloc(
+        basic_dynamic_flat_buffer const&,
+        std::false_type) noexcept
+    {
+    }
+
+    void
+    move_alloc(
+        basic_dynamic_flat_buffer& other,
+        std::true_type) noexcept
+    {
+        alloc_ = std::move(other.alloc_);
+    }
+
+    void
+    move_alloc(
+        basic_dynamic_flat_buffer&,
+        std::false_type) noexcept
+    {
+    }
+
+    void
+    make_room(std::size_t n)
+    {
+        if(n > max_ - in_size_)
+            detail::throw_length_error();
+
+        // the hole is reclaimed when moving the
+        // readable bytes costs no more than the
+        // bytes consumed to make the hole
+        if( n <= cap_ - in_size_ && (
+            in_size_ <= in_pos_ || cap_ >= max_))
+        {
+            std::memmove(p_, p_ + in_pos_, in_size_);
+            in_pos_ = 0;
+            return;
+        }
+
+        // grow geometrically
+        std::size_t want = in_size_ + n;
+        if(want < min_alloc)
+            want = min_alloc;
+        auto const g = static_cast<double>(cap_) * growth_;
+        if(g >= static_cast<double>(max_))
+            want = max_;
+        else if(want < static_cast<std::size_t>(g))
+            want = static_cast<std::size_t>(g);
+        if(want > max_)
+            want = max_;
+        reallocate(want, data());
+    }
+
+    void
+    release() noexcept
+    {
+        if(p_)
+            alloc_traits::deallocate(
+                alloc_, p_, cap_);
+        p_ = nullptr;
+        cap_ = 0;
+        in_pos_ = 0;
+        in_size_ = 0;
+        out_size_ = 0;
+    }
+
+    void
+    reallocate(
+        std::size_t n,
+        const_buffer live)
+    {
+        auto const p = alloc_traits::allocate(alloc_, n);
+        if(live.size() > 0)
+            std::memcpy(p, live.data(), live.size());
+        release();
+        p_ = p;
+        cap_ = n;
+        in_size_ = live.size();
+    }
+};
+
+template<class Allocator>
+constexpr std::size_t
+basic_dynamic_flat_buffer<Allocator>::min_alloc;
+
+/** A flat buffer using the default allocator.
+*/
+using dynamic_flat_buffer =
+    basic_dynamic_flat_buffer<>;
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+namespace pmr {
+
+/** A flat buffer using a polymorphic allocator.
+*/
+using dynamic_flat_buffer =
+    basic_dynamic_flat_buffer<
+        std::pmr::polymorphic_allocator<unsigned char>>;
+
+} // pmr
+#endif
+
+} // buffers
+} // boost
+
+#endif
@@ -14,14 +14,22 @@
 #include <boost/buffers/mutable_buffer.hpp>
 #include <boost/buffers/detail/except.hpp>
 #include <boost/assert.hpp>
+#include <cstring>
 
 namespace boost {
 namespace buffers {
 
 /** A DynamicBuffer with a fixed capacity.
 
+    When @ref prepare needs more space than is
+    free after the readable bytes, they are moved
+    to the front of the storage to reclaim the
+    space freed by @ref consume.
+
     Buffer sequences returned by this container
     always have a single element.
+
+    @see basic_dynamic_flat_buffer
 */
 class flat_buffer
 {
@@ -96,7 +104,7 @@ public:
     std::size_t
     capacity() const noexcept
     {
-        return cap_ - in_pos_;
+        return cap_;
     }
 
     const_buffers_type
@@ -114,6 +122,14 @@ public:
         if(n > cap_ - in_size_)
             detail::throw_invalid_argument();
 
+        if(n > cap_ - in_pos_ - in_size_)
+        {
+            // reclaim the consumed bytes
+            std::memmove(data_,
+                data_ + in_pos_, in_size_);
+            in_pos_ = 0;
+        }
+
         out_size_ = n;
         return { data_ +
             in_pos_ + in_size_, n };
@@ -0,0 +1,382 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_HUGE_PAGE_ARENA_HPP
+#define BOOST_BUFFERS_HUGE_PAGE_ARENA_HPP
+
+#include <boost/buffers/detail/config.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+#include <memory_resource>
+#endif
+
+namespace boost {
+namespace buffers {
+
+/** A source of memory backed by huge pages.
+
+    Each request at least as large as the
+    threshold is given its own anonymous mapping,
+    rounded up to a whole number of huge pages.
+    The mapping is obtained in the first of these
+    ways which succeeds:
+
+    @li With `MAP_HUGETLB`, from the pool of huge
+    pages reserved by the administrator.
+
+    @li With normal pages aligned to the huge page
+    size and advised with `MADV_HUGEPAGE`, so the
+    kernel backs it with transparent huge pages
+    when it can.
+
+    @li With normal pages.
+
+    Smaller requests are served by the global
+    heap, since a huge page for each would waste
+    most of its memory.
+
+    Which way each request took is counted, and
+    reported by @ref stats.
+
+    @par Thread Safety
+    Distinct objects: Safe.@n
+    Shared objects: Safe.
+
+    @see huge_page_allocator
+*/
+class huge_page_arena
+{
+public:
+    /** Options for constructing an arena.
+    */
+    struct options
+    {
+        /** The size of a huge page.
+
+            If zero, the default huge page size
+            of the system is used.
+        */
+        std::size_t huge_page_size = 0;
+
+        /** The smallest request given its own mapping.
+
+            If zero, half the huge page size is used.
+        */
+        std::size_t threshold = 0;
+
+        /** Whether to try `MAP_HUGETLB` first.
+        */
+        bool use_hugetlb = true;
+
+        /** Whether to advise `MADV_HUGEPAGE`.
+        */
+        bool use_transparent = true;
+    };
+
+    /** Counters describing the use of an arena.
+    */
+    struct stats_type
+    {
+        /** Requests served from reserved huge pages.
+        */
+        std::uint64_t hugetlb_allocations = 0;
+
+        /** Requests served by advised normal pages.
+        */
+        std::uint64_t transparent_allocations = 0;
+
+        /** Requests served by normal pages without advice.
+        */
+        std::uint64_t normal_allocations = 0;
+
+        /** Requests below the threshold, served by the heap.
+        */
+        std::uint64_t small_allocations = 0;
+
+        /** Bytes currently mapped by the arena.
+        */
+        std::size_t bytes_mapped = 0;
+    };
+
+    /** Return the default huge page size of the system.
+
+        On Linux this is read from `/proc/meminfo`.
+        Elsewhere, or if it cannot be read, 2MiB
+        is returned.
+    */
+    BOOST_BUFFERS_DECL
+    static
+    std::size_t
+    default_huge_page_size() noexcept;
+
+    /** Constructor.
+    */
+    BOOST_BUFFERS_DECL
+    huge_page_arena();
+
+    /** Constructor.
+
+        @throws std::invalid_argument if the huge
+        page size is not a multiple of the page size.
+    */
+    BOOST_BUFFERS_DECL
+    explicit
+    huge_page_arena(options const& opt);
+
+    /** Constructor.
+    */
+    huge_page_arena(huge_page_arena const&) = delete;
+
+    /** Assignment.
+    */
+    huge_page_arena& operator=(huge_page_arena const&) = delete;
+
+    /** Return the huge page size in use.
+    */
+    std::size_t
+    huge_page_size() const noexcept
+    {
+        return huge_;
+    }
+
+    /** Return the smallest request given its own mapping.
+    */
+    std::size_t
+    threshold() const noexcept
+    {
+        return threshold_;
+    }
+
+    /** Allocate at least `n` bytes.
+
+        Memory at or above the threshold is
+        aligned to the huge page size. Smaller
+        memory is suitably aligned for any
+        fundamental type.
+
+        @throws std::bad_alloc on failure.
+    */
+    BOOST_BUFFERS_DECL
+    void*
+    allocate(std::size_t n);
+
+    /** Deallocate memory.
+
+        @param p A pointer returned by
+        @ref allocate on this arena.
+
+        @param n The size passed to @ref allocate.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    deallocate(
+        void* p,
+        std::size_t n) noexcept;
+
+    /** Return a snapshot of the counters.
+    */
+    BOOST_BUFFERS_DECL
+    stats_type
+    stats() const noexcept;
+
+private:
+    void* map_aligned(std::size_t n) noexcept;
+
+    std::size_t huge_;
+    std::size_t threshold_;
+    bool hugetlb_;
+    bool transparent_;
+    int size_flag_ = 0;
+
+    std::atomic<std::uint64_t> n_hugetlb_{0};
+    std::atomic<std::uint64_t> n_transparent_{0};
+    std::atomic<std::uint64_t> n_normal_{0};
+    std::atomic<std::uint64_t> n_small_{0};
+    std::atomic<std::size_t> mapped_{0};
+};
+
+//------------------------------------------------
+
+/** An allocator which obtains memory from a huge_page_arena.
+
+    This allows the owning buffers in this
+    library to draw their storage from a
+    @ref huge_page_arena, for example
+    `basic_dynamic_flat_buffer<huge_page_allocator<unsigned char>>`.
+*/
+template<class T>
+class huge_page_allocator
+{
+    huge_page_arena* arena_;
+
+    template<class U>
+    friend class huge_page_allocator;
+
+public:
+    using value_type = T;
+
+    /** Constructor.
+    */
+    explicit
+    huge_page_allocator(
+        huge_page_arena& arena) noexcept
+        : arena_(&arena)
+    {
+    }
+
+    /** Constructor.
+    */
+    template<class U>
+    huge_page_allocator(
+        huge_page_allocator<U> const& other) noexcept
+        : arena_(other.arena_)
+    {
+    }
+
+    /** Return the arena.
+    */
+    huge_page_arena&
+    arena() const noexcept
+    {
+        return *arena_;
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        return static_cast<T*>(
+            arena_->allocate(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        arena_->deallocate(p, n * sizeof(T));
+    }
+
+    template<class U>
+    bool
+    operator==(
+        huge_page_allocator<U> const& other) const noexcept
+    {
+        return arena_ == other.arena_;
+    }
+
+    template<class U>
+    bool
+    operator!=(
+        huge_page_allocator<U> const& other) const noexcept
+    {
+        return arena_ != other.arena_;
+    }
+};
+
+//------------------------------------------------
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+
+/** A polymorphic memory resource over a huge_page_arena.
+
+    This allows the `pmr` buffers and containers
+    to draw their storage from a @ref huge_page_arena.
+    Requests for an alignment which the arena
+    cannot provide are passed to
+    `std::pmr::new_delete_resource()`.
+
+    This type is only available when the standard
+    library provides `<memory_resource>`.
+*/
+class huge_page_resource
+    : public std::pmr::memory_resource
+{
+    huge_page_arena* arena_;
+
+    // small requests are only aligned
+    // for fundamental types
+    bool
+    bypass(
+        std::size_t n,
+        std::size_t align) const noexcept
+    {
+        return
+            align > alignof(std::max_align_t) && (
+                n < arena_->threshold() ||
+                align > arena_->huge_page_size());
+    }
+
+public:
+    /** Constructor.
+    */
+    explicit
+    huge_page_resource(
+        huge_page_arena& arena) noexcept
+        : arena_(&arena)
+    {
+    }
+
+    /** Return the arena.
+    */
+    huge_page_arena&
+    arena() const noexcept
+    {
+        return *arena_;
+    }
+
+private:
+    void*
+    do_allocate(
+        std::size_t n,
+        std::size_t align) override
+    {
+        if(bypass(n, align))
+            return std::pmr::new_delete_resource()->
+                allocate(n, align);
+        return arena_->allocate(n);
+    }
+
+    void
+    do_deallocate(
+        void* p,
+        std::size_t n,
+        std::size_t align) override
+    {
+        if(bypass(n, align))
+        {
+            std::pmr::new_delete_resource()->
+                deallocate(p, n, align);
+            return;
+        }
+        arena_->deallocate(p, n);
+    }
+
+    bool
+    do_is_equal(
+        std::pmr::memory_resource const&
+            other) const noexcept override
+    {
+        auto const p = dynamic_cast<
+            huge_page_resource const*>(&other);
+        return p && p->arena_ == arena_;
+    }
+};
+
+#endif
+
+} // buffers
+} // boost
+
+#endif
+
+#endif
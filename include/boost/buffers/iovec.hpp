@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_IOVEC_HPP
+#define BOOST_BUFFERS_IOVEC_HPP
+
+#include <boost/buffers/detail/config.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/const_buffer.hpp>
+#include <boost/buffers/range.hpp>
+#include <boost/buffers/type_traits.hpp>
+#include <cstddef>
+
+#include <sys/uio.h>
+
+namespace boost {
+namespace buffers {
+
+/** Describe a buffer sequence with an array of `iovec`.
+
+    The buffers are stored in order, skipping
+    those which are empty, until the sequence
+    or the array ends. The result may be passed
+    to `writev`, `pwritev` or `vmsplice`.
+
+    @param bs The buffer sequence.
+
+    @param iov The array to fill.
+
+    @param n The number of elements in the array.
+
+    @return The number of elements filled.
+*/
+template<class ConstBufferSequence>
+std::size_t
+to_iovec(
+    ConstBufferSequence const& bs,
+    ::iovec* iov,
+    std::size_t n) noexcept
+{
+    // If you get a compile error here it
+    // means that your type does not meet
+    // the requirements.
+    static_assert(
+        is_const_buffer_sequence<
+            ConstBufferSequence>::value,
+        "Type requirements not met");
+
+    std::size_t i = 0;
+    auto const last = end(bs);
+    for(auto it = begin(bs);
+        it != last && i < n; ++it)
+    {
+        const_buffer const b(*it);
+        if(b.size() == 0)
+            continue;
+        iov[i].iov_base =
+            const_cast<void*>(b.data());
+        iov[i].iov_len = b.size();
+        ++i;
+    }
+    return i;
+}
+
+} // buffers
+} // boost
+
+#endif
+
+#endif
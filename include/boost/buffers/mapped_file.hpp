@@ -0,0 +1,546 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_MAPPED_FILE_HPP
+#define BOOST_BUFFERS_MAPPED_FILE_HPP
+
+#include <boost/buffers/detail/config.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/const_buffer.hpp>
+#include <boost/buffers/tag_invoke.hpp>
+#include <boost/assert.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace boost {
+namespace buffers {
+
+class mapped_file;
+
+/** A range of a mapped file as a sequence of buffers.
+
+    Objects of this type are lightweight views
+    which refer to a @ref mapped_file, and meet
+    the requirements of <em>ConstBufferSequence</em>.
+    Each element is the part of one window of
+    the file which lies within the range.
+
+    The prefix or suffix of a range is again a
+    range of the same file, computed without
+    mapping anything.
+
+    @par Preconditions
+    The file outlives the range, and the bytes
+    of the range are not consumed from the file
+    while the range is in use.
+*/
+class mapped_file_buffers
+{
+    mapped_file const* f_ = nullptr;
+    std::uint64_t lo_ = 0;
+    std::uint64_t hi_ = 0;
+
+    friend class mapped_file;
+
+    mapped_file_buffers(
+        mapped_file const* f,
+        std::uint64_t lo,
+        std::uint64_t hi) noexcept
+        : f_(f)
+        , lo_(lo)
+        , hi_(hi)
+    {
+    }
+
+public:
+    class const_iterator;
+
+    using value_type = const_buffer;
+
+    /** Constructor.
+
+        Default-constructed ranges are empty.
+    */
+    mapped_file_buffers() = default;
+
+    /** Return an iterator to the first window.
+    */
+    inline
+    const_iterator
+    begin() const noexcept;
+
+    /** Return an iterator to one past the last window.
+    */
+    inline
+    const_iterator
+    end() const noexcept;
+
+    /** Return the number of bytes in the range.
+    */
+    std::size_t
+    size() const noexcept
+    {
+        return static_cast<
+            std::size_t>(hi_ - lo_);
+    }
+
+    friend
+    mapped_file_buffers
+    tag_invoke(
+        prefix_tag const&,
+        mapped_file_buffers const& b,
+        std::size_t n) noexcept
+    {
+        auto r = b;
+        if(n < r.hi_ - r.lo_)
+            r.hi_ = r.lo_ + n;
+        return r;
+    }
+
+    friend
+    mapped_file_buffers
+    tag_invoke(
+        suffix_tag const&,
+        mapped_file_buffers const& b,
+        std::size_t n) noexcept
+    {
+        auto r = b;
+        if(n < r.hi_ - r.lo_)
+            r.lo_ = r.hi_ - n;
+        return r;
+    }
+
+    friend
+    std::size_t
+    tag_invoke(
+        size_tag const&,
+        mapped_file_buffers const& b) noexcept
+    {
+        return b.size();
+    }
+};
+
+//------------------------------------------------
+
+/** A read-only file presented as a sequence of mapped windows.
+
+    The file, or a byte range of it, is divided
+    into windows aligned to the window size.
+    The range is mapped with `mmap` when the
+    object is constructed, so iterating over it
+    maps nothing and cannot fail. The mapping is
+    advised with `MADV_SEQUENTIAL`, and each
+    window with `MADV_WILLNEED` as the cursor
+    reaches the window before it, so the kernel
+    reads ahead of the consumer. No `read`
+    calls are made.
+
+    The file keeps a cursor, which starts at
+    the beginning of the range. The object is a
+    <em>ConstBufferSequence</em> for the bytes
+    from the cursor to the end of the range.
+    @ref consume advances the cursor, and
+    unmaps every window which lies entirely
+    behind it, so the mapped address space
+    shrinks as the bytes are used.
+
+    The buffers of a sequence may be collected,
+    for example into an array of `iovec` for
+    `writev`, and remain valid until they are
+    consumed.
+
+    @par Thread Safety
+    Distinct objects: Safe.@n
+    Shared objects: Unsafe.
+
+    @par Example
+    @code
+    mapped_file f("index.html");
+    while(f.size() > 0)
+    {
+        auto const n = buffer_copy(
+            out.prepare(65536), f);
+        out.commit(n);
+        f.consume(n);
+    }
+    @endcode
+*/
+class mapped_file
+{
+    int fd_ = -1;
+    std::uint64_t pos_ = 0;
+    std::uint64_t end_ = 0;
+    std::size_t window_ = 0;
+
+    // windows of the range, by index from
+    // the window which holds the start; those
+    // before behind_ are entirely consumed
+    std::vector<unsigned char const*> maps_;
+    std::uint64_t first_ = 0;
+    std::size_t behind_ = 0;
+
+    friend class mapped_file_buffers;
+
+public:
+    using value_type = const_buffer;
+
+    using const_iterator =
+        mapped_file_buffers::const_iterator;
+
+    /** The default size of a window, in bytes.
+    */
+    static constexpr std::size_t
+        default_window_size = 4 * 1024 * 1024;
+
+    /** Destructor.
+
+        All windows are unmapped and
+        the file is closed.
+    */
+    BOOST_BUFFERS_DECL
+    ~mapped_file();
+
+    /** Constructor.
+
+        The object is empty.
+    */
+    mapped_file() = default;
+
+    /** Constructor.
+
+        Opens the file read-only and presents
+        the bytes in the range starting at
+        `offset` of `length` bytes, or up to
+        the end of the file if it is shorter.
+
+        @param path The path of the file.
+
+        @param offset The first byte of the range.
+
+        @param length The largest number of bytes
+        in the range.
+
+        @param window_size The size of each window.
+        It must be a multiple of the page size.
+
+        @throws system_error if the file cannot
+        be opened or mapped.
+
+        @throws std::invalid_argument if `offset`
+        is past the end of the file, or the window
+        size is not a positive multiple of the page
+        size.
+    */
+    BOOST_BUFFERS_DECL
+    explicit
+    mapped_file(
+        char const* path,
+        std::uint64_t offset = 0,
+        std::uint64_t length = std::uint64_t(-1),
+        std::size_t window_size =
+            default_window_size);
+
+    /** Constructor.
+
+        Presents a range of an open file. The
+        descriptor is duplicated, and the caller
+        keeps ownership of `fd`.
+
+        @throws system_error if the descriptor
+        cannot be duplicated, or the file
+        cannot be mapped.
+
+        @throws std::invalid_argument as above.
+    */
+    BOOST_BUFFERS_DECL
+    mapped_file(
+        int fd,
+        std::uint64_t offset,
+        std::uint64_t length = std::uint64_t(-1),
+        std::size_t window_size =
+            default_window_size);
+
+    /** Constructor.
+
+        Ownership of the file and the windows is
+        transferred, leaving `other` empty. Ranges
+        and iterators which refer to `other` are
+        invalidated.
+    */
+    BOOST_BUFFERS_DECL
+    mapped_file(
+        mapped_file&& other) noexcept;
+
+    /** Assignment.
+    */
+    BOOST_BUFFERS_DECL
+    mapped_file&
+    operator=(
+        mapped_file&& other) noexcept;
+
+    /** Return the number of bytes after the cursor.
+    */
+    std::size_t
+    size() const noexcept
+    {
+        return static_cast<
+            std::size_t>(end_ - pos_);
+    }
+
+    /** Return the size of each window.
+    */
+    std::size_t
+    window_size() const noexcept
+    {
+        return window_;
+    }
+
+    /** Return the number of windows currently mapped.
+    */
+    BOOST_BUFFERS_DECL
+    std::size_t
+    mapped_windows() const noexcept;
+
+    /** Return the bytes after the cursor as a range.
+    */
+    mapped_file_buffers
+    buffers() const noexcept
+    {
+        return { this, pos_, end_ };
+    }
+
+    /** Return an iterator to the first window.
+    */
+    inline
+    const_iterator
+    begin() const noexcept;
+
+    /** Return an iterator to one past the last window.
+    */
+    inline
+    const_iterator
+    end() const noexcept;
+
+    /** Advance the cursor.
+
+        Windows which lie entirely behind the
+        new cursor are unmapped.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    consume(std::size_t n) noexcept;
+
+    friend
+    mapped_file_buffers
+    tag_invoke(
+        prefix_tag const&,
+        mapped_file const& f,
+        std::size_t n) noexcept
+    {
+        return tag_invoke(prefix_tag{},
+            f.buffers(), n);
+    }
+
+    friend
+    mapped_file_buffers
+    tag_invoke(
+        suffix_tag const&,
+        mapped_file const& f,
+        std::size_t n) noexcept
+    {
+        return tag_invoke(suffix_tag{},
+            f.buffers(), n);
+    }
+
+    friend
+    std::size_t
+    tag_invoke(
+        size_tag const&,
+        mapped_file const& f) noexcept
+    {
+        return f.size();
+    }
+
+private:
+    void
+    init(
+        std::uint64_t offset,
+        std::uint64_t length,
+        std::size_t window_size);
+
+    // return the mapping of
+    // the window at index k
+    unsigned char const*
+    window(std::uint64_t k) const noexcept
+    {
+        BOOST_ASSERT(k >= first_);
+        BOOST_ASSERT(k - first_ < maps_.size());
+        return maps_[static_cast<
+            std::size_t>(k - first_)];
+    }
+
+    std::size_t
+    window_bytes(std::size_t i) const noexcept;
+
+    void advise(std::size_t i) const noexcept;
+    void release() noexcept;
+};
+
+//------------------------------------------------
+
+/** An iterator over the windows of a range.
+*/
+class mapped_file_buffers::const_iterator
+{
+    mapped_file const* f_ = nullptr;
+    std::uint64_t lo_ = 0;
+    std::uint64_t hi_ = 0;
+    std::uint64_t k_ = 0;
+
+    friend class mapped_file_buffers;
+
+    const_iterator(
+        mapped_file const* f,
+        std::uint64_t lo,
+        std::uint64_t hi,
+        std::uint64_t k) noexcept
+        : f_(f)
+        , lo_(lo)
+        , hi_(hi)
+        , k_(k)
+    {
+    }
+
+public:
+    using value_type = const_buffer;
+    using reference = const_buffer;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category =
+        std::bidirectional_iterator_tag;
+
+    const_iterator() = default;
+
+    bool
+    operator==(
+        const_iterator const& other) const noexcept
+    {
+        return
+            f_ == other.f_ &&
+            lo_ == other.lo_ &&
+            hi_ == other.hi_ &&
+            k_ == other.k_;
+    }
+
+    bool
+    operator!=(
+        const_iterator const& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+    reference
+    operator*() const noexcept
+    {
+        auto const w = f_->window_;
+        auto lo = k_ * w;
+        auto hi = lo + w;
+        auto p = f_->window(k_);
+        if(lo < lo_)
+        {
+            p += lo_ - lo;
+            lo = lo_;
+        }
+        if(hi > hi_)
+            hi = hi_;
+        return { p, static_cast<
+            std::size_t>(hi - lo) };
+    }
+
+    const_iterator&
+    operator++() noexcept
+    {
+        ++k_;
+        return *this;
+    }
+
+    const_iterator
+    operator++(int) noexcept
+    {
+        auto temp = *this;
+        ++(*this);
+        return temp;
+    }
+
+    const_iterator&
+    operator--() noexcept
+    {
+        --k_;
+        return *this;
+    }
+
+    const_iterator
+    operator--(int) noexcept
+    {
+        auto temp = *this;
+        --(*this);
+        return temp;
+    }
+};
+
+//------------------------------------------------
+
+auto
+mapped_file_buffers::
+begin() const noexcept ->
+    const_iterator
+{
+    if(lo_ == hi_)
+        return end();
+    return { f_, lo_, hi_,
+        lo_ / f_->window_ };
+}
+
+auto
+mapped_file_buffers::
+end() const noexcept ->
+    const_iterator
+{
+    if(lo_ == hi_)
+        return { f_, lo_, hi_, 0 };
+    return { f_, lo_, hi_,
+        (hi_ - 1) / f_->window_ + 1 };
+}
+
+auto
+mapped_file::
+begin() const noexcept ->
+    const_iterator
+{
+    return buffers().begin();
+}
+
+auto
+mapped_file::
+end() const noexcept ->
+    const_iterator
+{
+    return buffers().end();
+}
+
+} // buffers
+} // boost
+
+#endif
+
+#endif
@@ -0,0 +1,419 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_MONOTONIC_ARENA_HPP
+#define BOOST_BUFFERS_MONOTONIC_ARENA_HPP
+
+#include <boost/buffers/detail/config.hpp>
+#include <boost/throw_exception.hpp>
+#include <cstddef>
+#include <new>
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+#include <memory_resource>
+#endif
+
+namespace boost {
+namespace buffers {
+
+/** A source of memory which is released all at once.
+
+    Requests are carved from a contiguous region
+    by advancing a cursor. The first region is a
+    buffer supplied by the caller, so that small
+    workloads never touch the heap. When it is
+    exhausted, chunks are obtained from the heap,
+    each larger than the last.
+
+    Deallocation does nothing, except that the
+    most recent request may be given back. All of
+    the memory is instead reclaimed at once by
+    @ref reset, which takes constant time: the
+    cursor returns to the supplied buffer, and
+    the chunks are kept and reused in order by
+    later requests. @ref release also returns
+    the chunks to the heap.
+
+    This suits per-request storage, such as the
+    buffers and sequences built while handling
+    one message, which all die together.
+
+    @par Thread Safety
+    Distinct objects: Safe.@n
+    Shared objects: Unsafe.
+
+    @see monotonic_allocator, static_monotonic_arena
+*/
+class monotonic_arena
+{
+    struct chunk
+    {
+        chunk* next;
+        std::size_t size;
+    };
+
+    unsigned char* initial_;
+    std::size_t initial_size_;
+    chunk* head_ = nullptr;
+    chunk* tail_ = nullptr;
+    chunk* cur_ = nullptr;
+    unsigned char* p_;
+    unsigned char* end_;
+    std::size_t next_size_;
+    std::size_t used_ = 0;
+    std::size_t chunks_ = 0;
+    std::size_t reserved_ = 0;
+
+public:
+    /** The default size of the first heap chunk.
+    */
+    static constexpr std::size_t
+        default_chunk_size = 4096;
+
+    /** Counters describing the use of an arena.
+    */
+    struct stats_type
+    {
+        /** Bytes handed out since the last reset.
+        */
+        std::size_t bytes_allocated = 0;
+
+        /** Heap chunks currently held.
+        */
+        std::size_t chunks = 0;
+
+        /** Bytes held in heap chunks.
+        */
+        std::size_t bytes_reserved = 0;
+    };
+
+    /** Destructor.
+
+        All heap chunks are released.
+    */
+    BOOST_BUFFERS_DECL
+    ~monotonic_arena();
+
+    /** Constructor.
+
+        The arena has no initial buffer.
+
+        @param next_chunk_size The size of the
+        first heap chunk.
+    */
+    BOOST_BUFFERS_DECL
+    explicit
+    monotonic_arena(
+        std::size_t next_chunk_size =
+            default_chunk_size) noexcept;
+
+    /** Constructor.
+
+        Requests are served from `buffer` until
+        it is exhausted. The buffer must remain
+        valid for the lifetime of the arena.
+
+        @param buffer The initial buffer.
+
+        @param size The size of the initial buffer.
+
+        @param next_chunk_size The size of the
+        first heap chunk.
+    */
+    BOOST_BUFFERS_DECL
+    monotonic_arena(
+        void* buffer,
+        std::size_t size,
+        std::size_t next_chunk_size =
+            default_chunk_size) noexcept;
+
+    /** Constructor.
+    */
+    monotonic_arena(monotonic_arena const&) = delete;
+
+    /** Assignment.
+    */
+    monotonic_arena& operator=(monotonic_arena const&) = delete;
+
+    /** Allocate memory.
+
+        @param n The number of bytes.
+
+        @param align The alignment, which must be
+        a power of two.
+
+        @throws std::invalid_argument if `align`
+        is not a power of two.
+
+        @throws std::bad_alloc if a heap chunk
+        cannot be obtained.
+    */
+    BOOST_BUFFERS_DECL
+    void*
+    allocate(
+        std::size_t n,
+        std::size_t align =
+            alignof(std::max_align_t));
+
+    /** Deallocate memory.
+
+        Nothing is reclaimed, unless `p` is the
+        most recent allocation, in which case the
+        cursor is moved back to it. This lets a
+        container which grows by reallocating the
+        last thing allocated reuse its memory.
+    */
+    void
+    deallocate(
+        void* p,
+        std::size_t n) noexcept
+    {
+        auto const q =
+            static_cast<unsigned char*>(p);
+        if(q + n == p_)
+        {
+            p_ = q;
+            used_ -= n;
+        }
+    }
+
+    /** Reclaim all allocated memory.
+
+        Heap chunks are kept for reuse. This
+        takes constant time. All memory allocated
+        from the arena becomes invalid.
+    */
+    void
+    reset() noexcept
+    {
+        cur_ = nullptr;
+        p_ = initial_;
+        end_ = initial_ + initial_size_;
+        used_ = 0;
+    }
+
+    /** Reclaim all memory, and release the heap chunks.
+
+        All memory allocated from the arena
+        becomes invalid.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    release() noexcept;
+
+    /** Return a snapshot of the counters.
+    */
+    stats_type
+    stats() const noexcept
+    {
+        stats_type st;
+        st.bytes_allocated = used_;
+        st.chunks = chunks_;
+        st.bytes_reserved = reserved_;
+        return st;
+    }
+
+private:
+    void*
+    allocate_slow(
+        std::size_t n,
+        std::size_t align);
+};
+
+//------------------------------------------------
+
+/** A monotonic arena with an inline initial buffer.
+
+    The first `N` bytes of requests are served
+    from storage inside the object. An instance
+    on the stack therefore allows a small
+    workload to run without any heap allocation.
+
+    @tparam N The size of the inline buffer.
+*/
+template<std::size_t N>
+class static_monotonic_arena
+    : public monotonic_arena
+{
+    static_assert(N > 0,
+        "N must be positive");
+
+    alignas(std::max_align_t)
+        unsigned char buf_[N];
+
+public:
+    /** Constructor.
+
+        @param next_chunk_size The size of the
+        first heap chunk.
+    */
+    explicit
+    static_monotonic_arena(
+        std::size_t next_chunk_size =
+            default_chunk_size) noexcept
+        : monotonic_arena(
+            buf_, N, next_chunk_size)
+    {
+    }
+};
+
+//------------------------------------------------
+
+/** An allocator which obtains memory from a monotonic_arena.
+
+    This allows the owning buffers and sequences
+    in this library to draw their storage from a
+    @ref monotonic_arena, for example
+    `basic_dynamic_flat_buffer<monotonic_allocator<unsigned char>>`.
+    The memory is reclaimed when the arena is
+    reset, so the containers must be destroyed
+    first.
+*/
+template<class T>
+class monotonic_allocator
+{
+    monotonic_arena* arena_;
+
+    template<class U>
+    friend class monotonic_allocator;
+
+public:
+    using value_type = T;
+
+    /** Constructor.
+    */
+    explicit
+    monotonic_allocator(
+        monotonic_arena& arena) noexcept
+        : arena_(&arena)
+    {
+    }
+
+    /** Constructor.
+    */
+    template<class U>
+    monotonic_allocator(
+        monotonic_allocator<U> const& other) noexcept
+        : arena_(other.arena_)
+    {
+    }
+
+    /** Return the arena.
+    */
+    monotonic_arena&
+    arena() const noexcept
+    {
+        return *arena_;
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        if(n > std::size_t(-1) / sizeof(T))
+            throw_exception(std::bad_alloc());
+        return static_cast<T*>(
+            arena_->allocate(
+                n * sizeof(T), alignof(T)));
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        arena_->deallocate(p, n * sizeof(T));
+    }
+
+    template<class U>
+    bool
+    operator==(
+        monotonic_allocator<U> const& other) const noexcept
+    {
+        return arena_ == other.arena_;
+    }
+
+    template<class U>
+    bool
+    operator!=(
+        monotonic_allocator<U> const& other) const noexcept
+    {
+        return arena_ != other.arena_;
+    }
+};
+
+//------------------------------------------------
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+
+/** A polymorphic memory resource over a monotonic_arena.
+
+    This allows containers which use
+    `std::pmr::polymorphic_allocator`, such as
+    `std::pmr::vector` or `std::pmr::string`, to
+    draw their storage from a @ref monotonic_arena.
+
+    This type is only available when the standard
+    library provides `<memory_resource>`.
+*/
+class monotonic_resource
+    : public std::pmr::memory_resource
+{
+    monotonic_arena* arena_;
+
+public:
+    /** Constructor.
+    */
+    explicit
+    monotonic_resource(
+        monotonic_arena& arena) noexcept
+        : arena_(&arena)
+    {
+    }
+
+    /** Return the arena.
+    */
+    monotonic_arena&
+    arena() const noexcept
+    {
+        return *arena_;
+    }
+
+private:
+    void*
+    do_allocate(
+        std::size_t n,
+        std::size_t align) override
+    {
+        return arena_->allocate(n, align);
+    }
+
+    void
+    do_deallocate(
+        void* p,
+        std::size_t n,
+        std::size_t) override
+    {
+        arena_->deallocate(p, n);
+    }
+
+    bool
+    do_is_equal(
+        std::pmr::memory_resource const&
+            other) const noexcept override
+    {
+        auto const p = dynamic_cast<
+            monotonic_resource const*>(&other);
+        return p && p->arena_ == arena_;
+    }
+};
+
+#endif
+
+} // buffers
+} // boost
+
+#endif
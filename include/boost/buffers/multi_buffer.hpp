@@ -0,0 +1,628 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_MULTI_BUFFER_HPP
+#define BOOST_BUFFERS_MULTI_BUFFER_HPP
+
+#include <boost/buffers/detail/config.hpp>
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/const_buffer_span.hpp>
+#include <boost/buffers/mutable_buffer_span.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <boost/assert.hpp>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+#include <memory_resource>
+#endif
+
+namespace boost {
+namespace buffers {
+
+/** A dynamic buffer made from a chain of blocks.
+
+    Storage is allocated in blocks of a fixed
+    size. @ref prepare appends blocks to the
+    chain and @ref consume returns blocks to the
+    allocator as soon as all of their bytes are
+    read, so the readable bytes are never moved
+    or copied.
+
+    The buffer sequences returned by @ref data
+    and @ref prepare are spans with one element
+    for each block they touch. Their prefixes
+    and suffixes are of type
+    @ref const_buffer_subspan and
+    @ref mutable_buffer_subspan.
+
+    Blocks holding readable bytes can be moved
+    from one buffer to another with @ref splice,
+    at a cost proportional to the number of
+    blocks rather than the number of bytes.
+
+    @tparam Allocator The allocator used to obtain
+    blocks. It is rebound to `unsigned char`.
+*/
+template<
+    class Allocator = std::allocator<unsigned char>>
+class basic_multi_buffer
+{
+    using alloc_type = typename
+        std::allocator_traits<Allocator>::
+            template rebind_alloc<unsigned char>;
+
+    using alloc_traits =
+        std::allocator_traits<alloc_type>;
+
+    template<class T>
+    using vector_type = std::vector<T, typename
+        std::allocator_traits<Allocator>::
+            template rebind_alloc<T>>;
+
+    // The chain holds, for each block, its
+    // storage and its readable bytes. Blocks
+    // in [first_, end_) are readable, and
+    // blocks past end_ are empty spares.
+    alloc_type alloc_;
+    vector_type<unsigned char*> base_;
+    vector_type<const_buffer> in_;
+    vector_type<mutable_buffer> out_;
+    std::size_t first_ = 0;
+    std::size_t end_ = 0;
+    std::size_t size_ = 0;
+    std::size_t out_size_ = 0;
+    std::size_t block_size_;
+    std::size_t max_;
+
+public:
+    using allocator_type = Allocator;
+
+    using const_buffers_type =
+        const_buffer_span;
+
+    using mutable_buffers_type =
+        mutable_buffer_span;
+
+    /** The block size used when none is specified.
+    */
+    static constexpr std::size_t
+        default_block_size = 4096;
+
+    /** Destructor.
+    */
+    ~basic_multi_buffer()
+    {
+        clear_blocks();
+    }
+
+    /** Constructor.
+    */
+    basic_multi_buffer()
+        : block_size_(default_block_size)
+        , max_(std::size_t(-1))
+    {
+    }
+
+    /** Constructor.
+
+        @param alloc The allocator to use.
+    */
+    explicit
+    basic_multi_buffer(
+        Allocator const& alloc)
+        : alloc_(alloc)
+        , base_(alloc)
+        , in_(alloc)
+        , out_(alloc)
+        , block_size_(default_block_size)
+        , max_(std::size_t(-1))
+    {
+    }
+
+    /** Constructor.
+
+        @param max_size The largest size the
+        buffer is permitted to grow to.
+
+        @param block_size The size of each block.
+
+        @param alloc The allocator to use.
+
+        @throws std::invalid_argument
+        `block_size == 0`
+    */
+    explicit
+    basic_multi_buffer(
+        std::size_t max_size,
+        std::size_t block_size = default_block_size,
+        Allocator const& alloc = Allocator())
+        : alloc_(alloc)
+        , base_(alloc)
+        , in_(alloc)
+        , out_(alloc)
+        , block_size_(block_size)
+        , max_(max_size)
+    {
+        if(block_size_ == 0)
+            detail::throw_invalid_argument();
+    }
+
+    /** Constructor.
+
+        The readable bytes are copied.
+    */
+    basic_multi_buffer(
+        basic_multi_buffer const& other)
+        : alloc_(alloc_traits::
+            select_on_container_copy_construction(
+                other.alloc_))
+        , base_(alloc_)
+        , in_(alloc_)
+        , out_(alloc_)
+        , block_size_(other.block_size_)
+        , max_(other.max_)
+    {
+        commit(buffer_copy(
+            prepare(other.size()),
+            other.data()));
+    }
+
+    /** Constructor.
+
+        Ownership of the blocks is transferred,
+        leaving `other` empty.
+    */
+    basic_multi_buffer(
+        basic_multi_buffer&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , base_(std::move(other.base_))
+        , in_(std::move(other.in_))
+        , out_(std::move(other.out_))
+        , first_(other.first_)
+        , end_(other.end_)
+        , size_(other.size_)
+        , out_size_(other.out_size_)
+        , block_size_(other.block_size_)
+        , max_(other.max_)
+    {
+        other.base_.clear();
+        other.in_.clear();
+        other.out_.clear();
+        other.first_ = 0;
+        other.end_ = 0;
+        other.size_ = 0;
+        other.out_size_ = 0;
+    }
+
+    /** Assignment.
+
+        The readable bytes are copied.
+    */
+    basic_multi_buffer&
+    operator=(
+        basic_multi_buffer const& other)
+    {
+        if(this == &other)
+            return *this;
+        consume(size_);
+        if(block_size_ != other.block_size_)
+        {
+            clear_blocks();
+            block_size_ = other.block_size_;
+        }
+        max_ = other.max_;
+        commit(buffer_copy(
+            prepare(other.size()),
+            other.data()));
+        return *this;
+    }
+
+    /** Assignment.
+
+        The blocks are transferred when the
+        allocators allow it, otherwise the
+        readable bytes are copied.
+    */
+    basic_multi_buffer&
+    operator=(
+        basic_multi_buffer&& other)
+    {
+        if(this == &other)
+            return *this;
+        if(! alloc_traits::
+            propagate_on_container_move_assignment::value &&
+            alloc_ != other.alloc_)
+        {
+            *this = static_cast<
+                basic_multi_buffer const&>(other);
+            other.consume(other.size_);
+            return *this;
+        }
+        clear_blocks();
+        move_alloc(other, std::integral_constant<bool,
+            alloc_traits::
+                propagate_on_container_move_assignment::value>{});
+        base_ = std::move(other.base_);
+        in_ = std::move(other.in_);
+        out_ = std::move(other.out_);
+        first_ = other.first_;
+        end_ = other.end_;
+        size_ = other.size_;
+        out_size_ = other.out_size_;
+        block_size_ = other.block_size_;
+        max_ = other.max_;
+        other.base_.clear();
+        other.in_.clear();
+        other.out_.clear();
+        other.first_ = 0;
+        other.end_ = 0;
+        other.size_ = 0;
+        other.out_size_ = 0;
+        return *this;
+    }
+
+    /** Return the allocator.
+    */
+    allocator_type
+    get_allocator() const noexcept
+    {
+        return allocator_type(alloc_);
+    }
+
+    /** Return the size of each block.
+    */
+    std::size_t
+    block_size() const noexcept
+    {
+        return block_size_;
+    }
+
+    /** Return the number of blocks in the chain.
+
+        This includes spare blocks which hold
+        no readable bytes.
+    */
+    std::size_t
+    blocks() const noexcept
+    {
+        return base_.size() - first_;
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    std::size_t
+    max_size() const noexcept
+    {
+        return max_;
+    }
+
+    /** Return the number of bytes writable without allocating.
+    */
+    std::size_t
+    capacity() const noexcept
+    {
+        return tail_space() +
+            (base_.size() - end_) * block_size_;
+    }
+
+    const_buffers_type
+    data() const noexcept
+    {
+        return { in_.data() + first_,
+            end_ - first_ };
+    }
+
+    /** Return writable space, appending blocks if needed.
+
+        @throws std::length_error
+        `size() + n > max_size()`
+    */
+    mutable_buffers_type
+    prepare(std::size_t n)
+    {
+        if(n > max_ - size_)
+            detail::throw_length_error();
+
+        // append spare blocks
+        auto const tail = tail_space();
+        auto const spare = base_.size() - end_;
+        if(n > tail + spare * block_size_)
+        {
+            auto const more =
+                (n - tail - spare * block_size_ +
+                    block_size_ - 1) / block_size_;
+            reserve_chain(base_.size() + more);
+            for(std::size_t i = 0; i < more; ++i)
+            {
+                auto const p = alloc_traits::allocate(
+                    alloc_, block_size_);
+                base_.push_back(p);
+                in_.push_back(const_buffer(p, 0));
+            }
+        }
+
+        out_.clear();
+        out_.reserve(
+            base_.size() - end_ + 1);
+        out_size_ = n;
+        if(tail > 0 && n > 0)
+        {
+            auto const& b = in_[end_ - 1];
+            auto const k = n < tail ? n : tail;
+            out_.push_back(mutable_buffer(
+                const_cast<unsigned char*>(
+                    static_cast<unsigned char const*>(
+                        b.data())) + b.size(), k));
+            n -= k;
+        }
+        for(auto i = end_; n > 0; ++i)
+        {
+            auto const k = n < block_size_
+                ? n : block_size_;
+            out_.push_back(
+                mutable_buffer(base_[i], k));
+            n -= k;
+        }
+        return { out_.data(), out_.size() };
+    }
+
+    void
+    commit(std::size_t n) noexcept
+    {
+        if(n > out_size_)
+            n = out_size_;
+        out_size_ = 0;
+        size_ += n;
+        auto const tail = tail_space();
+        if(tail > 0 && n > 0)
+        {
+            auto& b = in_[end_ - 1];
+            auto const k = n < tail ? n : tail;
+            b = const_buffer(b.data(), b.size() + k);
+            n -= k;
+        }
+        while(n > 0)
+        {
+            auto const k = n < block_size_
+                ? n : block_size_;
+            in_[end_] = const_buffer(base_[end_], k);
+            ++end_;
+            n -= k;
+        }
+    }
+
+    void
+    consume(std::size_t n) noexcept
+    {
+        while(first_ < end_)
+        {
+            auto& b = in_[first_];
+            if(n < b.size())
+            {
+                b += n;
+                size_ -= n;
+                break;
+            }
+            n -= b.size();
+            size_ -= b.size();
+            if(first_ + 1 == end_)
+            {
+                // keep the last block for writing
+                b = const_buffer(base_[first_], 0);
+                --end_;
+                break;
+            }
+            alloc_traits::deallocate(
+                alloc_, base_[first_], block_size_);
+            base_[first_] = nullptr;
+            ++first_;
+        }
+        compact();
+    }
+
+    /** Move the readable bytes of another buffer to the end of this one.
+
+        When both buffers have the same block size
+        and equal allocators, the blocks holding the
+        readable bytes are moved without copying,
+        and the unused space in the last readable
+        block of this buffer is no longer writable.
+        Otherwise the bytes are copied. Afterwards
+        `other.size() == 0`.
+
+        @throws std::length_error
+        `size() + other.size() > max_size()`
+    */
+    void
+    splice(basic_multi_buffer& other)
+    {
+        if(this == &other || other.size_ == 0)
+            return;
+        if(other.size_ > max_ - size_)
+            detail::throw_length_error();
+        if( block_size_ != other.block_size_ ||
+            alloc_ != other.alloc_)
+        {
+            commit(buffer_copy(
+                prepare(other.size_),
+                other.data()));
+            other.consume(other.size_);
+            return;
+        }
+
+        // nothing below throws once both
+        // chains have room for the blocks
+        auto const n = other.end_ - other.first_;
+        reserve_chain(base_.size() + n);
+
+        // each moved block takes the place of
+        // a spare, which goes to the back
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            auto const j = other.first_ + i;
+            if(end_ < base_.size())
+            {
+                base_.push_back(base_[end_]);
+                in_.push_back(in_[end_]);
+                base_[end_] = other.base_[j];
+                in_[end_] = other.in_[j];
+            }
+            else
+            {
+                base_.push_back(other.base_[j]);
+                in_.push_back(other.in_[j]);
+            }
+            ++end_;
+        }
+        size_ += other.size_;
+        out_size_ = 0;
+
+        // the last spares of other
+        // fill the hole left behind
+        auto const spare =
+            other.base_.size() - other.end_;
+        auto const k = spare < n ? spare : n;
+        for(std::size_t i = 0; i < k; ++i)
+        {
+            auto const from =
+                other.base_.size() - 1 - i;
+            other.base_[other.first_ + i] =
+                other.base_[from];
+            other.in_[other.first_ + i] =
+                other.in_[from];
+        }
+        other.base_.resize(other.base_.size() - n);
+        other.in_.resize(other.in_.size() - n);
+        other.end_ = other.first_;
+        other.size_ = 0;
+        other.out_size_ = 0;
+    }
+
+    /** Release the spare blocks.
+    */
+    void
+    shrink_to_fit() noexcept
+    {
+        for(auto i = end_; i < base_.size(); ++i)
+            alloc_traits::deallocate(
+                alloc_, base_[i], block_size_);
+        base_.resize(end_);
+        in_.resize(end_);
+        out_.clear();
+        out_size_ = 0;
+    }
+
+private:
+    void
+    move_alloc(
+        basic_multi_buffer& other,
+        std::true_type) noexcept
+    {
+        alloc_ = std::move(other.alloc_);
+    }
+
+    void
+    move_alloc(
+        basic_multi_buffer&,
+        std::false_type) noexcept
+    {
+    }
+
+    // make room for n blocks in both
+    // vectors, growing geometrically
+    void
+    reserve_chain(std::size_t n)
+    {
+        if(n <= base_.capacity() &&
+            n <= in_.capacity())
+            return;
+        auto const want =
+            n < 2 * base_.size()
+                ? 2 * base_.size() : n;
+        base_.reserve(want);
+        in_.reserve(want);
+    }
+
+    // writable bytes at the end
+    // of the last readable block
+    std::size_t
+    tail_space() const noexcept
+    {
+        if(end_ == first_)
+            return 0;
+        auto const& b = in_[end_ - 1];
+        return block_size_ - static_cast<
+            std::size_t>(static_cast<
+                unsigned char const*>(b.data()) +
+                    b.size() - base_[end_ - 1]);
+    }
+
+    // drop released blocks from the front
+    // once they are half of the chain
+    void
+    compact() noexcept
+    {
+        if(first_ == 0 ||
+            first_ * 2 < base_.size())
+            return;
+        base_.erase(base_.begin(),
+            base_.begin() + first_);
+        in_.erase(in_.begin(),
+            in_.begin() + first_);
+        end_ -= first_;
+        first_ = 0;
+    }
+
+    void
+    clear_blocks() noexcept
+    {
+        for(auto i = first_; i < base_.size(); ++i)
+            alloc_traits::deallocate(
+                alloc_, base_[i], block_size_);
+        base_.clear();
+        in_.clear();
+        out_.clear();
+        first_ = 0;
+        end_ = 0;
+        size_ = 0;
+        out_size_ = 0;
+    }
+};
+
+template<class Allocator>
+constexpr std::size_t
+basic_multi_buffer<Allocator>::default_block_size;
+
+/** A multi buffer using the default allocator.
+*/
+using multi_buffer =
+    basic_multi_buffer<>;
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+namespace pmr {
+
+/** A multi buffer using a polymorphic allocator.
+*/
+using multi_buffer =
+    basic_multi_buffer<
+        std::pmr::polymorphic_allocator<unsigned char>>;
+
+} // pmr
+#endif
+
+} // buffers
+} // boost
+
+#endif
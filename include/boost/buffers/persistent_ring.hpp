@@ -0,0 +1,216 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_PERSISTENT_RING_HPP
+#define BOOST_BUFFERS_PERSISTENT_RING_HPP
+
+#include <boost/buffers/detail/config.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/const_buffer_pair.hpp>
+#include <boost/buffers/mutable_buffer_pair.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace boost {
+namespace buffers {
+
+namespace detail {
+struct persistent_ring_header;
+} // detail
+
+/** A circular buffer whose storage is a mapped file.
+
+    The file holds a header page followed by
+    the storage, and is mapped shared, so the
+    readable bytes outlive the process. When a
+    ring is opened again, @ref data returns
+    exactly the bytes committed and not yet
+    consumed, with the same buffer pair shapes
+    as @ref circular_buffer.
+
+    The position and length of the readable
+    bytes are kept in two checksummed slots in
+    the header. @ref commit and @ref consume
+    write the slot not holding the current
+    state, storing its sequence number last
+    with release ordering, after the bytes
+    themselves. A process which dies part way
+    through leaves that slot with a bad
+    checksum, and the ring is recovered from
+    the other one.
+
+    A process crash loses nothing committed.
+    Surviving a power failure requires the
+    dirty pages to reach the disk, which
+    @ref sync does with `msync`, the storage
+    first and then the header. Calling it
+    once per batch of commits bounds the bytes
+    at risk to the last batch. Until then, the
+    header written back by the kernel may
+    describe bytes whose storage was not.
+
+    @par Example
+    @code
+    persistent_ring log("events.ring", 1 << 20);
+    for(auto const& ev : batch)
+        log.commit(buffer_copy(
+            log.prepare(buffer_size(ev)), ev));
+    log.sync();
+    @endcode
+*/
+class persistent_ring
+{
+    int fd_ = -1;
+    detail::persistent_ring_header* h_ = nullptr;
+    unsigned char* base_ = nullptr;
+    std::size_t cap_ = 0;
+    std::size_t map_size_ = 0;
+    std::size_t in_pos_ = 0;
+    std::size_t in_len_ = 0;
+    std::size_t out_size_ = 0;
+    std::uint64_t seq_ = 0;
+
+    // committed since the last sync
+    std::size_t dirty_ = 0;
+
+public:
+    using const_buffers_type =
+        const_buffer_pair;
+
+    using mutable_buffers_type =
+        mutable_buffer_pair;
+
+    /** Destructor.
+
+        The file is unmapped and closed
+        without calling @ref sync.
+    */
+    BOOST_BUFFERS_DECL
+    ~persistent_ring();
+
+    /** Constructor.
+
+        Opens the ring stored in the file, or
+        creates and formats it if the file does
+        not exist or is empty.
+
+        @param path The path of the file.
+
+        @param capacity The size of the storage,
+        which must match that of an existing ring.
+
+        @throws system_error if the file cannot
+        be opened, sized or mapped.
+
+        @throws std::invalid_argument if the
+        capacity is zero, the file holds a ring
+        of another capacity, or neither slot of
+        the header is valid.
+    */
+    BOOST_BUFFERS_DECL
+    persistent_ring(
+        char const* path,
+        std::size_t capacity);
+
+    /** Constructor.
+    */
+    persistent_ring(persistent_ring const&) = delete;
+
+    /** Assignment.
+    */
+    persistent_ring& operator=(persistent_ring const&) = delete;
+
+    /** Return the number of readable bytes.
+    */
+    std::size_t
+    size() const noexcept
+    {
+        return in_len_;
+    }
+
+    /** Return the size of the storage.
+    */
+    std::size_t
+    max_size() const noexcept
+    {
+        return cap_;
+    }
+
+    /** Return the number of writable bytes.
+    */
+    std::size_t
+    capacity() const noexcept
+    {
+        return cap_ - in_len_;
+    }
+
+    /** Return the number of state changes recorded.
+
+        This increases by one for each call to
+        @ref commit or @ref consume which changes
+        the readable bytes, across reopenings.
+    */
+    std::uint64_t
+    sequence() const noexcept
+    {
+        return seq_;
+    }
+
+    BOOST_BUFFERS_DECL
+    const_buffers_type
+    data() const noexcept;
+
+    /** Return writable space.
+
+        @throws std::length_error `n > capacity()`
+    */
+    BOOST_BUFFERS_DECL
+    mutable_buffers_type
+    prepare(std::size_t n);
+
+    /** Append bytes and record the new state.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    commit(std::size_t n) noexcept;
+
+    /** Remove bytes and record the new state.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    consume(std::size_t n) noexcept;
+
+    /** Write the committed state to the disk.
+
+        The storage pages holding bytes
+        committed since the last call, then the
+        header page, are written with `msync`.
+
+        @throws system_error on failure.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    sync();
+
+private:
+    void publish() noexcept;
+    void msync_storage(
+        std::size_t pos,
+        std::size_t n);
+    void release() noexcept;
+};
+
+} // buffers
+} // boost
+
+#endif
+
+#endif
@@ -0,0 +1,249 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_PINNED_POOL_HPP
+#define BOOST_BUFFERS_PINNED_POOL_HPP
+
+#include <boost/buffers/detail/config.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/mutable_buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace boost {
+namespace buffers {
+
+/** A pool of page-aligned blocks faulted in ahead of use.
+
+    All of the blocks are carved from one anonymous
+    mapping made at construction. Every page of it
+    is written before the constructor returns, so
+    the first touch of a block on a latency-critical
+    path does not take a page fault. Optionally the
+    mapping is also locked with `mlock`, so that
+    the pages are not reclaimed or swapped out later.
+
+    Blocks are plain memory, over which the
+    fixed-capacity buffers are constructed:
+
+    @code
+    pinned_pool pool;
+    mutable_buffer b = pool.allocate();
+    flat_buffer fb(b);
+    circular_buffer cb(b.data(), b.size());
+    @endcode
+
+    The page faults taken by the calling thread
+    are recorded just before the mapping is made
+    and again after the warm-up, and reported by
+    @ref stats. @ref page_faults reads the same
+    counters at any time, so a caller can confirm
+    that the hot path takes none.
+
+    Allocation and deallocation never call into the
+    system, and take constant time.
+
+    @par Thread Safety
+    Distinct objects: Safe.@n
+    Shared objects: Unsafe.
+*/
+class pinned_pool
+{
+public:
+    /** Options for constructing a pool.
+    */
+    struct options
+    {
+        /** The size of each block.
+
+            This is rounded up to a whole
+            number of pages.
+        */
+        std::size_t block_size = 64 * 1024;
+
+        /** The number of blocks.
+        */
+        std::size_t blocks = 16;
+
+        /** Whether to lock the blocks into memory.
+
+            If `mlock` fails, for example because
+            the limit on locked memory is too low,
+            the pool is still usable, and
+            @ref locked returns `false`.
+        */
+        bool lock = false;
+    };
+
+    /** Page fault counts of a thread.
+    */
+    struct fault_counts
+    {
+        /** Faults served without reading from disk.
+        */
+        std::uint64_t minor = 0;
+
+        /** Faults which required reading from disk.
+        */
+        std::uint64_t major = 0;
+    };
+
+    /** Counters describing a pool.
+    */
+    struct stats_type
+    {
+        /** Blocks which may be allocated.
+        */
+        std::size_t blocks_free = 0;
+
+        /** Blocks allocated and not yet deallocated.
+        */
+        std::size_t blocks_in_use = 0;
+
+        /** Bytes mapped by the pool.
+        */
+        std::size_t bytes_mapped = 0;
+
+        /** Whether the mapping is locked into memory.
+        */
+        bool locked = false;
+
+        /** Faults taken by the constructing thread before warm-up.
+        */
+        fault_counts before_warmup;
+
+        /** Faults taken by the constructing thread after warm-up.
+        */
+        fault_counts after_warmup;
+    };
+
+    /** Return the page faults taken so far by the calling thread.
+
+        Where per-thread counts are not available,
+        the counts of the process are returned.
+    */
+    BOOST_BUFFERS_DECL
+    static
+    fault_counts
+    page_faults() noexcept;
+
+    /** Destructor.
+
+        @par Preconditions
+        Every block allocated from the pool
+        has been deallocated.
+    */
+    BOOST_BUFFERS_DECL
+    ~pinned_pool();
+
+    /** Constructor.
+    */
+    BOOST_BUFFERS_DECL
+    pinned_pool();
+
+    /** Constructor.
+
+        @throws std::invalid_argument if the block
+        size or the number of blocks is zero.
+
+        @throws std::bad_alloc if the size of the
+        pool overflows.
+
+        @throws system_error if the mapping fails.
+    */
+    BOOST_BUFFERS_DECL
+    explicit
+    pinned_pool(options const& opt);
+
+    /** Constructor.
+    */
+    pinned_pool(pinned_pool const&) = delete;
+
+    /** Assignment.
+    */
+    pinned_pool& operator=(pinned_pool const&) = delete;
+
+    /** Return the size of each block.
+    */
+    std::size_t
+    block_size() const noexcept
+    {
+        return block_;
+    }
+
+    /** Return the number of blocks.
+    */
+    std::size_t
+    capacity() const noexcept
+    {
+        return n_;
+    }
+
+    /** Return the number of blocks which may be allocated.
+    */
+    std::size_t
+    available() const noexcept
+    {
+        return free_.size();
+    }
+
+    /** Return whether the blocks are locked into memory.
+    */
+    bool
+    locked() const noexcept
+    {
+        return locked_;
+    }
+
+    /** Allocate a block.
+
+        The block is aligned to the page size,
+        and its size is @ref block_size.
+
+        @throws std::bad_alloc if every
+        block is in use.
+    */
+    BOOST_BUFFERS_DECL
+    mutable_buffer
+    allocate();
+
+    /** Deallocate a block.
+
+        @param p The start of a block returned
+        by @ref allocate on this pool.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    deallocate(void* p) noexcept;
+
+    /** Return the counters.
+    */
+    BOOST_BUFFERS_DECL
+    stats_type
+    stats() const noexcept;
+
+private:
+    unsigned char* base_ = nullptr;
+    std::size_t block_;
+    std::size_t n_;
+    bool locked_ = false;
+    std::vector<std::size_t> free_;
+    fault_counts before_;
+    fault_counts after_;
+};
+
+} // buffers
+} // boost
+
+#endif
+
+#endif
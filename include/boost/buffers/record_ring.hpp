@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_RECORD_RING_HPP
+#define BOOST_BUFFERS_RECORD_RING_HPP
+
+#include <boost/buffers/detail/config.hpp>
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/buffer_size.hpp>
+#include <boost/buffers/circular_buffer.hpp>
+#include <boost/buffers/const_buffer_pair.hpp>
+#include <boost/buffers/mutable_buffer_pair.hpp>
+#include <boost/buffers/type_traits.hpp>
+#include <cstdint>
+
+namespace boost {
+namespace buffers {
+
+/** A circular buffer of variable-length records.
+
+    Each record is stored in a @ref circular_buffer
+    as a four byte length header followed by
+    the payload. Headers and payloads may wrap
+    around the end of the storage; this is
+    handled internally, and @ref front returns
+    the payload of the oldest record as a
+    buffer pair without copying.
+
+    @par Example
+    @code
+    char storage[4096];
+    record_ring rr(storage, sizeof(storage));
+    rr.push(make_buffer("hello", 5));
+
+    const_buffer bufs[16];
+    auto const g = rr.gather(bufs, 16);
+    // ... writev(fd, bufs, g.buffers) ...
+    rr.pop(g.records);
+    @endcode
+*/
+class record_ring
+{
+    circular_buffer cb_;
+    std::size_t count_ = 0;
+
+public:
+    /** The size of the length header.
+    */
+    static constexpr std::size_t header_size =
+        sizeof(std::uint32_t);
+
+    /** The result of @ref gather.
+    */
+    struct gather_result
+    {
+        /** The number of records gathered.
+        */
+        std::size_t records;
+
+        /** The number of buffers written.
+        */
+        std::size_t buffers;
+
+        /** The number of payload bytes gathered.
+        */
+        std::size_t bytes;
+    };
+
+    /** Constructor.
+    */
+    record_ring() = default;
+
+    /** Constructor.
+    */
+    record_ring(
+        void* base,
+        std::size_t capacity) noexcept
+        : cb_(base, capacity)
+    {
+    }
+
+    /** Constructor.
+    */
+    record_ring(
+        record_ring const&) = default;
+
+    /** Assignment.
+    */
+    record_ring& operator=(
+        record_ring const&) = default;
+
+    /** Return the number of records.
+    */
+    std::size_t
+    size() const noexcept
+    {
+        return count_;
+    }
+
+    /** Return true if there are no records.
+    */
+    bool
+    empty() const noexcept
+    {
+        return count_ == 0;
+    }
+
+    /** Return the number of bytes in use, including headers.
+    */
+    std::size_t
+    bytes() const noexcept
+    {
+        return cb_.size();
+    }
+
+    /** Return the size of the storage in bytes.
+    */
+    std::size_t
+    max_size() const noexcept
+    {
+        return cb_.max_size();
+    }
+
+    /** Return true if a record of the given size may be pushed.
+    */
+    bool
+    fits(std::size_t n) const noexcept
+    {
+        auto const cap = cb_.capacity();
+        return
+            n <= max_record_size() &&
+            n <= cap &&
+            cap - n >= header_size;
+    }
+
+    /** Return the largest payload which may be pushed.
+
+        When this returns zero, use @ref fits
+        to determine if an empty record may
+        still be pushed.
+    */
+    std::size_t
+    available() const noexcept
+    {
+        auto n = cb_.capacity();
+        if(n <= header_size)
+            return 0;
+        n -= header_size;
+        if(n > max_record_size())
+            return max_record_size();
+        return n;
+    }
+
+    /** Return the largest payload representable in a header.
+    */
+    static
+    constexpr
+    std::size_t
+    max_record_size() noexcept
+    {
+        return std::uint32_t(-1);
+    }
+
+    /** Append a record.
+
+        The bytes in the buffer sequence are
+        copied into the ring as one record.
+
+        @throws std::length_error
+        `! fits(buffer_size(bs))`
+    */
+    template<class ConstBufferSequence>
+    void
+    push(ConstBufferSequence const& bs)
+    {
+        static_assert(
+            is_const_buffer_sequence<
+                ConstBufferSequence>::value,
+            "Type requirements not met");
+
+        auto const n = buffer_size(bs);
+        buffer_copy(prepare(n), bs);
+        commit(n);
+    }
+
+    /** Return the payload of the oldest record.
+
+        @par Preconditions
+        `! empty()`
+    */
+    BOOST_BUFFERS_DECL
+    const_buffer_pair
+    front() const noexcept;
+
+    /** Remove the oldest records.
+
+        @param k The number of records to
+        remove. If this is greater than
+        @ref size, all records are removed.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    pop(std::size_t k = 1) noexcept;
+
+    /** Gather the oldest records into a buffer list.
+
+        The payloads of up to `k` records are
+        written to `dest` in order, each taking
+        one buffer, or two when it wraps, so the
+        list may be passed to a single `writev`.
+        Only whole records are gathered. The
+        records are not removed; call @ref pop
+        with the number of records written.
+
+        @param dest The list to fill.
+
+        @param n The number of elements in `dest`.
+
+        @param k The maximum number of records.
+    */
+    BOOST_BUFFERS_DECL
+    gather_result
+    gather(
+        const_buffer* dest,
+        std::size_t n,
+        std::size_t k = std::size_t(-1)) const noexcept;
+
+private:
+    BOOST_BUFFERS_DECL
+    mutable_buffer_pair
+    prepare(std::size_t n);
+
+    BOOST_BUFFERS_DECL
+    void
+    commit(std::size_t n) noexcept;
+};
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,235 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_RING_WAITER_HPP
+#define BOOST_BUFFERS_RING_WAITER_HPP
+
+#include <boost/buffers/detail/config.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#if defined(BOOST_MSVC) && (defined(_M_IX86) || defined(_M_X64))
+# include <intrin.h>
+#endif
+
+namespace boost {
+namespace buffers {
+
+/** Options controlling how a @ref ring_waiter blocks.
+*/
+struct wait_options
+{
+    /** Time spent spinning before yielding.
+    */
+    std::chrono::nanoseconds spin_time =
+        std::chrono::microseconds(20);
+
+    /** Number of yields before parking.
+    */
+    std::size_t yield_count = 16;
+
+    /** Maximum time spent parked.
+
+        When this elapses without the predicate
+        being satisfied, @ref ring_waiter::wait
+        returns `false`. The default waits
+        indefinitely.
+    */
+    std::chrono::nanoseconds park_timeout =
+        (std::chrono::nanoseconds::max)();
+};
+
+/** A wait/notify word for ring buffers.
+
+    A consumer which finds its ring empty, or
+    a producer which finds it full, calls
+    @ref wait with a predicate. The waiter
+    spins for a bounded time, then yields the
+    processor, and finally parks the thread
+    on a futex keyed on the internal 32-bit
+    word. The other side calls @ref notify
+    after it publishes its index.
+
+    @ref notify only issues the wake system
+    call when a waiter is known to be parked,
+    so an uncontended notification costs one
+    atomic increment and one load.
+
+    Objects of this type contain no pointers
+    and may be placed in memory shared between
+    processes.
+
+    @par Thread Safety
+    Any number of threads may call @ref wait
+    and @ref notify concurrently.
+
+    @note On platforms without futexes, parked
+    threads sleep briefly and poll instead.
+*/
+class ring_waiter
+{
+    std::atomic<std::uint32_t> word_{0};
+    std::atomic<std::uint32_t> parked_{0};
+
+public:
+    /** Constructor.
+    */
+    ring_waiter() = default;
+
+    /** Constructor.
+    */
+    ring_waiter(
+        ring_waiter const&) = delete;
+
+    /** Assignment.
+    */
+    ring_waiter& operator=(
+        ring_waiter const&) = delete;
+
+    /** Return the number of parked waiters.
+    */
+    std::size_t
+    parked() const noexcept
+    {
+        return parked_.load(
+            std::memory_order_relaxed);
+    }
+
+    /** Block until a predicate is satisfied.
+
+        The predicate is called repeatedly and
+        must observe the ring's indices with
+        acquire semantics.
+
+        @param pred A nullary function returning
+        `true` once the caller may proceed.
+
+        @param opt The spinning and yielding
+        budget used before parking.
+
+        @return `true` if the predicate was
+        satisfied, or `false` if the park
+        timeout elapsed first.
+    */
+    template<class Predicate>
+    bool
+    wait(
+        Predicate pred,
+        wait_options const& opt = {})
+    {
+        if(pred())
+            return true;
+
+        // spin
+        auto const until =
+            std::chrono::steady_clock::now() +
+            opt.spin_time;
+        for(std::size_t i = 1;; ++i)
+        {
+            relax();
+            if(pred())
+                return true;
+            if( (i % 64) == 0 &&
+                std::chrono::steady_clock::now() >=
+                    until)
+                break;
+        }
+
+        // yield
+        for(std::size_t i = 0;
+            i < opt.yield_count; ++i)
+        {
+            std::this_thread::yield();
+            if(pred())
+                return true;
+        }
+
+        // park
+        bool const timed = opt.park_timeout !=
+            (std::chrono::nanoseconds::max)();
+        auto const deadline = timed
+            ? std::chrono::steady_clock::now() +
+                opt.park_timeout
+            : std::chrono::steady_clock::time_point();
+        for(;;)
+        {
+            auto timeout =
+                (std::chrono::nanoseconds::max)();
+            if(timed)
+            {
+                timeout = deadline -
+                    std::chrono::steady_clock::now();
+                if(timeout.count() <= 0)
+                    return pred();
+            }
+            auto const w = word_.load(
+                std::memory_order_seq_cst);
+            parked_.fetch_add(1,
+                std::memory_order_seq_cst);
+            if(pred())
+            {
+                parked_.fetch_sub(1,
+                    std::memory_order_relaxed);
+                return true;
+            }
+            park(w, timeout);
+            parked_.fetch_sub(1,
+                std::memory_order_relaxed);
+            if(pred())
+                return true;
+        }
+    }
+
+    /** Wake waiters after publishing an index.
+
+        @param all If `true`, every parked
+        waiter is woken, otherwise at most one.
+    */
+    void
+    notify(bool all = true) noexcept
+    {
+        word_.fetch_add(1,
+            std::memory_order_seq_cst);
+        if(parked_.load(
+            std::memory_order_seq_cst) != 0)
+            wake(all);
+    }
+
+private:
+    static
+    void
+    relax() noexcept
+    {
+#if defined(BOOST_MSVC) && (defined(_M_IX86) || defined(_M_X64))
+        _mm_pause();
+#elif defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    BOOST_BUFFERS_DECL
+    void
+    park(
+        std::uint32_t expected,
+        std::chrono::nanoseconds timeout) noexcept;
+
+    BOOST_BUFFERS_DECL
+    void
+    wake(bool all) noexcept;
+};
+
+} // buffers
+} // boost
+
+#endif
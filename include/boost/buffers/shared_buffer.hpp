@@ -0,0 +1,839 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_SHARED_BUFFER_HPP
+#define BOOST_BUFFERS_SHARED_BUFFER_HPP
+
+#include <boost/buffers/detail/config.hpp>
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/buffer_size.hpp>
+#include <boost/buffers/const_buffer.hpp>
+#include <boost/buffers/tag_invoke.hpp>
+#include <boost/buffers/type_traits.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <boost/assert.hpp>
+#include <atomic>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+#include <memory_resource>
+#endif
+
+namespace boost {
+namespace buffers {
+
+namespace detail {
+
+template<bool ThreadSafe>
+struct shared_block_count;
+
+template<>
+struct shared_block_count<true>
+{
+    std::atomic<std::size_t> n{1};
+
+    void
+    acquire() noexcept
+    {
+        n.fetch_add(1,
+            std::memory_order_relaxed);
+    }
+
+    bool
+    release() noexcept
+    {
+        return n.fetch_sub(1,
+            std::memory_order_acq_rel) == 1;
+    }
+
+    std::size_t
+    load() const noexcept
+    {
+        return n.load(
+            std::memory_order_relaxed);
+    }
+};
+
+template<>
+struct shared_block_count<false>
+{
+    std::size_t n = 1;
+
+    void
+    acquire() noexcept
+    {
+        ++n;
+    }
+
+    bool
+    release() noexcept
+    {
+        return --n == 0;
+    }
+
+    std::size_t
+    load() const noexcept
+    {
+        return n;
+    }
+};
+
+} // detail
+
+/** A reference-counted block of immutable bytes.
+
+    The bytes are copied in at construction and
+    never change afterwards. Copies of the block
+    share the same storage, which is released
+    when the last copy is destroyed.
+
+    The storage comes from the global heap, or
+    from an allocator given at construction. The
+    allocator is kept inside the block, so blocks
+    from different allocators have the same type.
+
+    @tparam ThreadSafe If `true`, the reference
+    count is atomic and copies may be made and
+    destroyed concurrently from different threads.
+    Otherwise every copy must be used from a
+    single thread at a time.
+
+    @see basic_shared_buffer
+*/
+template<bool ThreadSafe = true>
+class basic_shared_block
+{
+    struct impl
+    {
+        detail::shared_block_count<ThreadSafe> refs;
+        std::size_t size;
+
+        // null if from the global heap
+        void (*free)(impl*) = nullptr;
+    };
+
+    impl* p_ = nullptr;
+
+    // The allocator is stored after the bytes,
+    // and the whole is allocated in units of impl
+    template<class Alloc>
+    static
+    std::size_t
+    alloc_offset(std::size_t n) noexcept
+    {
+        return (sizeof(impl) + n + alignof(Alloc) - 1) /
+            alignof(Alloc) * alignof(Alloc);
+    }
+
+    template<class Alloc>
+    static
+    std::size_t
+    alloc_units(std::size_t n) noexcept
+    {
+        return (alloc_offset<Alloc>(n) + sizeof(Alloc) +
+            sizeof(impl) - 1) / sizeof(impl);
+    }
+
+    template<class Alloc>
+    static
+    Alloc*
+    stored_alloc(impl* p) noexcept
+    {
+        return reinterpret_cast<Alloc*>(
+            reinterpret_cast<unsigned char*>(p) +
+                alloc_offset<Alloc>(p->size));
+    }
+
+    template<class Alloc>
+    static
+    void
+    free_with(impl* p)
+    {
+        auto const a0 = stored_alloc<Alloc>(p);
+        Alloc a(std::move(*a0));
+        a0->~Alloc();
+        auto const units = alloc_units<Alloc>(p->size);
+        p->~impl();
+        std::allocator_traits<Alloc>::deallocate(
+            a, p, units);
+    }
+
+public:
+    /** Destructor.
+    */
+    ~basic_shared_block()
+    {
+        release();
+    }
+
+    /** Constructor.
+
+        The default constructed block is empty.
+    */
+    basic_shared_block() = default;
+
+    /** Constructor.
+
+        The bytes of the buffer sequence are
+        copied into a new block.
+    */
+    template<
+        class ConstBufferSequence
+        , class = typename std::enable_if<
+            is_const_buffer_sequence<
+                ConstBufferSequence>::value
+        >::type
+    >
+    explicit
+    basic_shared_block(
+        ConstBufferSequence const& bs)
+    {
+        auto const n = buffer_size(bs);
+        if(n == 0)
+            return;
+        if(n > std::size_t(-1) - sizeof(impl))
+            detail::throw_length_error();
+        p_ = ::new(::operator new(
+            sizeof(impl) + n)) impl;
+        p_->size = n;
+        buffer_copy(
+            mutable_buffer(p_ + 1, n), bs);
+    }
+
+    /** Constructor.
+
+        The bytes of the buffer sequence are
+        copied into a new block, whose storage
+        is obtained from `alloc`. A copy of the
+        allocator is kept in the block and used
+        to release it.
+    */
+    template<
+        class ConstBufferSequence
+        , class Allocator
+        , class = typename std::enable_if<
+            is_const_buffer_sequence<
+                ConstBufferSequence>::value
+        >::type
+    >
+    basic_shared_block(
+        ConstBufferSequence const& bs,
+        Allocator const& alloc)
+    {
+        using alloc_type = typename
+            std::allocator_traits<Allocator>::
+                template rebind_alloc<impl>;
+        using alloc_traits =
+            std::allocator_traits<alloc_type>;
+        static_assert(
+            alignof(alloc_type) <= alignof(impl),
+            "the allocator is overaligned");
+
+        auto const n = buffer_size(bs);
+        if(n == 0)
+            return;
+        if(n > std::size_t(-1) / 2)
+            detail::throw_length_error();
+        alloc_type a(alloc);
+        auto const p = alloc_traits::allocate(
+            a, alloc_units<alloc_type>(n));
+        p_ = ::new(p) impl;
+        p_->size = n;
+        p_->free = &free_with<alloc_type>;
+        ::new(stored_alloc<alloc_type>(p_))
+            alloc_type(std::move(a));
+        buffer_copy(
+            mutable_buffer(p_ + 1, n), bs);
+    }
+
+    /** Constructor.
+    */
+    basic_shared_block(
+        basic_shared_block const& other) noexcept
+        : p_(other.p_)
+    {
+        if(p_)
+            p_->refs.acquire();
+    }
+
+    /** Constructor.
+    */
+    basic_shared_block(
+        basic_shared_block&& other) noexcept
+        : p_(other.p_)
+    {
+        other.p_ = nullptr;
+    }
+
+    /** Assignment.
+    */
+    basic_shared_block&
+    operator=(
+        basic_shared_block const& other) noexcept
+    {
+        basic_shared_block tmp(other);
+        std::swap(p_, tmp.p_);
+        return *this;
+    }
+
+    /** Assignment.
+    */
+    basic_shared_block&
+    operator=(
+        basic_shared_block&& other) noexcept
+    {
+        basic_shared_block tmp(std::move(other));
+        std::swap(p_, tmp.p_);
+        return *this;
+    }
+
+    /** Return a pointer to the bytes.
+    */
+    void const*
+    data() const noexcept
+    {
+        if(p_)
+            return p_ + 1;
+        return nullptr;
+    }
+
+    /** Return the number of bytes.
+    */
+    std::size_t
+    size() const noexcept
+    {
+        if(p_)
+            return p_->size;
+        return 0;
+    }
+
+    /** Return the number of copies sharing the block.
+
+        When the block is shared between threads
+        the value is approximate.
+    */
+    std::size_t
+    use_count() const noexcept
+    {
+        if(p_)
+            return p_->refs.load();
+        return 0;
+    }
+
+    /** Return the bytes as a buffer.
+    */
+    const_buffer
+    buffer() const noexcept
+    {
+        return { data(), size() };
+    }
+
+private:
+    void
+    release() noexcept
+    {
+        if(p_ && p_->refs.release())
+        {
+            if(p_->free)
+            {
+                p_->free(p_);
+            }
+            else
+            {
+                p_->~impl();
+                ::operator delete(p_);
+            }
+        }
+        p_ = nullptr;
+    }
+};
+
+//------------------------------------------------
+
+/** A buffer which keeps its storage alive.
+
+    This refers to a range of bytes within a
+    @ref basic_shared_block, and holds a reference
+    to the block. It converts to @ref const_buffer,
+    and is itself a <em>ConstBufferSequence</em> of
+    length one, so it may be passed anywhere a
+    constant buffer sequence is accepted.
+
+    Copying a shared buffer copies the reference,
+    never the bytes.
+
+    @see basic_shared_buffers
+*/
+template<bool ThreadSafe = true>
+class basic_shared_buffer
+{
+    basic_shared_block<ThreadSafe> block_;
+    const_buffer b_;
+
+public:
+    /** The type of buffer.
+    */
+    using value_type = const_buffer;
+
+    /** The type of iterators returned.
+    */
+    using const_iterator = value_type const*;
+
+    /** The type of block referenced.
+    */
+    using block_type = basic_shared_block<ThreadSafe>;
+
+    /** Constructor.
+    */
+    basic_shared_buffer() = default;
+
+    /** Constructor.
+
+        The buffer refers to every byte of the block.
+    */
+    basic_shared_buffer(
+        block_type block) noexcept
+        : block_(std::move(block))
+        , b_(block_.buffer())
+    {
+    }
+
+    /** Constructor.
+
+        The buffer refers to `n` bytes of the
+        block, starting at offset `pos`.
+
+        @throws std::invalid_argument
+        `pos + n > block.size()`
+    */
+    basic_shared_buffer(
+        block_type block,
+        std::size_t pos,
+        std::size_t n)
+        : block_(std::move(block))
+    {
+        if( pos > block_.size() ||
+            n > block_.size() - pos)
+            detail::throw_invalid_argument();
+        b_ = const_buffer(static_cast<
+            unsigned char const*>(
+                block_.data()) + pos, n);
+    }
+
+    /** Return the block holding the bytes.
+    */
+    block_type const&
+    block() const noexcept
+    {
+        return block_;
+    }
+
+    void const*
+    data() const noexcept
+    {
+        return b_.data();
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return b_.size();
+    }
+
+    /** Return the bytes, without ownership.
+    */
+    operator const_buffer() const noexcept
+    {
+        return b_;
+    }
+
+    /** Return an iterator to the beginning.
+    */
+    const_iterator
+    begin() const noexcept
+    {
+        return &b_;
+    }
+
+    /** Return an iterator to the end.
+    */
+    const_iterator
+    end() const noexcept
+    {
+        return &b_ + 1;
+    }
+
+    /** Remove a prefix from the buffer.
+    */
+    basic_shared_buffer&
+    operator+=(std::size_t n) noexcept
+    {
+        b_ += n;
+        return *this;
+    }
+
+    /** Return the buffer with a prefix removed.
+    */
+    friend
+    basic_shared_buffer
+    operator+(
+        basic_shared_buffer b,
+        std::size_t n) noexcept
+    {
+        return b += n;
+    }
+
+    friend
+    basic_shared_buffer
+    tag_invoke(
+        prefix_tag const&,
+        basic_shared_buffer const& b,
+        std::size_t n) noexcept
+    {
+        auto r = b;
+        r.b_ = tag_invoke(
+            prefix_tag{}, b.b_, n);
+        return r;
+    }
+
+    friend
+    basic_shared_buffer
+    tag_invoke(
+        suffix_tag const&,
+        basic_shared_buffer const& b,
+        std::size_t n) noexcept
+    {
+        auto r = b;
+        r.b_ = tag_invoke(
+            suffix_tag{}, b.b_, n);
+        return r;
+    }
+};
+
+//------------------------------------------------
+
+/** A sequence of buffers which keeps its storage alive.
+
+    Each element refers to a range of bytes in a
+    @ref basic_shared_block and holds a reference
+    to it. Objects of this type meet the
+    requirements of <em>ConstBufferSequence</em>,
+    and iterate as plain @ref const_buffer values.
+
+    The prefix and suffix of a sequence are again
+    owning sequences, so they remain valid after
+    the original is destroyed.
+
+    @see basic_shared_buffer
+*/
+template<
+    bool ThreadSafe = true,
+    class Allocator = std::allocator<unsigned char>>
+class basic_shared_buffers
+{
+    using block_type =
+        basic_shared_block<ThreadSafe>;
+
+    template<class T>
+    using vector_type = std::vector<T, typename
+        std::allocator_traits<Allocator>::
+            template rebind_alloc<T>>;
+
+    vector_type<const_buffer> v_;
+    vector_type<block_type> blocks_;
+
+public:
+    using allocator_type = Allocator;
+
+    /** The type of buffer.
+    */
+    using value_type = const_buffer;
+
+    /** The type of iterators returned.
+    */
+    using const_iterator = value_type const*;
+
+    /** The type of element added to the sequence.
+    */
+    using buffer_type =
+        basic_shared_buffer<ThreadSafe>;
+
+    /** Constructor.
+    */
+    basic_shared_buffers() = default;
+
+    /** Constructor.
+
+        @param alloc The allocator used for the
+        sequence itself. The blocks keep their
+        own storage.
+    */
+    explicit
+    basic_shared_buffers(
+        Allocator const& alloc)
+        : v_(alloc)
+        , blocks_(alloc)
+    {
+    }
+
+    /** Constructor.
+    */
+    basic_shared_buffers(
+        std::initializer_list<buffer_type> init,
+        Allocator const& alloc = Allocator())
+        : v_(alloc)
+        , blocks_(alloc)
+    {
+        reserve(init.size());
+        for(auto const& b : init)
+            push_back(b);
+    }
+
+    /** Return the allocator.
+    */
+    allocator_type
+    get_allocator() const noexcept
+    {
+        return allocator_type(v_.get_allocator());
+    }
+
+    /** Return an iterator to the beginning.
+    */
+    const_iterator
+    begin() const noexcept
+    {
+        return v_.data();
+    }
+
+    /** Return an iterator to the end.
+    */
+    const_iterator
+    end() const noexcept
+    {
+        return v_.data() + v_.size();
+    }
+
+    /** Return true if the sequence has no buffers.
+    */
+    bool
+    empty() const noexcept
+    {
+        return v_.empty();
+    }
+
+    /** Return the number of buffers in the sequence.
+    */
+    std::size_t
+    length() const noexcept
+    {
+        return v_.size();
+    }
+
+    /** Return the buffer at position `i`.
+    */
+    buffer_type
+    operator[](std::size_t i) const noexcept
+    {
+        BOOST_ASSERT(i < v_.size());
+        auto const& blk = blocks_[i];
+        return buffer_type(blk,
+            static_cast<unsigned char const*>(
+                v_[i].data()) -
+            static_cast<unsigned char const*>(
+                blk.data()),
+            v_[i].size());
+    }
+
+    /** Reserve space for `n` buffers.
+    */
+    void
+    reserve(std::size_t n)
+    {
+        v_.reserve(n);
+        blocks_.reserve(n);
+    }
+
+    /** Append a buffer.
+
+        Empty buffers are not added.
+    */
+    void
+    push_back(buffer_type const& b)
+    {
+        if(b.size() == 0)
+            return;
+        blocks_.push_back(b.block());
+        try
+        {
+            v_.push_back(b);
+        }
+        catch(...)
+        {
+            blocks_.pop_back();
+            throw;
+        }
+    }
+
+    /** Append every buffer of another sequence.
+
+        The sequence may be appended to itself.
+    */
+    void
+    append(basic_shared_buffers const& other)
+    {
+        // reserve first and copy by index, so
+        // other may be *this, and nothing
+        // after the reserve throws
+        auto const nb = other.blocks_.size();
+        auto const nv = other.v_.size();
+        grow(blocks_, nb);
+        grow(v_, nv);
+        for(std::size_t i = 0; i < nb; ++i)
+            blocks_.push_back(other.blocks_[i]);
+        for(std::size_t i = 0; i < nv; ++i)
+            v_.push_back(other.v_[i]);
+    }
+
+    /** Remove bytes from the beginning.
+
+        Buffers which are removed entirely
+        release their reference.
+    */
+    void
+    consume(std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        while(i < v_.size() && n >= v_[i].size())
+        {
+            n -= v_[i].size();
+            ++i;
+        }
+        v_.erase(v_.begin(), v_.begin() + i);
+        blocks_.erase(blocks_.begin(),
+            blocks_.begin() + i);
+        if(! v_.empty())
+            v_.front() += n;
+    }
+
+    /** Remove every buffer.
+    */
+    void
+    clear() noexcept
+    {
+        v_.clear();
+        blocks_.clear();
+    }
+
+    friend
+    basic_shared_buffers
+    tag_invoke(
+        prefix_tag const&,
+        basic_shared_buffers const& bs,
+        std::size_t n)
+    {
+        basic_shared_buffers r(bs.get_allocator());
+        std::size_t i = 0;
+        while(i < bs.v_.size() && n > 0)
+        {
+            auto const b = tag_invoke(
+                prefix_tag{}, bs.v_[i], n);
+            r.v_.push_back(b);
+            r.blocks_.push_back(bs.blocks_[i]);
+            n -= b.size();
+            ++i;
+        }
+        return r;
+    }
+
+    friend
+    basic_shared_buffers
+    tag_invoke(
+        suffix_tag const&,
+        basic_shared_buffers const& bs,
+        std::size_t n)
+    {
+        auto i = bs.v_.size();
+        std::size_t k = 0;
+        while(i > 0 && k < n)
+            k += bs.v_[--i].size();
+        basic_shared_buffers r(bs.get_allocator());
+        r.reserve(bs.v_.size() - i);
+        r.v_.assign(
+            bs.v_.begin() + i, bs.v_.end());
+        r.blocks_.assign(
+            bs.blocks_.begin() + i, bs.blocks_.end());
+        if(k > n)
+            r.v_.front() += k - n;
+        return r;
+    }
+
+private:
+    // make room for n more elements,
+    // growing geometrically
+    template<class T>
+    static
+    void
+    grow(
+        vector_type<T>& v,
+        std::size_t n)
+    {
+        if(v.capacity() - v.size() >= n)
+            return;
+        auto want = v.size() + n;
+        if(want < 2 * v.size())
+            want = 2 * v.size();
+        v.reserve(want);
+    }
+};
+
+//------------------------------------------------
+
+/** A shared block with an atomic reference count.
+*/
+using shared_block = basic_shared_block<true>;
+
+/** A shared buffer with an atomic reference count.
+*/
+using shared_buffer = basic_shared_buffer<true>;
+
+/** A shared buffer sequence with an atomic reference count.
+*/
+using shared_buffers = basic_shared_buffers<true>;
+
+/** A shared block for use by a single thread.
+*/
+using local_shared_block = basic_shared_block<false>;
+
+/** A shared buffer for use by a single thread.
+*/
+using local_shared_buffer = basic_shared_buffer<false>;
+
+/** A shared buffer sequence for use by a single thread.
+*/
+using local_shared_buffers = basic_shared_buffers<false>;
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+namespace pmr {
+
+/** A shared buffer sequence using a polymorphic allocator.
+*/
+using shared_buffers = basic_shared_buffers<true,
+    std::pmr::polymorphic_allocator<unsigned char>>;
+
+} // pmr
+#endif
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,303 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_SHARED_RING_HPP
+#define BOOST_BUFFERS_SHARED_RING_HPP
+
+#include <boost/buffers/detail/config.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/const_buffer_pair.hpp>
+#include <boost/buffers/mutable_buffer_pair.hpp>
+#include <boost/buffers/ring_waiter.hpp>
+#include <boost/assert.hpp>
+#include <cstddef>
+
+namespace boost {
+namespace buffers {
+
+namespace detail {
+struct shared_ring_header;
+} // detail
+
+/** A single-producer, single-consumer ring in shared memory.
+
+    The ring lives in a memory segment which
+    may be mapped at different addresses in
+    different processes. The segment holds a
+    header followed by the storage; the read
+    and write positions in the header are
+    byte offsets, so nothing in the segment
+    depends on where it is mapped.
+
+    Each process attaches to the segment with
+    a role. The producer uses @ref prepare and
+    @ref commit, and the consumer uses
+    @ref data and @ref consume, with the same
+    buffer pair shapes as @ref circular_buffer.
+    The two sides coordinate through atomic
+    positions only, and block through
+    @ref ring_waiter objects in the header.
+
+    The process id of each side is recorded
+    in the header when it attaches and cleared
+    when it detaches, so a process which dies
+    while attached can be detected with
+    @ref peer. Either side may attach first;
+    the waits block until the other side
+    attaches and then leaves.
+
+    @par Example
+    @code
+    int fd = shared_ring::create(1 << 20);
+    if(fork() == 0)
+    {
+        shared_ring r(fd, shared_ring::consumer);
+        while(r.wait_readable())
+            r.consume(write(1, ...));
+        _exit(0);
+    }
+    shared_ring w(fd, shared_ring::producer);
+    w.commit(read(0, ...));
+    @endcode
+*/
+class shared_ring
+{
+    detail::shared_ring_header* h_ = nullptr;
+    unsigned char* base_ = nullptr;
+    std::size_t cap_ = 0;
+    std::size_t map_size_ = 0;
+    std::size_t out_size_ = 0;
+    int role_ = 0;
+
+public:
+    /** The role of an attached process.
+    */
+    enum role_type
+    {
+        /** The side which writes.
+        */
+        producer = 1,
+
+        /** The side which reads.
+        */
+        consumer = 2
+    };
+
+    /** The state of the other side.
+    */
+    enum class peer_state
+    {
+        /** No process has attached yet.
+        */
+        detached,
+
+        /** The process is attached and running.
+        */
+        alive,
+
+        /** The process exited while attached.
+        */
+        dead,
+
+        /** The process detached.
+        */
+        closed
+    };
+
+    using const_buffers_type =
+        const_buffer_pair;
+
+    using mutable_buffers_type =
+        mutable_buffer_pair;
+
+    /** Create and format a shared memory segment.
+
+        @param capacity The size of the ring
+        storage, in bytes.
+
+        @param name If not null, the segment is
+        created with `shm_open` under this name,
+        which must not exist. Otherwise an
+        anonymous segment is created, which other
+        processes obtain by inheriting or being
+        passed the file descriptor.
+
+        @return The file descriptor of the
+        segment. The caller owns it.
+
+        @throws system_error on failure.
+    */
+    BOOST_BUFFERS_DECL
+    static
+    int
+    create(
+        std::size_t capacity,
+        char const* name = nullptr);
+
+    /** Return the size of a segment for a given capacity.
+    */
+    BOOST_BUFFERS_DECL
+    static
+    std::size_t
+    segment_size(
+        std::size_t capacity) noexcept;
+
+    /** Destructor.
+
+        The role is released and the segment
+        is unmapped. The file descriptor is
+        not closed.
+    */
+    BOOST_BUFFERS_DECL
+    ~shared_ring();
+
+    /** Constructor.
+    */
+    shared_ring() = default;
+
+    /** Constructor.
+
+        Maps a segment previously formatted
+        by @ref create and attaches to it.
+
+        @throws system_error if the segment
+        cannot be mapped, or `EBUSY` if a
+        living process, including this one,
+        holds the role.
+
+        @throws std::invalid_argument if the
+        segment is not a formatted ring.
+    */
+    BOOST_BUFFERS_DECL
+    shared_ring(
+        int fd,
+        role_type role);
+
+    /** Constructor.
+    */
+    BOOST_BUFFERS_DECL
+    shared_ring(
+        shared_ring&& other) noexcept;
+
+    /** Assignment.
+    */
+    BOOST_BUFFERS_DECL
+    shared_ring&
+    operator=(
+        shared_ring&& other) noexcept;
+
+    /** Return the number of readable bytes.
+    */
+    BOOST_BUFFERS_DECL
+    std::size_t
+    size() const noexcept;
+
+    /** Return the size of the ring storage.
+    */
+    std::size_t
+    max_size() const noexcept
+    {
+        return cap_;
+    }
+
+    /** Return the number of writable bytes.
+    */
+    std::size_t
+    capacity() const noexcept
+    {
+        return cap_ - size();
+    }
+
+    /** Return the readable bytes.
+
+        @par Preconditions
+        The role is @ref consumer.
+    */
+    BOOST_BUFFERS_DECL
+    const_buffers_type
+    data() const noexcept;
+
+    /** Return writable space.
+
+        @par Preconditions
+        The role is @ref producer.
+
+        @throws std::length_error `n > capacity()`
+    */
+    BOOST_BUFFERS_DECL
+    mutable_buffers_type
+    prepare(std::size_t n);
+
+    /** Publish written bytes to the consumer.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    commit(std::size_t n) noexcept;
+
+    /** Release read bytes to the producer.
+    */
+    BOOST_BUFFERS_DECL
+    void
+    consume(std::size_t n) noexcept;
+
+    /** Block until bytes are readable.
+
+        A producer which has not attached
+        yet is waited for.
+
+        @return `true` if bytes are readable,
+        or `false` if the producer detached or
+        died and the ring is empty.
+    */
+    BOOST_BUFFERS_DECL
+    bool
+    wait_readable(
+        wait_options const& opt = {});
+
+    /** Block until `n` bytes are writable.
+
+        A consumer which has not attached
+        yet is waited for.
+
+        @return `true` if the space is available,
+        or `false` if the consumer detached
+        or died.
+    */
+    BOOST_BUFFERS_DECL
+    bool
+    wait_writable(
+        std::size_t n,
+        wait_options const& opt = {});
+
+    /** Return the state of the other side.
+
+        A process which exits without
+        destroying its `shared_ring` is
+        reported as @ref peer_state::dead.
+
+        @note Detection relies on the process id
+        of the peer, and cannot distinguish a
+        dead peer whose id was reused.
+    */
+    BOOST_BUFFERS_DECL
+    peer_state
+    peer() const noexcept;
+
+private:
+    void release() noexcept;
+};
+
+} // buffers
+} // boost
+
+#endif
+
+#endif
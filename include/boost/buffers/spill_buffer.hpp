@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_SPILL_BUFFER_HPP
+#define BOOST_BUFFERS_SPILL_BUFFER_HPP
+
+#include <boost/buffers/detail/config.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/const_buffer_pair.hpp>
+#include <boost/buffers/mutable_buffer_pair.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace boost {
+namespace buffers {
+
+/** A dynamic buffer which spills to a temporary file.
+
+    The first `memory_limit` bytes of the buffer
+    are held in memory. Bytes beyond them are
+    written to an unlinked temporary file, which
+    is created the first time it is needed, with
+    `O_TMPFILE` where the file system supports
+    it. Readable bytes stored in the file are
+    presented through a shared mapping of the
+    file, so @ref data and @ref prepare return
+    ordinary buffers: the first element refers
+    to memory, the second to the file.
+
+    The mapping is a window over the file which
+    covers only the bytes between the read and
+    the write positions, rounded out to the
+    window size. As bytes are consumed, the
+    part of the window behind the read position
+    is unmapped and released from the file.
+
+    When @ref prepare would write to the file
+    and the readable bytes fit in memory and
+    are no more than the bytes consumed, they
+    are copied back to the front of the memory
+    and the file is truncated, so a long stream
+    only uses the file while the backlog is
+    larger than the memory.
+
+    @par Exception Safety
+    Errors from the file system are reported by
+    throwing `system_error` from @ref prepare.
+
+    @par Example
+    @code
+    spill_buffer b(64 * 1024);
+    while(auto n = read(fd, b.prepare(65536)))
+        b.commit(n);
+    @endcode
+*/
+class spill_buffer
+{
+    unsigned char* mem_ = nullptr;
+    std::size_t mem_cap_ = 0;
+    std::size_t max_;
+    std::size_t in_pos_ = 0;
+    std::size_t in_size_ = 0;
+    std::size_t out_size_ = 0;
+    std::string dir_;
+    int fd_ = -1;
+    std::uint64_t file_size_ = 0;
+    unsigned char* map_ = nullptr;
+    std::uint64_t map_pos_ = 0;
+    std::size_t map_size_ = 0;
+
+public:
+    using const_buffers_type =
+        const_buffer_pair;
+
+    using mutable_buffers_type =
+        mutable_buffer_pair;
+
+    /** The granularity of the mapped window, in bytes.
+    */
+    static constexpr std::size_t
+        window_size = 1024 * 1024;
+
+    /** Destructor.
+
+        The memory is freed and the
+        temporary file is closed.
+    */
+    BOOST_BUFFERS_DECL
+    ~spill_buffer();
+
+    /** Constructor.
+
+        @param memory_limit The number of bytes
+        held in memory before spilling.
+
+        @param max_size The largest size the
+        buffer is permitted to grow to.
+
+        @param dir The directory in which the
+        temporary file is created. If null, the
+        `TMPDIR` environment variable is used,
+        or else `/tmp`.
+    */
+    BOOST_BUFFERS_DECL
+    explicit
+    spill_buffer(
+        std::size_t memory_limit,
+        std::size_t max_size = std::size_t(-1),
+        char const* dir = nullptr);
+
+    /** Constructor.
+    */
+    BOOST_BUFFERS_DECL
+    spill_buffer(
+        spill_buffer&& other) noexcept;
+
+    /** Assignment.
+    */
+    BOOST_BUFFERS_DECL
+    spill_buffer&
+    operator=(
+        spill_buffer&& other) noexcept;
+
+    std::size_t
+    size() const noexcept
+    {
+        return in_size_;
+    }
+
+    std::size_t
+    max_size() const noexcept
+    {
+        return max_;
+    }
+
+    /** Return the number of bytes held without growing the file.
+
+        This is the memory limit plus the
+        current length of the temporary file,
+        less the bytes before the read position.
+    */
+    std::size_t
+    capacity() const noexcept
+    {
+        return static_cast<std::size_t>(
+            mem_cap_ + file_size_ - in_pos_);
+    }
+
+    /** Return the number of bytes held in memory before spilling.
+    */
+    std::size_t
+    memory_limit() const noexcept
+    {
+        return mem_cap_;
+    }
+
+    /** Return the number of readable bytes stored in the file.
+    */
+    std::size_t
+    spilled() const noexcept
+    {
+        auto const end = in_pos_ + in_size_;
+        if(end <= mem_cap_)
+            return 0;
+        if(in_pos_ >= mem_cap_)
+            return in_size_;
+        return end - mem_cap_;
+    }
+
+    BOOST_BUFFERS_DECL
+    const_buffers_type
+    data() const noexcept;
+
+    /** Return writable space.
+
+        @throws std::length_error
+        `size() + n > max_size()`
+
+        @throws system_error if the temporary
+        file cannot be created, grown or mapped.
+    */
+    BOOST_BUFFERS_DECL
+    mutable_buffers_type
+    prepare(std::size_t n);
+
+    BOOST_BUFFERS_DECL
+    void
+    commit(std::size_t n) noexcept;
+
+    BOOST_BUFFERS_DECL
+    void
+    consume(std::size_t n) noexcept;
+
+private:
+    void rebase() noexcept;
+    void open_file();
+    void map_window(
+        std::uint64_t lo, std::uint64_t hi);
+    void unmap() noexcept;
+    void release() noexcept;
+};
+
+} // buffers
+} // boost
+
+#endif
+
+#endif
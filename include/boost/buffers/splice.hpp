@@ -0,0 +1,153 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_SPLICE_HPP
+#define BOOST_BUFFERS_SPLICE_HPP
+
+#include <boost/buffers/detail/config.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_SPLICE
+
+#include <boost/buffers/iovec.hpp>
+#include <boost/buffers/type_traits.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace boost {
+namespace buffers {
+
+namespace detail {
+
+// the most buffers passed to one vmsplice
+constexpr std::size_t vmsplice_max_buffers = 64;
+
+BOOST_BUFFERS_DECL
+std::size_t
+vmsplice_iov(
+    int pipe,
+    ::iovec const* iov,
+    std::size_t n,
+    bool gift);
+
+} // detail
+
+/** Map the bytes of a buffer sequence into a pipe.
+
+    The pages holding the bytes are referenced
+    by the pipe with `vmsplice` instead of
+    being copied into it, as `write` would.
+    The reader of the pipe, or a @ref splice_some
+    from it, then sees the bytes as they are in
+    memory when read, so the storage must not be
+    modified until they have left the pipe, which
+    @ref pipe_pending reports.
+
+    With `gift`, the pages are handed to the
+    kernel with `SPLICE_F_GIFT`, which lets a
+    later splice move them rather than copy.
+    Every buffer must then start and end on a
+    page boundary, as blocks of a
+    @ref pinned_pool do, and the caller gives up
+    the pages: they must not be written again.
+
+    The call blocks while the pipe is full,
+    unless the pipe is non-blocking.
+
+    @return The number of bytes accepted, which
+    is zero if the pipe is non-blocking and full.
+    At most 64 buffers are passed at once.
+
+    @throws std::invalid_argument if `gift` is
+    set and a buffer is not page-aligned.
+
+    @throws system_error on failure.
+*/
+template<class ConstBufferSequence>
+std::size_t
+vmsplice_some(
+    int pipe,
+    ConstBufferSequence const& bs,
+    bool gift = false)
+{
+    ::iovec iov[detail::vmsplice_max_buffers];
+    return detail::vmsplice_iov(pipe, iov,
+        to_iovec(bs, iov,
+            detail::vmsplice_max_buffers), gift);
+}
+
+/** Map readable bytes of a dynamic buffer into a pipe.
+
+    As many bytes as the pipe accepts are
+    passed with @ref vmsplice_some, then
+    consumed from the buffer. The storage of
+    the consumed bytes must not be written,
+    for example by a later `prepare`, until
+    they have left the pipe.
+
+    @return The number of bytes consumed.
+*/
+template<class DynamicBuffer>
+std::size_t
+vmsplice_from(
+    int pipe,
+    DynamicBuffer& b,
+    bool gift = false)
+{
+    // If you get a compile error here it
+    // means that your type does not meet
+    // the requirements.
+    static_assert(
+        is_dynamic_buffer<DynamicBuffer>::value,
+        "Type requirements not met");
+
+    auto const n = vmsplice_some(
+        pipe, b.data(), gift);
+    b.consume(n);
+    return n;
+}
+
+/** Move bytes between two files, one of which is a pipe.
+
+    Up to `n` bytes are moved with `splice`,
+    without passing through user memory. For
+    a side which is not a pipe, a non-null
+    offset gives the position to read or write
+    at, which is advanced and the file position
+    left unchanged. A null offset uses and
+    advances the file position.
+
+    @return The number of bytes moved, which
+    is zero at the end of the input, or if a
+    pipe is non-blocking and not ready.
+
+    @throws system_error on failure.
+*/
+BOOST_BUFFERS_DECL
+std::size_t
+splice_some(
+    int in,
+    int out,
+    std::size_t n,
+    std::uint64_t* in_offset = nullptr,
+    std::uint64_t* out_offset = nullptr);
+
+/** Return the number of bytes in a pipe not yet read.
+
+    @throws system_error on failure.
+*/
+BOOST_BUFFERS_DECL
+std::size_t
+pipe_pending(int pipe);
+
+} // buffers
+} // boost
+
+#endif
+
+#endif
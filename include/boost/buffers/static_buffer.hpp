@@ -0,0 +1,172 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_STATIC_BUFFER_HPP
+#define BOOST_BUFFERS_STATIC_BUFFER_HPP
+
+#include <boost/buffers/const_buffer.hpp>
+#include <boost/buffers/mutable_buffer.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <cstring>
+
+namespace boost {
+namespace buffers {
+
+/** A DynamicBuffer with inline storage.
+
+    This works like @ref flat_buffer, except that
+    the storage of `N` bytes is a member of the
+    object, so no allocation or separate storage
+    is needed and the capacity is a constant.
+
+    Copies of the buffer copy the readable bytes.
+
+    Buffer sequences returned by this container
+    always have a single element.
+
+    @tparam N The capacity in bytes.
+
+    @see flat_buffer, static_circular_buffer
+*/
+template<std::size_t N>
+class static_buffer
+{
+    static_assert(N > 0,
+        "static_buffer requires N > 0");
+
+    std::size_t in_pos_ = 0;
+    std::size_t in_size_ = 0;
+    std::size_t out_size_ = 0;
+    unsigned char buf_[N];
+
+public:
+    using const_buffers_type =
+        const_buffer;
+
+    using mutable_buffers_type =
+        mutable_buffer;
+
+    /** Constructor.
+    */
+    static_buffer() noexcept
+    {
+    }
+
+    /** Constructor.
+
+        The readable bytes are copied.
+    */
+    static_buffer(
+        static_buffer const& other) noexcept
+        : in_size_(other.in_size_)
+    {
+        std::memcpy(buf_, other.buf_ +
+            other.in_pos_, in_size_);
+    }
+
+    /** Assignment.
+
+        The readable bytes are copied.
+    */
+    static_buffer&
+    operator=(
+        static_buffer const& other) noexcept
+    {
+        if(this == &other)
+            return *this;
+        std::memcpy(buf_, other.buf_ +
+            other.in_pos_, other.in_size_);
+        in_pos_ = 0;
+        in_size_ = other.in_size_;
+        out_size_ = 0;
+        return *this;
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return in_size_;
+    }
+
+    static
+    constexpr
+    std::size_t
+    max_size() noexcept
+    {
+        return N;
+    }
+
+    static
+    constexpr
+    std::size_t
+    capacity() noexcept
+    {
+        return N;
+    }
+
+    const_buffers_type
+    data() const noexcept
+    {
+        return {
+            buf_ + in_pos_,
+            in_size_ };
+    }
+
+    mutable_buffers_type
+    prepare(std::size_t n)
+    {
+        // n exceeds available space
+        if(n > N - in_size_)
+            detail::throw_invalid_argument();
+
+        if(n > N - in_pos_ - in_size_)
+        {
+            // reclaim the consumed bytes
+            std::memmove(buf_,
+                buf_ + in_pos_, in_size_);
+            in_pos_ = 0;
+        }
+
+        out_size_ = n;
+        return { buf_ +
+            in_pos_ + in_size_, n };
+    }
+
+    void
+    commit(
+        std::size_t n) noexcept
+    {
+        if(n < out_size_)
+            in_size_ += n;
+        else
+            in_size_ += out_size_;
+        out_size_ = 0;
+    }
+
+    void
+    consume(
+        std::size_t n) noexcept
+    {
+        if(n < in_size_)
+        {
+            in_pos_ += n;
+            in_size_ -= n;
+        }
+        else
+        {
+            in_pos_ = 0;
+            in_size_ = 0;
+        }
+    }
+};
+
+} // buffers
+} // boost
+
+#endif
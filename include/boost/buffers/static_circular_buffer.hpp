@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_STATIC_CIRCULAR_BUFFER_HPP
+#define BOOST_BUFFERS_STATIC_CIRCULAR_BUFFER_HPP
+
+#include <boost/buffers/const_buffer_pair.hpp>
+#include <boost/buffers/mutable_buffer_pair.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <cstring>
+
+namespace boost {
+namespace buffers {
+
+/** A circular buffer with inline storage.
+
+    This works like @ref circular_buffer, except
+    that the storage of `N` bytes is a member of
+    the object. Offsets never exceed `2 * N`, so
+    wrapping is a compare against a constant
+    rather than a division.
+
+    Copies of the buffer copy the readable bytes.
+
+    Buffer sequences returned from @ref prepare
+    and @ref data always have length two.
+
+    @tparam N The capacity in bytes.
+
+    @see circular_buffer, static_buffer
+*/
+template<std::size_t N>
+class static_circular_buffer
+{
+    static_assert(N > 0,
+        "static_circular_buffer requires N > 0");
+
+    std::size_t in_pos_ = 0;
+    std::size_t in_len_ = 0;
+    std::size_t out_size_ = 0;
+    unsigned char buf_[N];
+
+    // i < 2 * N
+    static
+    std::size_t
+    wrap(std::size_t i) noexcept
+    {
+        return i < N ? i : i - N;
+    }
+
+public:
+    using const_buffers_type =
+        const_buffer_pair;
+
+    using mutable_buffers_type =
+        mutable_buffer_pair;
+
+    /** Constructor.
+    */
+    static_circular_buffer() noexcept
+    {
+    }
+
+    /** Constructor.
+
+        The readable bytes are copied.
+    */
+    static_circular_buffer(
+        static_circular_buffer const& other) noexcept
+    {
+        copy_from(other);
+    }
+
+    /** Assignment.
+
+        The readable bytes are copied.
+    */
+    static_circular_buffer&
+    operator=(
+        static_circular_buffer const& other) noexcept
+    {
+        if(this != &other)
+            copy_from(other);
+        return *this;
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return in_len_;
+    }
+
+    static
+    constexpr
+    std::size_t
+    max_size() noexcept
+    {
+        return N;
+    }
+
+    std::size_t
+    capacity() const noexcept
+    {
+        return N - in_len_;
+    }
+
+    const_buffers_type
+    data() const noexcept
+    {
+        if(in_pos_ + in_len_ <= N)
+            return {
+                const_buffer{
+                    buf_ + in_pos_, in_len_ },
+                const_buffer{ buf_, 0 } };
+        return {
+            const_buffer{
+                buf_ + in_pos_, N - in_pos_ },
+            const_buffer{
+                buf_, in_len_ - (N - in_pos_) } };
+    }
+
+    mutable_buffers_type
+    prepare(std::size_t n)
+    {
+        // Buffer is too small for n
+        if(n > N - in_len_)
+            detail::throw_length_error();
+
+        out_size_ = n;
+        auto const pos = wrap(in_pos_ + in_len_);
+        if(pos + n <= N)
+            return {
+                mutable_buffer{
+                    buf_ + pos, n },
+                mutable_buffer{ buf_, 0 } };
+        return {
+            mutable_buffer{
+                buf_ + pos, N - pos },
+            mutable_buffer{
+                buf_, n - (N - pos) } };
+    }
+
+    void
+    commit(
+        std::size_t n) noexcept
+    {
+        if(n < out_size_)
+            in_len_ += n;
+        else
+            in_len_ += out_size_;
+        out_size_ = 0;
+    }
+
+    void
+    consume(
+        std::size_t n) noexcept
+    {
+        if(n < in_len_)
+        {
+            in_pos_ = wrap(in_pos_ + n);
+            in_len_ -= n;
+        }
+        else
+        {
+            // make prepare return a
+            // bigger single buffer
+            in_pos_ = 0;
+            in_len_ = 0;
+        }
+    }
+
+private:
+    // the copy starts at the front,
+    // so its readable bytes are contiguous
+    void
+    copy_from(
+        static_circular_buffer const& other) noexcept
+    {
+        auto const a = N - other.in_pos_;
+        if(other.in_len_ <= a)
+        {
+            std::memcpy(buf_, other.buf_ +
+                other.in_pos_, other.in_len_);
+        }
+        else
+        {
+            std::memcpy(buf_, other.buf_ +
+                other.in_pos_, a);
+            std::memcpy(buf_ + a, other.buf_,
+                other.in_len_ - a);
+        }
+        in_pos_ = 0;
+        in_len_ = other.in_len_;
+        out_size_ = 0;
+    }
+};
+
+} // buffers
+} // boost
+
+#endif
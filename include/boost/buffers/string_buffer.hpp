@@ -16,10 +16,32 @@
 #include <boost/assert.hpp>
 #include <string>
 
+#ifdef BOOST_BUFFERS_HAS_PMR
+#include <memory_resource>
+#endif
+
 namespace boost {
 namespace buffers {
 
 /** A dynamic buffer using an underlying string
+
+    Consumed bytes are not erased from the string
+    right away. The buffer keeps the offset of the
+    first readable byte, and erases the consumed
+    prefix once it is at least as long as the
+    erase threshold and the readable bytes, when
+    @ref prepare needs the space, or when the
+    buffer is destroyed. Draining a large string
+    in small pieces thus takes linear time.
+
+    Until then, the string holds the consumed
+    prefix followed by the readable bytes, and
+    possibly bytes made available by
+    @ref prepare. When the string is lengthened
+    for @ref prepare, the new characters are
+    not initialized if the standard library
+    provides `resize_and_overwrite`, and are
+    otherwise zero-filled.
 */
 template<
     class CharT,
@@ -30,11 +52,18 @@ class basic_string_buffer
     std::basic_string<
         CharT, Traits, Allocator>* s_;
     std::size_t max_size_;
+    std::size_t in_pos_ = 0;
+    std::size_t threshold_ = default_erase_threshold;
 
 public:
     using string_type = std::basic_string<
         CharT, Traits, Allocator>;
 
+    /** The default length of consumed prefix which may be erased.
+    */
+    static constexpr std::size_t
+        default_erase_threshold = 4096;
+
     unsigned char* data_ = nullptr;
     std::size_t in_size_ = 0;
     std::size_t out_size_ = 0;
@@ -49,7 +78,10 @@ public:
     ~basic_string_buffer()
     {
         if(s_)
-            s_->resize(in_size_);
+        {
+            s_->resize(in_pos_ + in_size_);
+            s_->erase(0, in_pos_);
+        }
     }
 
     /** Constructor.
@@ -58,22 +90,38 @@ public:
         basic_string_buffer&& other) noexcept
         : s_(other.s_)
         , max_size_(other.max_size_)
+        , in_pos_(other.in_pos_)
+        , threshold_(other.threshold_)
+        , in_size_(other.in_size_)
+        , out_size_(other.out_size_)
     {
         other.s_ = nullptr;
     }
 
     /** Constructor.
+
+        @param s The string to use.
+
+        @param max_size The largest size the
+        string is permitted to grow to.
+
+        @param erase_threshold The smallest
+        consumed prefix which is erased by
+        @ref consume.
     */
     explicit
     basic_string_buffer(
         string_type* s,
         std::size_t max_size =
-            std::size_t(-1)) noexcept
+            std::size_t(-1),
+        std::size_t erase_threshold =
+            default_erase_threshold) noexcept
         : s_(s)
         , max_size_(
             max_size > s_->max_size()
                 ? s_->max_size()
                 : max_size)
+        , threshold_(erase_threshold)
     {
         if(s_->size() > max_size_)
             s_->resize(max_size_);
@@ -109,7 +157,7 @@ public:
     data() const noexcept
     {
         return {
-            s_->data(),
+            s_->data() + in_pos_,
             in_size_ };
     }
 
@@ -120,11 +168,22 @@ public:
         if(n > max_size_ - in_size_)
             detail::throw_invalid_argument();
 
-        if( s_->size() < in_size_ + n)
-            s_->resize(in_size_ + n);
+        auto const end = in_pos_ + in_size_;
+        if( in_pos_ > 0 && (
+            n > max_size_ - end ||
+            n > s_->capacity() - end))
+        {
+            // reuse the consumed prefix
+            // instead of reallocating
+            s_->resize(end);
+            s_->erase(0, in_pos_);
+            in_pos_ = 0;
+        }
+        if( s_->size() < in_pos_ + in_size_ + n)
+            grow(in_pos_ + in_size_ + n);
         out_size_ = n;
         return {
-            &(*s_)[in_size_],
+            &(*s_)[in_pos_ + in_size_],
             out_size_ };
     }
 
@@ -145,19 +204,70 @@ public:
     {
         if(n < in_size_)
         {
-            s_->erase(0, n);
+            in_pos_ += n;
             in_size_ -= n;
+            if( in_pos_ >= threshold_ &&
+                in_pos_ >= in_size_)
+            {
+                // drop the prepared bytes
+                // so erase moves fewer
+                s_->resize(in_pos_ + in_size_);
+                s_->erase(0, in_pos_);
+                in_pos_ = 0;
+            }
         }
         else
         {
+            in_pos_ = 0;
             in_size_ = 0;
         }
         out_size_ = 0;
     }
+
+private:
+    // lengthen the string to n, without
+    // initializing the new bytes if possible
+    void
+    grow(std::size_t n)
+    {
+#ifdef __cpp_lib_string_resize_and_overwrite
+        s_->resize_and_overwrite(n,
+            [](CharT*, std::size_t m) noexcept
+            {
+                return m;
+            });
+#else
+        // only the prepared bytes are filled,
+        // since erasing the consumed prefix
+        // cuts off anything past them
+        s_->resize(n);
+#endif
+    }
 };
 
+template<
+    class CharT,
+    class Traits,
+    class Allocator>
+constexpr std::size_t
+basic_string_buffer<
+    CharT, Traits, Allocator>::
+        default_erase_threshold;
+
 using string_buffer = basic_string_buffer<char>;
 
+#ifdef BOOST_BUFFERS_HAS_PMR
+namespace pmr {
+
+/** A dynamic buffer over a `std::pmr::string`.
+*/
+using string_buffer = basic_string_buffer<char,
+    std::char_traits<char>,
+    std::pmr::polymorphic_allocator<char>>;
+
+} // pmr
+#endif
+
 } // buffers
 } // boost
 
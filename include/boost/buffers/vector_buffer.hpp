@@ -0,0 +1,362 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#ifndef BOOST_BUFFERS_VECTOR_BUFFER_HPP
+#define BOOST_BUFFERS_VECTOR_BUFFER_HPP
+
+#include <boost/buffers/const_buffer.hpp>
+#include <boost/buffers/mutable_buffer.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+#include <memory_resource>
+#endif
+
+namespace boost {
+namespace buffers {
+
+/** An allocator adaptor which default-initializes elements
+
+    Value-initialization requested by a container,
+    such as by `std::vector::resize`, is performed
+    as default-initialization instead. For trivial
+    types such as `unsigned char`, this leaves the
+    new elements uninitialized. All other operations
+    are forwarded to the adapted allocator.
+
+    @tparam T The value type.
+
+    @tparam Allocator The adapted allocator.
+*/
+template<
+    class T,
+    class Allocator = std::allocator<T>>
+class default_init_allocator
+    : public Allocator
+{
+    using traits = std::allocator_traits<Allocator>;
+
+    template<class, class>
+    friend class default_init_allocator;
+
+public:
+    using value_type = T;
+
+    template<class U>
+    struct rebind
+    {
+        using other = default_init_allocator<U,
+            typename traits::template rebind_alloc<U>>;
+    };
+
+    /** Constructor.
+    */
+    default_init_allocator() = default;
+
+    /** Constructor.
+    */
+    default_init_allocator(
+        Allocator const& alloc) noexcept
+        : Allocator(alloc)
+    {
+    }
+
+    /** Constructor.
+    */
+    template<class U, class A>
+    default_init_allocator(
+        default_init_allocator<U, A> const& other) noexcept
+        : Allocator(static_cast<A const&>(other))
+    {
+    }
+
+    /** Default-initialize an element.
+    */
+    template<class U>
+    void
+    construct(U* p) noexcept(
+        std::is_nothrow_default_constructible<U>::value)
+    {
+        ::new(static_cast<void*>(p)) U;
+    }
+
+    /** Construct an element from arguments.
+    */
+    template<class U, class Arg, class... Args>
+    void
+    construct(U* p, Arg&& arg, Args&&... args)
+    {
+        Allocator& a = *this;
+        traits::construct(a, p,
+            std::forward<Arg>(arg),
+            std::forward<Args>(args)...);
+    }
+
+    template<class U, class A>
+    friend
+    bool
+    operator==(
+        default_init_allocator const& a0,
+        default_init_allocator<U, A> const& a1) noexcept
+    {
+        return static_cast<Allocator const&>(a0) ==
+            static_cast<A const&>(a1);
+    }
+
+    template<class U, class A>
+    friend
+    bool
+    operator!=(
+        default_init_allocator const& a0,
+        default_init_allocator<U, A> const& a1) noexcept
+    {
+        return !(a0 == a1);
+    }
+};
+
+/** A dynamic buffer using an underlying vector
+
+    This works like @ref basic_string_buffer over
+    a `std::vector<unsigned char, Allocator>`.
+    Consumed bytes are erased lazily, once the
+    consumed prefix is at least as long as the
+    erase threshold and the readable bytes, when
+    @ref prepare needs the space, or when the
+    buffer is destroyed.
+
+    Bytes made available by @ref prepare are
+    left uninitialized only when the allocator
+    is a @ref default_init_allocator, as the
+    default is. Other allocators, such as
+    `std::allocator`, zero-fill each range
+    returned by @ref prepare.
+
+    @tparam Allocator The allocator of the vector.
+*/
+template<
+    class Allocator =
+        default_init_allocator<unsigned char>>
+class basic_vector_buffer
+{
+public:
+    using vector_type = std::vector<
+        unsigned char, Allocator>;
+
+    /** The default length of consumed prefix which may be erased.
+    */
+    static constexpr std::size_t
+        default_erase_threshold = 4096;
+
+private:
+    vector_type* v_;
+    std::size_t max_size_;
+    std::size_t in_pos_ = 0;
+    std::size_t in_size_ = 0;
+    std::size_t out_size_ = 0;
+    std::size_t threshold_ = default_erase_threshold;
+
+public:
+    using const_buffers_type =
+        const_buffer;
+
+    using mutable_buffers_type =
+        mutable_buffer;
+
+    /** Destructor.
+
+        The vector is left holding the
+        readable bytes.
+    */
+    ~basic_vector_buffer()
+    {
+        if(v_)
+        {
+            v_->resize(in_pos_ + in_size_);
+            v_->erase(v_->begin(),
+                v_->begin() + in_pos_);
+        }
+    }
+
+    /** Constructor.
+    */
+    basic_vector_buffer(
+        basic_vector_buffer&& other) noexcept
+        : v_(other.v_)
+        , max_size_(other.max_size_)
+        , in_pos_(other.in_pos_)
+        , in_size_(other.in_size_)
+        , out_size_(other.out_size_)
+        , threshold_(other.threshold_)
+    {
+        other.v_ = nullptr;
+    }
+
+    /** Constructor.
+
+        @param v The vector to use.
+
+        @param max_size The largest size the
+        vector is permitted to grow to.
+
+        @param erase_threshold The smallest
+        consumed prefix which is erased by
+        @ref consume.
+    */
+    explicit
+    basic_vector_buffer(
+        vector_type* v,
+        std::size_t max_size =
+            std::size_t(-1),
+        std::size_t erase_threshold =
+            default_erase_threshold) noexcept
+        : v_(v)
+        , max_size_(
+            max_size > v_->max_size()
+                ? v_->max_size()
+                : max_size)
+        , threshold_(erase_threshold)
+    {
+        if(v_->size() > max_size_)
+            v_->resize(max_size_);
+        in_size_ = v_->size();
+    }
+
+    /** Assignment.
+    */
+    basic_vector_buffer& operator=(
+        basic_vector_buffer const&) = delete;
+
+    std::size_t
+    size() const noexcept
+    {
+        return in_size_;
+    }
+
+    std::size_t
+    max_size() const noexcept
+    {
+        return max_size_;
+    }
+
+    std::size_t
+    capacity() const noexcept
+    {
+        if(v_->capacity() <= max_size_)
+            return v_->capacity() - in_size_;
+        return max_size_ - in_size_;
+    }
+
+    const_buffers_type
+    data() const noexcept
+    {
+        return {
+            v_->data() + in_pos_,
+            in_size_ };
+    }
+
+    mutable_buffers_type
+    prepare(std::size_t n)
+    {
+        // n exceeds available space
+        if(n > max_size_ - in_size_)
+            detail::throw_invalid_argument();
+
+        auto const end = in_pos_ + in_size_;
+        if( in_pos_ > 0 && (
+            n > max_size_ - end ||
+            n > v_->capacity() - end))
+        {
+            // reuse the consumed prefix
+            // instead of reallocating
+            v_->resize(end);
+            v_->erase(v_->begin(),
+                v_->begin() + in_pos_);
+            in_pos_ = 0;
+        }
+        if(v_->size() < in_pos_ + in_size_ + n)
+            v_->resize(in_pos_ + in_size_ + n);
+        out_size_ = n;
+        return {
+            v_->data() + in_pos_ + in_size_,
+            out_size_ };
+    }
+
+    void
+    commit(
+        std::size_t n) noexcept
+    {
+        if(n < out_size_)
+            in_size_ += n;
+        else
+            in_size_ += out_size_;
+        out_size_ = 0;
+    }
+
+    void
+    consume(
+        std::size_t n) noexcept
+    {
+        if(n < in_size_)
+        {
+            in_pos_ += n;
+            in_size_ -= n;
+            if( in_pos_ >= threshold_ &&
+                in_pos_ >= in_size_)
+            {
+                // drop the prepared bytes
+                // so erase moves fewer
+                v_->resize(in_pos_ + in_size_);
+                v_->erase(v_->begin(),
+                    v_->begin() + in_pos_);
+                in_pos_ = 0;
+            }
+        }
+        else
+        {
+            in_pos_ = 0;
+            in_size_ = 0;
+        }
+        out_size_ = 0;
+    }
+};
+
+template<class Allocator>
+constexpr std::size_t
+basic_vector_buffer<Allocator>::
+    default_erase_threshold;
+
+/** A dynamic buffer over a vector which does not initialize prepared bytes.
+*/
+using vector_buffer = basic_vector_buffer<>;
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+namespace pmr {
+
+/** A dynamic buffer over a vector using a polymorphic allocator.
+
+    The allocator of the vector is a
+    @ref default_init_allocator over
+    `std::pmr::polymorphic_allocator`.
+*/
+using vector_buffer = basic_vector_buffer<
+    default_init_allocator<unsigned char,
+        std::pmr::polymorphic_allocator<unsigned char>>>;
+
+} // pmr
+#endif
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,314 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/async_writer.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/detail/except.hpp>
+#include <boost/throw_exception.hpp>
+#include <cerrno>
+#include <chrono>
+#include <new>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+namespace {
+
+std::uint64_t
+elapsed_ns(
+    std::chrono::steady_clock::time_point t0) noexcept
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<
+            std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() -
+                    t0).count());
+}
+
+} // (anon)
+
+async_writer::
+~async_writer()
+{
+    if(fd_ != -1)
+    {
+        try
+        {
+            close();
+        }
+        catch(...)
+        {
+        }
+    }
+}
+
+async_writer::
+async_writer(
+    char const* path)
+    : async_writer(path, options())
+{
+}
+
+async_writer::
+async_writer(
+    char const* path,
+    options const& opt)
+    : size_(opt.buffer_size)
+{
+    if( opt.buffers < 2 ||
+        size_ == 0)
+        detail::throw_invalid_argument();
+    if(opt.buffers > std::size_t(-1) / size_)
+        throw_exception(std::bad_alloc());
+    mem_.reset(new unsigned char[
+        opt.buffers * size_]);
+    bufs_.reserve(opt.buffers);
+    free_.reserve(opt.buffers);
+    full_.reserve(opt.buffers);
+    for(std::size_t i = 0; i < opt.buffers; ++i)
+        bufs_.emplace_back(
+            mem_.get() + i * size_, size_);
+    for(auto& b : bufs_)
+        free_.push_back(&b);
+    active_ = free_.back();
+    free_.pop_back();
+
+    fd_ = ::open(path, O_WRONLY |
+        O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(fd_ == -1)
+        detail::throw_system_error(errno);
+    try
+    {
+        t_ = std::thread(
+            &async_writer::run, this);
+    }
+    catch(...)
+    {
+        ::close(fd_);
+        fd_ = -1;
+        throw;
+    }
+}
+
+auto
+async_writer::
+prepare(std::size_t n) ->
+    mutable_buffers_type
+{
+    if(n > active_->capacity() - active_->size())
+    {
+        if(n > size_)
+            detail::throw_length_error();
+        swap();
+    }
+    return active_->prepare(n);
+}
+
+void
+async_writer::
+flush()
+{
+    if(active_->size() > 0)
+        swap();
+    std::unique_lock<std::mutex> lock(m_);
+    cv_.wait(lock, [this]
+    {
+        return full_.empty() && writing_ == 0;
+    });
+    if(error_ != 0)
+        detail::throw_system_error(error_);
+}
+
+void
+async_writer::
+close()
+{
+    if(fd_ == -1)
+        return;
+    try
+    {
+        flush();
+    }
+    catch(...)
+    {
+        stop();
+        ::close(fd_);
+        fd_ = -1;
+        throw;
+    }
+    stop();
+    auto const rv = ::close(fd_);
+    fd_ = -1;
+    if(rv != 0 && errno != EINTR)
+        detail::throw_system_error(errno);
+}
+
+auto
+async_writer::
+stats() const ->
+    stats_type
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return st_;
+}
+
+//------------------------------------------------
+
+// hand the active buffer to the background
+// thread and take a free one in its place
+void
+async_writer::
+swap()
+{
+    std::unique_lock<std::mutex> lock(m_);
+    if(error_ != 0)
+        detail::throw_system_error(error_);
+    committed_ += active_->size();
+    full_.push_back(active_);
+    ++st_.swaps;
+    cv_.notify_all();
+    if(free_.empty())
+    {
+        // every buffer is queued or being
+        // written, so the disk sets the pace
+        ++st_.swap_waits;
+        auto const t0 =
+            std::chrono::steady_clock::now();
+        cv_.wait(lock, [this]
+        {
+            return ! free_.empty();
+        });
+        st_.swap_wait_ns += elapsed_ns(t0);
+    }
+    active_ = free_.back();
+    free_.pop_back();
+}
+
+void
+async_writer::
+stop() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if(t_.joinable())
+        t_.join();
+}
+
+void
+async_writer::
+run() noexcept
+{
+    std::vector<flat_buffer*> batch;
+    std::vector<::iovec> iov;
+    batch.reserve(bufs_.size());
+    iov.reserve(bufs_.size());
+    std::uint64_t off = 0;
+
+    std::unique_lock<std::mutex> lock(m_);
+    for(;;)
+    {
+        cv_.wait(lock, [this]
+        {
+            return stop_ || ! full_.empty();
+        });
+        if(full_.empty())
+            return;
+        batch.swap(full_);
+        writing_ = batch.size();
+        auto ev = error_;
+        lock.unlock();
+
+        // once a write fails, the rest
+        // of the bytes are discarded
+        std::uint64_t written = 0;
+        std::uint64_t flushes = 0;
+        std::uint64_t ns = 0;
+        std::uint64_t max_ns = 0;
+        std::size_t i = 0;
+        while(ev == 0 && i < batch.size())
+        {
+            iov.clear();
+            for(auto j = i; j < batch.size() &&
+                iov.size() < IOV_MAX; ++j)
+            {
+                auto const b = batch[j]->data();
+                iov.push_back({ const_cast<void*>(
+                    b.data()), b.size() });
+            }
+            i += iov.size();
+
+            // resume after a short write
+            std::size_t k = 0;
+            while(k < iov.size())
+            {
+                auto const t0 =
+                    std::chrono::steady_clock::now();
+                auto const rv = ::pwritev(fd_,
+                    &iov[k], static_cast<int>(
+                        iov.size() - k),
+                    static_cast<off_t>(off));
+                if(rv < 0)
+                {
+                    if(errno == EINTR)
+                        continue;
+                    ev = errno;
+                    break;
+                }
+                auto const t = elapsed_ns(t0);
+                ++flushes;
+                ns += t;
+                if(max_ns < t)
+                    max_ns = t;
+                auto n = static_cast<std::size_t>(rv);
+                off += n;
+                written += n;
+                while(k < iov.size() &&
+                    n >= iov[k].iov_len)
+                    n -= iov[k++].iov_len;
+                if(n > 0)
+                {
+                    iov[k].iov_base = static_cast<
+                        char*>(iov[k].iov_base) + n;
+                    iov[k].iov_len -= n;
+                }
+            }
+        }
+
+        lock.lock();
+        error_ = ev;
+        st_.flushes += flushes;
+        st_.flush_ns += ns;
+        if(st_.max_flush_ns < max_ns)
+            st_.max_flush_ns = max_ns;
+        st_.bytes_written += written;
+        for(auto b : batch)
+        {
+            b->consume(b->size());
+            free_.push_back(b);
+        }
+        batch.clear();
+        writing_ = 0;
+        cv_.notify_all();
+    }
+}
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/bip_buffer.hpp>
+#include <boost/buffers/type_traits.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<
+        bip_buffer>::value);
+
+auto
+bip_buffer::
+data() const noexcept ->
+    const_buffers_type
+{
+    return {
+        const_buffer{
+            base_ + a_pos_, a_len_ },
+        const_buffer{
+            base_, b_len_ } };
+}
+
+auto
+bip_buffer::
+prepare(std::size_t n) ->
+    mutable_buffers_type
+{
+    if(wrapped_)
+    {
+        // region B grows towards region A
+        if(n > a_pos_ - b_len_)
+            detail::throw_length_error();
+        out_wrapped_ = true;
+        out_size_ = n;
+        return { base_ + b_len_, n };
+    }
+
+    auto const a_end = a_pos_ + a_len_;
+    if(n <= cap_ - a_end)
+    {
+        out_wrapped_ = false;
+        out_size_ = n;
+        return { base_ + a_end, n };
+    }
+
+    // Buffer is too small for n
+    if(n > a_pos_)
+        detail::throw_length_error();
+
+    // start region B, which takes
+    // effect when bytes are committed
+    out_wrapped_ = true;
+    out_size_ = n;
+    return { base_, n };
+}
+
+void
+bip_buffer::
+commit(
+    std::size_t n) noexcept
+{
+    if(n > out_size_)
+        n = out_size_;
+    out_size_ = 0;
+    if(! out_wrapped_)
+    {
+        a_len_ += n;
+        return;
+    }
+    if(n == 0)
+        return;
+    if(! wrapped_)
+    {
+        wrapped_ = true;
+        waste_ = cap_ - a_pos_ - a_len_;
+    }
+    b_len_ += n;
+}
+
+void
+bip_buffer::
+consume(
+    std::size_t n) noexcept
+{
+    out_size_ = 0;
+    if(n < a_len_)
+    {
+        a_pos_ += n;
+        a_len_ -= n;
+        return;
+    }
+    n -= a_len_;
+    if(wrapped_)
+    {
+        // region B becomes region A
+        // and the tail is reclaimed
+        wrapped_ = false;
+        waste_ = 0;
+        a_len_ = b_len_;
+        b_len_ = 0;
+        if(n < a_len_)
+        {
+            a_pos_ = n;
+            a_len_ -= n;
+            return;
+        }
+    }
+    // make prepare return a
+    // bigger single buffer
+    a_pos_ = 0;
+    a_len_ = 0;
+}
+
+} // buffers
+} // boost
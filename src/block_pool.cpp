@@ -0,0 +1,628 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/block_pool.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+
+namespace boost {
+namespace buffers {
+
+namespace {
+
+// Live pools, so that a thread which exits
+// does not touch a pool destroyed before it.
+std::mutex&
+registry_mutex() noexcept
+{
+    static std::mutex m;
+    return m;
+}
+
+std::vector<std::uint64_t>&
+registry() noexcept
+{
+    static std::vector<std::uint64_t> v;
+    return v;
+}
+
+std::atomic<std::uint64_t> next_id{1};
+
+// Counters written only by the owning
+// thread need no read-modify-write
+template<class T>
+void
+bump(
+    std::atomic<T>& v,
+    T n = 1) noexcept
+{
+    v.store(v.load(
+        std::memory_order_relaxed) + n,
+        std::memory_order_relaxed);
+}
+
+template<class T>
+void
+drop(
+    std::atomic<T>& v,
+    T n = 1) noexcept
+{
+    v.store(v.load(
+        std::memory_order_relaxed) - n,
+        std::memory_order_relaxed);
+}
+
+} // (anon)
+
+namespace detail {
+
+// Precedes the bytes of every block.
+struct pool_block
+{
+    pool_cache* owner;
+    pool_block* next;
+    std::size_t cls;
+};
+
+} // detail
+
+namespace {
+
+constexpr std::size_t oversize = std::size_t(-1);
+
+constexpr std::size_t header_size =
+    (sizeof(detail::pool_block) +
+        alignof(std::max_align_t) - 1) &
+    ~(alignof(std::max_align_t) - 1);
+
+void*
+to_user(detail::pool_block* h) noexcept
+{
+    return reinterpret_cast<
+        unsigned char*>(h) + header_size;
+}
+
+detail::pool_block*
+to_header(void* p) noexcept
+{
+    return reinterpret_cast<detail::pool_block*>(
+        static_cast<unsigned char*>(p) - header_size);
+}
+
+void
+free_list(detail::pool_block* h) noexcept
+{
+    while(h)
+    {
+        auto const next = h->next;
+        ::operator delete(h);
+        h = next;
+    }
+}
+
+} // (anon)
+
+namespace detail {
+
+struct pool_cache
+{
+    // a magazine: touched only by the
+    // owning thread, except count
+    struct bin
+    {
+        pool_block* head = nullptr;
+        std::atomic<std::size_t> count{0};
+    };
+
+    std::unique_ptr<bin[]> bins;
+
+    // blocks freed by other threads
+    std::atomic<pool_block*> remote{nullptr};
+    std::atomic<std::size_t> remote_bytes{0};
+
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> depot_hits{0};
+    std::atomic<std::uint64_t> heap{0};
+    std::atomic<std::uint64_t> remote_frees{0};
+
+    // blocks allocated here, less those freed
+    // here; remote frees are counted apart
+    std::atomic<std::size_t> in_use{0};
+    std::atomic<std::size_t> in_use_bytes{0};
+    std::atomic<std::size_t> remote_freed_bytes{0};
+
+    explicit
+    pool_cache(std::size_t n)
+        : bins(new bin[n])
+    {
+    }
+};
+
+// The caches used by a thread
+struct pool_thread
+{
+    struct entry
+    {
+        std::uint64_t id;
+        block_pool* pool;
+        pool_cache* c;
+    };
+
+    std::vector<entry> entries;
+
+    ~pool_thread()
+    {
+        std::lock_guard<std::mutex> lock(
+            registry_mutex());
+        auto const& live = registry();
+        for(auto const& e : entries)
+            if(std::find(live.begin(),
+                live.end(), e.id) != live.end())
+                e.pool->retire(*e.c);
+    }
+};
+
+} // detail
+
+namespace {
+
+detail::pool_thread&
+this_thread() noexcept
+{
+    thread_local detail::pool_thread t;
+    return t;
+}
+
+} // (anon)
+
+//------------------------------------------------
+
+block_pool::
+~block_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(
+            registry_mutex());
+        auto& live = registry();
+        live.erase(std::find(
+            live.begin(), live.end(), id_));
+    }
+    for(auto c : caches_)
+    {
+        for(std::size_t i = 0;
+            i < classes_.size(); ++i)
+            free_list(c->bins[i].head);
+        free_list(c->remote.load());
+        delete c;
+    }
+    for(auto h : depot_)
+        free_list(h);
+}
+
+block_pool::
+block_pool()
+    : block_pool(options())
+{
+}
+
+block_pool::
+block_pool(
+    options const& opt)
+    : id_(next_id.fetch_add(1))
+    , classes_(opt.size_classes)
+    , high_(opt.high_watermark)
+    , low_(opt.low_watermark)
+    , depot_(classes_.size(), nullptr)
+    , depot_count_(classes_.size(), 0)
+{
+    if( classes_.empty() ||
+        classes_[0] == 0 ||
+        ! std::is_sorted(
+            classes_.begin(), classes_.end()) ||
+        std::adjacent_find(
+            classes_.begin(), classes_.end()) !=
+                classes_.end() ||
+        low_ > high_)
+        detail::throw_invalid_argument();
+
+    std::lock_guard<std::mutex> lock(
+        registry_mutex());
+    registry().push_back(id_);
+}
+
+void*
+block_pool::
+allocate(std::size_t n)
+{
+    auto& c = local();
+    bump(c.allocations);
+    auto const cls = static_cast<std::size_t>(
+        std::lower_bound(classes_.begin(),
+            classes_.end(), n) - classes_.begin());
+    if(cls == classes_.size())
+    {
+        // larger than every size class
+        if(n > std::size_t(-1) - header_size)
+            throw std::bad_alloc();
+        auto const h = static_cast<header*>(
+            ::operator new(header_size + n));
+        h->owner = &c;
+        h->next = nullptr;
+        h->cls = oversize;
+        bump(c.heap);
+        bump(c.in_use);
+        bump(c.in_use_bytes, n);
+        return to_user(h);
+    }
+
+    auto& b = c.bins[cls];
+    if(! b.head)
+        drain_remote(c);
+    if(b.head)
+    {
+        bump(c.hits);
+    }
+    else
+    {
+        header* head = nullptr;
+        auto const got = from_depot(cls, head);
+        if(got == 0)
+        {
+            auto const h = static_cast<header*>(
+                ::operator new(
+                    header_size + classes_[cls]));
+            h->owner = &c;
+            h->next = nullptr;
+            h->cls = cls;
+            bump(c.heap);
+            bump(c.in_use);
+            bump(c.in_use_bytes, classes_[cls]);
+            return to_user(h);
+        }
+        b.head = head;
+        b.count.store(got,
+            std::memory_order_relaxed);
+        bump(c.depot_hits);
+    }
+
+    auto const h = b.head;
+    b.head = h->next;
+    b.count.store(b.count.load(
+        std::memory_order_relaxed) - 1,
+        std::memory_order_relaxed);
+    h->owner = &c;
+    h->next = nullptr;
+    bump(c.in_use);
+    bump(c.in_use_bytes, classes_[cls]);
+    return to_user(h);
+}
+
+void
+block_pool::
+deallocate(
+    void* p,
+    std::size_t n) noexcept
+{
+    if(! p)
+        return;
+    auto const h = to_header(p);
+    auto const owner = h->owner;
+    if(h->cls == oversize)
+    {
+        if(owner == find_local())
+        {
+            drop(owner->in_use);
+            drop(owner->in_use_bytes, n);
+        }
+        else
+        {
+            owner->remote_freed_bytes.fetch_add(
+                n, std::memory_order_relaxed);
+            owner->remote_frees.fetch_add(1,
+                std::memory_order_relaxed);
+        }
+        ::operator delete(h);
+        return;
+    }
+    BOOST_ASSERT(h->cls < classes_.size());
+
+    if(owner == find_local())
+    {
+        drop(owner->in_use);
+        drop(owner->in_use_bytes, classes_[h->cls]);
+
+        // back to this thread's magazine
+        auto& b = owner->bins[h->cls];
+        h->next = b.head;
+        b.head = h;
+        auto const count = b.count.load(
+            std::memory_order_relaxed) + 1;
+        b.count.store(count,
+            std::memory_order_relaxed);
+        if(count > high_)
+            spill(*owner, h->cls);
+        return;
+    }
+
+    // push onto the owner's return list
+    owner->remote_bytes.fetch_add(
+        classes_[h->cls],
+        std::memory_order_relaxed);
+    owner->remote_freed_bytes.fetch_add(
+        classes_[h->cls],
+        std::memory_order_relaxed);
+    owner->remote_frees.fetch_add(1,
+        std::memory_order_relaxed);
+    auto head = owner->remote.load(
+        std::memory_order_relaxed);
+    do
+    {
+        h->next = head;
+    }
+    while(! owner->remote.compare_exchange_weak(
+        head, h,
+        std::memory_order_release,
+        std::memory_order_relaxed));
+}
+
+std::size_t
+block_pool::
+block_size(std::size_t n) const noexcept
+{
+    auto const it = std::lower_bound(
+        classes_.begin(), classes_.end(), n);
+    if(it == classes_.end())
+        return n;
+    return *it;
+}
+
+auto
+block_pool::
+stats() const ->
+    stats_type
+{
+    stats_type st;
+    std::size_t freed = 0;
+    std::size_t freed_bytes = 0;
+    std::lock_guard<std::mutex> lock(m_);
+    for(auto c : caches_)
+    {
+        st.blocks_in_use += c->in_use.load(
+            std::memory_order_relaxed);
+        st.bytes_in_use += c->in_use_bytes.load(
+            std::memory_order_relaxed);
+        st.allocations += c->allocations.load(
+            std::memory_order_relaxed);
+        st.cache_hits += c->hits.load(
+            std::memory_order_relaxed);
+        st.depot_hits += c->depot_hits.load(
+            std::memory_order_relaxed);
+        st.heap_allocations += c->heap.load(
+            std::memory_order_relaxed);
+        auto const rf = c->remote_frees.load(
+            std::memory_order_relaxed);
+        st.remote_frees += rf;
+        freed += static_cast<std::size_t>(rf);
+        freed_bytes += c->remote_freed_bytes.load(
+            std::memory_order_relaxed);
+        st.bytes_retained += c->remote_bytes.load(
+            std::memory_order_relaxed);
+        for(std::size_t i = 0;
+            i < classes_.size(); ++i)
+            st.bytes_retained += classes_[i] *
+                c->bins[i].count.load(
+                    std::memory_order_relaxed);
+    }
+    for(std::size_t i = 0;
+        i < classes_.size(); ++i)
+        st.bytes_retained +=
+            classes_[i] * depot_count_[i];
+
+    // counters of different threads
+    // are not read at one instant
+    st.blocks_in_use = st.blocks_in_use > freed
+        ? st.blocks_in_use - freed : 0;
+    st.bytes_in_use = st.bytes_in_use > freed_bytes
+        ? st.bytes_in_use - freed_bytes : 0;
+    return st;
+}
+
+void
+block_pool::
+trim() noexcept
+{
+    std::lock_guard<std::mutex> lock(m_);
+    for(std::size_t i = 0;
+        i < classes_.size(); ++i)
+    {
+        free_list(depot_[i]);
+        depot_[i] = nullptr;
+        depot_count_[i] = 0;
+    }
+}
+
+//------------------------------------------------
+
+auto
+block_pool::
+find_local() const noexcept ->
+    cache*
+{
+    auto const& v = this_thread().entries;
+    for(auto it = v.rbegin(); it != v.rend(); ++it)
+        if(it->id == id_)
+            return it->c;
+    return nullptr;
+}
+
+auto
+block_pool::
+local() ->
+    cache&
+{
+    auto const c0 = find_local();
+    if(c0)
+        return *c0;
+
+    auto& ts = this_thread();
+    {
+        // forget pools which no longer exist
+        std::lock_guard<std::mutex> lock(
+            registry_mutex());
+        auto const& live = registry();
+        ts.entries.erase(std::remove_if(
+            ts.entries.begin(), ts.entries.end(),
+            [&live](detail::pool_thread::entry const& e)
+            {
+                return std::find(live.begin(),
+                    live.end(), e.id) == live.end();
+            }), ts.entries.end());
+    }
+    ts.entries.reserve(ts.entries.size() + 1);
+    cache* c;
+    {
+        // adopt the cache of an exited thread
+        std::lock_guard<std::mutex> lock(m_);
+        if(! orphans_.empty())
+        {
+            c = orphans_.back();
+            orphans_.pop_back();
+        }
+        else
+        {
+            caches_.reserve(caches_.size() + 1);
+            c = new cache(classes_.size());
+            caches_.push_back(c);
+        }
+    }
+    ts.entries.push_back({ id_, this, c });
+    return *c;
+}
+
+void
+block_pool::
+retire(cache& c) noexcept
+{
+    drain_remote(c);
+    for(std::size_t i = 0;
+        i < classes_.size(); ++i)
+    {
+        auto& b = c.bins[i];
+        auto const n = b.count.load(
+            std::memory_order_relaxed);
+        if(n > 0)
+            to_depot(i, b.head, n);
+        b.head = nullptr;
+        b.count.store(0,
+            std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(m_);
+    orphans_.push_back(&c);
+}
+
+void
+block_pool::
+drain_remote(cache& c) noexcept
+{
+    auto h = c.remote.exchange(nullptr,
+        std::memory_order_acquire);
+    if(! h)
+        return;
+    std::size_t bytes = 0;
+    while(h)
+    {
+        auto const next = h->next;
+        auto& b = c.bins[h->cls];
+        h->next = b.head;
+        b.head = h;
+        b.count.store(b.count.load(
+            std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+        bytes += classes_[h->cls];
+        h = next;
+    }
+    c.remote_bytes.fetch_sub(bytes,
+        std::memory_order_relaxed);
+
+    // a large batch may overfill a magazine
+    for(std::size_t i = 0;
+        i < classes_.size(); ++i)
+        if(c.bins[i].count.load(
+            std::memory_order_relaxed) > high_)
+            spill(c, i);
+}
+
+void
+block_pool::
+spill(
+    cache& c,
+    std::size_t cls) noexcept
+{
+    // keep the low watermark
+    auto& b = c.bins[cls];
+    auto const k = b.count.load(
+        std::memory_order_relaxed) - low_;
+    auto head = b.head;
+    auto tail = head;
+    for(std::size_t i = 1; i < k; ++i)
+        tail = tail->next;
+    b.head = tail->next;
+    tail->next = nullptr;
+    b.count.store(low_,
+        std::memory_order_relaxed);
+    to_depot(cls, head, k);
+}
+
+void
+block_pool::
+to_depot(
+    std::size_t cls,
+    header* head,
+    std::size_t n) noexcept
+{
+    BOOST_ASSERT(n > 0);
+    auto tail = head;
+    for(std::size_t i = 1; i < n; ++i)
+        tail = tail->next;
+    std::lock_guard<std::mutex> lock(m_);
+    tail->next = depot_[cls];
+    depot_[cls] = head;
+    depot_count_[cls] += n;
+}
+
+std::size_t
+block_pool::
+from_depot(
+    std::size_t cls,
+    header*& head) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_);
+    auto const avail = depot_count_[cls];
+    if(avail == 0)
+        return 0;
+    auto n = low_ > 0 ? low_ : 1;
+    if(n > avail)
+        n = avail;
+    head = depot_[cls];
+    auto tail = head;
+    for(std::size_t i = 1; i < n; ++i)
+        tail = tail->next;
+    depot_[cls] = tail->next;
+    tail->next = nullptr;
+    depot_count_[cls] -= n;
+    return n;
+}
+
+} // buffers
+} // boost
@@ -12,10 +12,64 @@
 #include <boost/buffers/detail/except.hpp>
 #include <boost/assert.hpp>
 #include <boost/static_assert.hpp>
+#include <cstring>
 
 namespace boost {
 namespace buffers {
 
+namespace {
+
+// exchange two non-overlapping ranges
+// a chunk at a time, so each pass is
+// a pair of cache friendly copies
+void
+swap_blocks(
+    unsigned char* p0,
+    unsigned char* p1,
+    std::size_t n) noexcept
+{
+    unsigned char tmp[256];
+    while(n > 0)
+    {
+        auto const k = n < sizeof(tmp)
+            ? n : sizeof(tmp);
+        std::memcpy(tmp, p0, k);
+        std::memcpy(p0, p1, k);
+        std::memcpy(p1, tmp, k);
+        p0 += k;
+        p1 += k;
+        n -= k;
+    }
+}
+
+// Gries-Mills block swap: exchanges the
+// left and right pieces of p[0, l+r)
+void
+rotate_blocks(
+    unsigned char* p,
+    std::size_t l,
+    std::size_t r) noexcept
+{
+    while(l > 0 && r > 0)
+    {
+        if(l <= r)
+        {
+            // the left piece lands at the end
+            swap_blocks(p, p + r, l);
+            r -= l;
+        }
+        else
+        {
+            // the right piece lands at the start
+            swap_blocks(p, p + l, r);
+            p += r;
+            l -= r;
+        }
+    }
+}
+
+} // (anon)
+
 BOOST_STATIC_ASSERT(
     is_dynamic_buffer<
         circular_buffer>::value);
@@ -47,6 +101,8 @@ prepare(std::size_t n) ->
         detail::throw_length_error();
 
     out_size_ = n;
+    if(cap_ == 0)
+        return {};
     auto const pos = (
         in_pos_ + in_len_) % cap_;
     if(pos + n <= cap_)
@@ -92,5 +148,56 @@ consume(
     }
 }
 
+const_buffer
+circular_buffer::
+linearize() noexcept
+{
+    if(in_pos_ + in_len_ <= cap_)
+        return { base_ + in_pos_, in_len_ };
+
+    // A = [in_pos_, cap_) is followed
+    // by B = [0, b), with a hole between
+    auto const a = cap_ - in_pos_;
+    auto const b = in_len_ - a;
+    auto const hole = cap_ - in_len_;
+    if(hole >= a)
+    {
+        // B moves up, A fills in below
+        std::memmove(base_ + a, base_, b);
+        std::memcpy(base_, base_ + in_pos_, a);
+        in_pos_ = 0;
+    }
+    else if(hole >= b)
+    {
+        // A moves down, B goes on the end
+        std::memmove(
+            base_ + in_pos_ - b,
+            base_ + in_pos_, a);
+        std::memcpy(base_ + cap_ - b, base_, b);
+        in_pos_ -= b;
+    }
+    else
+    {
+        // the hole is smaller than either
+        // piece, so rotate the whole storage
+        rotate_blocks(base_, in_pos_, a);
+        in_pos_ = 0;
+    }
+    return { base_ + in_pos_, in_len_ };
+}
+
+const_buffer
+circular_buffer::
+peek_contiguous(std::size_t n)
+{
+    // n exceeds the readable bytes
+    if(n > in_len_)
+        detail::throw_invalid_argument();
+
+    if(in_pos_ + n > cap_)
+        linearize();
+    return { base_ + in_pos_, n };
+}
+
 } // buffers
 } // boost
@@ -9,6 +9,7 @@
 
 #include <boost/buffers/detail/except.hpp>
 #include <boost/version.hpp>
+#include <boost/system/system_error.hpp>
 #include <boost/throw_exception.hpp>
 #include <stdexcept>
 
@@ -34,6 +35,16 @@ throw_length_error(
             "length error"), loc);
 }
 
+void
+throw_system_error(
+    int ev,
+    source_location const& loc)
+{
+    throw_exception(
+        system::system_error(
+            ev, system::generic_category()), loc);
+}
+
 } // detail
 } // buffers
 } // boost
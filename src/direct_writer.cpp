@@ -0,0 +1,239 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/direct_writer.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/detail/except.hpp>
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+direct_writer::
+~direct_writer()
+{
+    if(fd_ != -1)
+    {
+        try
+        {
+            close();
+        }
+        catch(...)
+        {
+        }
+    }
+    std::free(buf_);
+}
+
+direct_writer::
+direct_writer(
+    char const* path)
+    : direct_writer(path, options())
+{
+}
+
+direct_writer::
+direct_writer(
+    char const* path,
+    options const& opt)
+    : block_(opt.block_size)
+    , cap_(opt.buffer_size)
+{
+    if( block_ == 0 ||
+        (block_ & (block_ - 1)) != 0)
+        detail::throw_invalid_argument();
+    if(cap_ < block_)
+        cap_ = block_;
+    if(cap_ > std::size_t(-1) - block_)
+        throw_exception(std::bad_alloc());
+    cap_ = (cap_ + block_ - 1) / block_ * block_;
+
+    void* p = nullptr;
+    auto const align = block_ < sizeof(void*)
+        ? sizeof(void*) : block_;
+    if(::posix_memalign(&p, align, cap_) != 0)
+        throw_exception(std::bad_alloc());
+    buf_ = static_cast<unsigned char*>(p);
+
+    int const flags =
+        O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    int ev = 0;
+#if defined(O_DIRECT)
+    if(opt.direct)
+    {
+        // EINVAL if the file system
+        // does not support it
+        fd_ = ::open(path, flags | O_DIRECT, 0644);
+        if(fd_ != -1)
+            direct_ = true;
+        else if(errno != EINVAL)
+            ev = errno;
+    }
+#endif
+    if(fd_ == -1 && ev == 0)
+    {
+        fd_ = ::open(path, flags, 0644);
+        if(fd_ == -1)
+            ev = errno;
+    }
+    if(fd_ == -1)
+    {
+        std::free(buf_);
+        buf_ = nullptr;
+        detail::throw_system_error(ev);
+    }
+#if ! defined(O_DIRECT) && defined(F_NOCACHE)
+    if( opt.direct &&
+        ::fcntl(fd_, F_NOCACHE, 1) != -1)
+        direct_ = true;
+#endif
+}
+
+auto
+direct_writer::
+prepare(std::size_t n) ->
+    mutable_buffers_type
+{
+    if(n > cap_ - len_)
+    {
+        write_blocks();
+        if(n > cap_ - len_)
+            detail::throw_length_error();
+    }
+    out_ = n;
+    return { buf_ + len_, n };
+}
+
+void
+direct_writer::
+commit(std::size_t n) noexcept
+{
+    if(n > out_)
+        n = out_;
+    len_ += n;
+    out_ = 0;
+}
+
+void
+direct_writer::
+flush()
+{
+    write_blocks();
+    if(len_ == 0)
+        return;
+
+    // pad the tail to a whole block, then
+    // cut the padding from the file
+    std::memset(buf_ + len_, 0, block_ - len_);
+    write_at(buf_, block_, off_);
+    if(::ftruncate(fd_, static_cast<
+            off_t>(off_ + len_)) != 0)
+        detail::throw_system_error(errno);
+}
+
+void
+direct_writer::
+close()
+{
+    if(fd_ == -1)
+        return;
+    try
+    {
+        flush();
+    }
+    catch(...)
+    {
+        ::close(fd_);
+        fd_ = -1;
+        throw;
+    }
+    auto const rv = ::close(fd_);
+    fd_ = -1;
+    if(rv != 0 && errno != EINTR)
+        detail::throw_system_error(errno);
+}
+
+//------------------------------------------------
+
+// write the whole blocks, keeping
+// the partial block at the front
+void
+direct_writer::
+write_blocks()
+{
+    auto const n = len_ / block_ * block_;
+    if(n == 0)
+        return;
+    write_at(buf_, n, off_);
+    off_ += n;
+    len_ -= n;
+    if(len_ > 0)
+        std::memcpy(buf_, buf_ + n, len_);
+}
+
+void
+direct_writer::
+write_at(
+    unsigned char const* p,
+    std::size_t n,
+    std::uint64_t offset)
+{
+    BOOST_ASSERT(fd_ != -1);
+    while(n > 0)
+    {
+        auto const rv = ::pwrite(fd_, p, n,
+            static_cast<off_t>(offset));
+        if(rv < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            // rejected only once written to
+            if(errno == EINVAL && fall_back())
+                continue;
+            detail::throw_system_error(errno);
+        }
+        p += rv;
+        n -= static_cast<std::size_t>(rv);
+        offset += static_cast<std::uint64_t>(rv);
+    }
+}
+
+bool
+direct_writer::
+fall_back() noexcept
+{
+#if defined(O_DIRECT)
+    if(! direct_)
+        return false;
+    auto const flags = ::fcntl(fd_, F_GETFL);
+    if( flags == -1 ||
+        ::fcntl(fd_, F_SETFL,
+            flags & ~O_DIRECT) == -1)
+        return false;
+    direct_ = false;
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,213 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/huge_page_arena.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/detail/except.hpp>
+#include <boost/throw_exception.hpp>
+#include <cstdio>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+namespace {
+
+std::size_t
+page_size() noexcept
+{
+    return static_cast<std::size_t>(
+        ::sysconf(_SC_PAGESIZE));
+}
+
+} // (anon)
+
+std::size_t
+huge_page_arena::
+default_huge_page_size() noexcept
+{
+    std::size_t n = 2 * 1024 * 1024;
+#if defined(__linux__)
+    auto const f = std::fopen("/proc/meminfo", "r");
+    if(! f)
+        return n;
+    char line[128];
+    while(std::fgets(line, sizeof(line), f))
+    {
+        unsigned long kb;
+        if(std::sscanf(line,
+            "Hugepagesize: %lu kB", &kb) == 1)
+        {
+            if(kb > 0)
+                n = static_cast<std::size_t>(kb) * 1024;
+            break;
+        }
+    }
+    std::fclose(f);
+#endif
+    return n;
+}
+
+huge_page_arena::
+huge_page_arena()
+    : huge_page_arena(options())
+{
+}
+
+huge_page_arena::
+huge_page_arena(
+    options const& opt)
+    : huge_(opt.huge_page_size)
+    , threshold_(opt.threshold)
+    , hugetlb_(opt.use_hugetlb)
+    , transparent_(opt.use_transparent)
+{
+    if(huge_ == 0)
+        huge_ = default_huge_page_size();
+    if(huge_ % page_size() != 0)
+        detail::throw_invalid_argument();
+    if(threshold_ == 0)
+        threshold_ = huge_ / 2;
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    // select a size other than the default
+    if(huge_ != default_huge_page_size())
+    {
+        int log2 = 0;
+        while((std::size_t(1) << log2) < huge_)
+            ++log2;
+        size_flag_ = log2 << MAP_HUGE_SHIFT;
+    }
+#endif
+}
+
+void*
+huge_page_arena::
+allocate(std::size_t n)
+{
+    if(n < threshold_)
+    {
+        n_small_.fetch_add(1,
+            std::memory_order_relaxed);
+        return ::operator new(n);
+    }
+    if(n > std::size_t(-1) - huge_)
+        throw_exception(std::bad_alloc());
+    auto const size = (n + huge_ - 1) / huge_ * huge_;
+
+#if defined(MAP_HUGETLB)
+    if(hugetlb_)
+    {
+        void* p = ::mmap(nullptr, size,
+            PROT_READ | PROT_WRITE, MAP_PRIVATE |
+                MAP_ANONYMOUS | MAP_HUGETLB | size_flag_,
+            -1, 0);
+        if(p != MAP_FAILED)
+        {
+            n_hugetlb_.fetch_add(1,
+                std::memory_order_relaxed);
+            mapped_.fetch_add(size,
+                std::memory_order_relaxed);
+            return p;
+        }
+    }
+#endif
+
+    void* p = map_aligned(size);
+    if(! p)
+        throw_exception(std::bad_alloc());
+    mapped_.fetch_add(size,
+        std::memory_order_relaxed);
+
+#if defined(MADV_HUGEPAGE)
+    if( transparent_ &&
+        ::madvise(p, size, MADV_HUGEPAGE) == 0)
+    {
+        n_transparent_.fetch_add(1,
+            std::memory_order_relaxed);
+        return p;
+    }
+#endif
+    n_normal_.fetch_add(1,
+        std::memory_order_relaxed);
+    return p;
+}
+
+void
+huge_page_arena::
+deallocate(
+    void* p,
+    std::size_t n) noexcept
+{
+    if(n < threshold_)
+    {
+        ::operator delete(p);
+        return;
+    }
+    auto const size = (n + huge_ - 1) / huge_ * huge_;
+    ::munmap(p, size);
+    mapped_.fetch_sub(size,
+        std::memory_order_relaxed);
+}
+
+auto
+huge_page_arena::
+stats() const noexcept ->
+    stats_type
+{
+    stats_type st;
+    st.hugetlb_allocations = n_hugetlb_.load(
+        std::memory_order_relaxed);
+    st.transparent_allocations = n_transparent_.load(
+        std::memory_order_relaxed);
+    st.normal_allocations = n_normal_.load(
+        std::memory_order_relaxed);
+    st.small_allocations = n_small_.load(
+        std::memory_order_relaxed);
+    st.bytes_mapped = mapped_.load(
+        std::memory_order_relaxed);
+    return st;
+}
+
+// map n bytes of normal pages,
+// aligned to the huge page size
+void*
+huge_page_arena::
+map_aligned(std::size_t n) noexcept
+{
+    auto const extra = huge_ - page_size();
+    if(n > std::size_t(-1) - extra)
+        return nullptr;
+    void* v = ::mmap(nullptr, n + extra,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(v == MAP_FAILED)
+        return nullptr;
+
+    // trim the ends so the
+    // start is aligned
+    auto const p = static_cast<unsigned char*>(v);
+    auto const a = reinterpret_cast<std::uintptr_t>(p);
+    auto const head = static_cast<std::size_t>(
+        (huge_ - a % huge_) % huge_);
+    if(head > 0)
+        ::munmap(p, head);
+    if(extra > head)
+        ::munmap(p + head + n, extra - head);
+    return p + head;
+}
+
+} // buffers
+} // boost
+
+#endif
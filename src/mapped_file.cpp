@@ -0,0 +1,274 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/mapped_file.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/type_traits.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <boost/static_assert.hpp>
+#include <cerrno>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_const_buffer_sequence<mapped_file>::value);
+
+BOOST_STATIC_ASSERT(
+    is_const_buffer_sequence<mapped_file_buffers>::value);
+
+constexpr std::size_t mapped_file::default_window_size;
+
+mapped_file::
+~mapped_file()
+{
+    release();
+}
+
+mapped_file::
+mapped_file(
+    char const* path,
+    std::uint64_t offset,
+    std::uint64_t length,
+    std::size_t window_size)
+{
+    fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+    if(fd_ == -1)
+        detail::throw_system_error(errno);
+    try
+    {
+        init(offset, length, window_size);
+    }
+    catch(...)
+    {
+        release();
+        throw;
+    }
+}
+
+mapped_file::
+mapped_file(
+    int fd,
+    std::uint64_t offset,
+    std::uint64_t length,
+    std::size_t window_size)
+{
+    fd_ = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if(fd_ == -1)
+        detail::throw_system_error(errno);
+    try
+    {
+        init(offset, length, window_size);
+    }
+    catch(...)
+    {
+        release();
+        throw;
+    }
+}
+
+mapped_file::
+mapped_file(
+    mapped_file&& other) noexcept
+    : fd_(other.fd_)
+    , pos_(other.pos_)
+    , end_(other.end_)
+    , window_(other.window_)
+    , maps_(std::move(other.maps_))
+    , first_(other.first_)
+    , behind_(other.behind_)
+{
+    other.fd_ = -1;
+    other.pos_ = 0;
+    other.end_ = 0;
+    other.maps_.clear();
+    other.behind_ = 0;
+}
+
+mapped_file&
+mapped_file::
+operator=(
+    mapped_file&& other) noexcept
+{
+    if(this != &other)
+    {
+        release();
+        fd_ = other.fd_;
+        pos_ = other.pos_;
+        end_ = other.end_;
+        window_ = other.window_;
+        maps_ = std::move(other.maps_);
+        first_ = other.first_;
+        behind_ = other.behind_;
+        other.fd_ = -1;
+        other.pos_ = 0;
+        other.end_ = 0;
+        other.maps_.clear();
+        other.behind_ = 0;
+    }
+    return *this;
+}
+
+std::size_t
+mapped_file::
+mapped_windows() const noexcept
+{
+    std::size_t n = 0;
+    for(auto p : maps_)
+        if(p)
+            ++n;
+    return n;
+}
+
+void
+mapped_file::
+consume(std::size_t n) noexcept
+{
+    if(n > end_ - pos_)
+        n = static_cast<
+            std::size_t>(end_ - pos_);
+    pos_ += n;
+
+    // unmap the windows which
+    // end at or before the cursor
+    auto const behind = behind_;
+    for(; behind_ < maps_.size(); ++behind_)
+    {
+        auto const hi = (first_ + behind_) *
+            window_ + window_bytes(behind_);
+        if(hi > pos_)
+            break;
+        auto& p = maps_[behind_];
+        if(! p)
+            continue;
+        ::munmap(const_cast<unsigned char*>(p),
+            window_bytes(behind_));
+        p = nullptr;
+    }
+
+    // read ahead of the new cursor window
+    if(behind_ != behind)
+        advise(behind_ + 1);
+}
+
+void
+mapped_file::
+init(
+    std::uint64_t offset,
+    std::uint64_t length,
+    std::size_t window_size)
+{
+    auto const page = static_cast<
+        std::size_t>(::sysconf(_SC_PAGESIZE));
+    if( window_size == 0 ||
+        window_size % page != 0)
+        detail::throw_invalid_argument();
+
+    struct stat st;
+    if(::fstat(fd_, &st) == -1)
+        detail::throw_system_error(errno);
+    auto const size = static_cast<
+        std::uint64_t>(st.st_size);
+
+    // offset past the end of the file
+    if(offset > size)
+        detail::throw_invalid_argument();
+    if(length > size - offset)
+        length = size - offset;
+
+    window_ = window_size;
+    pos_ = offset;
+    end_ = offset + length;
+    first_ = offset / window_;
+    if(length == 0)
+        return;
+
+    // map the whole range at once, so
+    // iterating never maps or throws;
+    // consume unmaps it window by window
+    auto const lo = first_ * window_;
+    if(end_ - lo > std::size_t(-1))
+        detail::throw_system_error(ENOMEM);
+    auto const n = static_cast<
+        std::size_t>(end_ - lo);
+    maps_.resize(static_cast<std::size_t>(
+        (end_ - 1) / window_ + 1 - first_));
+    void* v = ::mmap(nullptr, n, PROT_READ,
+        MAP_SHARED, fd_, static_cast<off_t>(lo));
+    if(v == MAP_FAILED)
+    {
+        maps_.clear();
+        detail::throw_system_error(errno);
+    }
+
+    // advice is only a hint, so
+    // failures are not reported
+    ::madvise(v, n, MADV_SEQUENTIAL);
+    auto const p =
+        static_cast<unsigned char const*>(v);
+    for(std::size_t i = 0; i < maps_.size(); ++i)
+        maps_[i] = p + i * window_;
+    advise(0);
+    advise(1);
+}
+
+// the last window ends with the range
+std::size_t
+mapped_file::
+window_bytes(std::size_t i) const noexcept
+{
+    auto const lo = (first_ + i) * window_;
+    auto hi = lo + window_;
+    if(hi > end_)
+        hi = end_;
+    return static_cast<std::size_t>(hi - lo);
+}
+
+void
+mapped_file::
+advise(std::size_t i) const noexcept
+{
+    if(i >= maps_.size() || ! maps_[i])
+        return;
+    ::madvise(const_cast<unsigned char*>(
+        maps_[i]), window_bytes(i),
+        MADV_WILLNEED);
+}
+
+void
+mapped_file::
+release() noexcept
+{
+    for(std::size_t i = 0; i < maps_.size(); ++i)
+    {
+        auto const p = maps_[i];
+        if(! p)
+            continue;
+        ::munmap(const_cast<unsigned char*>(p),
+            window_bytes(i));
+    }
+    maps_.clear();
+    behind_ = 0;
+    if(fd_ != -1)
+        ::close(fd_);
+    fd_ = -1;
+}
+
+} // buffers
+} // boost
+
+#endif
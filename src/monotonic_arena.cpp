@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/monotonic_arena.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <cstdint>
+
+namespace boost {
+namespace buffers {
+
+namespace {
+
+// return p advanced to a multiple of align,
+// or null if that passes the end
+unsigned char*
+align_up(
+    unsigned char* p,
+    unsigned char* end,
+    std::size_t align) noexcept
+{
+    auto const a = reinterpret_cast<
+        std::uintptr_t>(p);
+    auto const pad = static_cast<std::size_t>(
+        (align - a % align) % align);
+    if(pad > static_cast<std::size_t>(end - p))
+        return nullptr;
+    return p + pad;
+}
+
+} // (anon)
+
+constexpr std::size_t monotonic_arena::default_chunk_size;
+
+monotonic_arena::
+~monotonic_arena()
+{
+    release();
+}
+
+monotonic_arena::
+monotonic_arena(
+    std::size_t next_chunk_size) noexcept
+    : monotonic_arena(
+        nullptr, 0, next_chunk_size)
+{
+}
+
+monotonic_arena::
+monotonic_arena(
+    void* buffer,
+    std::size_t size,
+    std::size_t next_chunk_size) noexcept
+    : initial_(static_cast<
+        unsigned char*>(buffer))
+    , initial_size_(size)
+    , p_(initial_)
+    , end_(initial_ + size)
+    , next_size_(next_chunk_size)
+{
+    if(next_size_ < sizeof(chunk))
+        next_size_ = sizeof(chunk);
+}
+
+void*
+monotonic_arena::
+allocate(
+    std::size_t n,
+    std::size_t align)
+{
+    if( align == 0 ||
+        (align & (align - 1)) != 0)
+        detail::throw_invalid_argument();
+    if(p_)
+    {
+        auto const p = align_up(p_, end_, align);
+        if(p && n <= static_cast<
+            std::size_t>(end_ - p))
+        {
+            p_ = p + n;
+            used_ += n;
+            return p;
+        }
+    }
+    return allocate_slow(n, align);
+}
+
+void
+monotonic_arena::
+release() noexcept
+{
+    auto c = head_;
+    while(c)
+    {
+        auto const next = c->next;
+        ::operator delete(c);
+        c = next;
+    }
+    head_ = nullptr;
+    tail_ = nullptr;
+    chunks_ = 0;
+    reserved_ = 0;
+    reset();
+}
+
+// the current region is exhausted, so move
+// to the next chunk which can hold the
+// request, obtaining one if necessary
+void*
+monotonic_arena::
+allocate_slow(
+    std::size_t n,
+    std::size_t align)
+{
+    auto c = cur_ ? cur_->next : head_;
+    for(; c; c = c->next)
+    {
+        auto const first =
+            reinterpret_cast<unsigned char*>(c + 1);
+        auto const last = first + c->size;
+        auto const p = align_up(first, last, align);
+        if(p && n <= static_cast<
+            std::size_t>(last - p))
+        {
+            cur_ = c;
+            end_ = last;
+            p_ = p + n;
+            used_ += n;
+            return p;
+        }
+    }
+
+    // chunks are aligned for any fundamental
+    // type, so only a stricter alignment
+    // needs room for padding
+    std::size_t pad = 0;
+    if(align > alignof(std::max_align_t))
+        pad = align - alignof(std::max_align_t);
+    auto const limit =
+        std::size_t(-1) - sizeof(chunk);
+    if(n > limit - pad)
+        throw_exception(std::bad_alloc());
+    auto size = next_size_;
+    if(size < n + pad)
+        size = n + pad;
+    c = static_cast<chunk*>(
+        ::operator new(sizeof(chunk) + size));
+    c->next = nullptr;
+    c->size = size;
+    if(tail_)
+        tail_->next = c;
+    else
+        head_ = c;
+    tail_ = c;
+    ++chunks_;
+    reserved_ += size;
+    if(next_size_ <= limit / 2)
+        next_size_ *= 2;
+
+    auto const first =
+        reinterpret_cast<unsigned char*>(c + 1);
+    auto const p = align_up(
+        first, first + size, align);
+    cur_ = c;
+    end_ = first + size;
+    p_ = p + n;
+    used_ += n;
+    return p;
+}
+
+} // buffers
+} // boost
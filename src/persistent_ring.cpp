@@ -0,0 +1,370 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/persistent_ring.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/type_traits.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <boost/static_assert.hpp>
+#include <atomic>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+namespace detail {
+
+// One recorded state. The sequence number
+// is stored last, and the checksum covers
+// it, so a slot torn by a crash is invalid.
+struct persistent_ring_slot
+{
+    std::atomic<std::uint64_t> seq;
+    std::atomic<std::uint64_t> pos;
+    std::atomic<std::uint64_t> len;
+    std::atomic<std::uint64_t> sum;
+};
+
+// The layout of the start of the file. The
+// slot for sequence number s is slot[s % 2].
+struct persistent_ring_header
+{
+    std::atomic<std::uint64_t> magic;
+    std::uint64_t capacity;
+    persistent_ring_slot slot[2];
+};
+
+} // detail
+
+namespace {
+
+// "bbplog01"
+constexpr std::uint64_t ring_magic =
+    0x3130676f6c706262ULL;
+
+std::size_t
+page_size() noexcept
+{
+    return static_cast<std::size_t>(
+        ::sysconf(_SC_PAGESIZE));
+}
+
+// a whole number of pages, so
+// the storage is page-aligned
+std::size_t
+header_size() noexcept
+{
+    auto const ps = page_size();
+    return (sizeof(detail::persistent_ring_header) +
+        ps - 1) / ps * ps;
+}
+
+std::uint64_t
+checksum(
+    std::uint64_t capacity,
+    std::uint64_t seq,
+    std::uint64_t pos,
+    std::uint64_t len) noexcept
+{
+    // FNV-1a over the words, then a final mix
+    std::uint64_t const w[4] = {
+        capacity, seq, pos, len };
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for(auto v : w)
+    {
+        h ^= v;
+        h *= 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+} // (anon)
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<persistent_ring>::value);
+
+persistent_ring::
+~persistent_ring()
+{
+    release();
+}
+
+persistent_ring::
+persistent_ring(
+    char const* path,
+    std::size_t capacity)
+{
+    if(capacity == 0)
+        detail::throw_invalid_argument();
+    auto const hs = header_size();
+    if(capacity > std::size_t(-1) - hs)
+        detail::throw_invalid_argument();
+    auto const size = hs + capacity;
+
+    fd_ = ::open(path,
+        O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if(fd_ == -1)
+        detail::throw_system_error(errno);
+    try
+    {
+        struct stat st;
+        if(::fstat(fd_, &st) == -1)
+            detail::throw_system_error(errno);
+        if(st.st_size == 0)
+        {
+            if(::ftruncate(fd_,
+                    static_cast<off_t>(size)) == -1)
+                detail::throw_system_error(errno);
+        }
+        else if(static_cast<std::uint64_t>(
+            st.st_size) != size)
+        {
+            detail::throw_invalid_argument();
+        }
+
+        void* p = ::mmap(nullptr, size,
+            PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if(p == MAP_FAILED)
+            detail::throw_system_error(errno);
+        h_ = static_cast<
+            detail::persistent_ring_header*>(p);
+        base_ = static_cast<unsigned char*>(p) + hs;
+        cap_ = capacity;
+        map_size_ = size;
+
+        // a new file, or one whose formatting
+        // was cut short, is zero-filled
+        auto const magic = h_->magic.load(
+            std::memory_order_acquire);
+        if(magic == 0)
+        {
+            h_->capacity = capacity;
+            seq_ = 0;
+            publish();
+            h_->magic.store(ring_magic,
+                std::memory_order_release);
+            if(::msync(h_, hs, MS_SYNC) != 0)
+                detail::throw_system_error(errno);
+            return;
+        }
+        if( magic != ring_magic ||
+            h_->capacity != capacity)
+            detail::throw_invalid_argument();
+
+        // recover the newest valid state
+        bool found = false;
+        for(auto& s : h_->slot)
+        {
+            auto const seq = s.seq.load(
+                std::memory_order_acquire);
+            auto const pos = s.pos.load(
+                std::memory_order_relaxed);
+            auto const len = s.len.load(
+                std::memory_order_relaxed);
+            if( seq == 0 ||
+                pos >= capacity ||
+                len > capacity ||
+                s.sum.load(std::memory_order_relaxed) !=
+                    checksum(capacity, seq, pos, len))
+                continue;
+            if(found && seq <= seq_)
+                continue;
+            found = true;
+            seq_ = seq;
+            in_pos_ = static_cast<std::size_t>(pos);
+            in_len_ = static_cast<std::size_t>(len);
+        }
+        if(! found)
+            detail::throw_invalid_argument();
+    }
+    catch(...)
+    {
+        release();
+        throw;
+    }
+}
+
+auto
+persistent_ring::
+data() const noexcept ->
+    const_buffers_type
+{
+    if(in_pos_ + in_len_ <= cap_)
+        return {
+            const_buffer{
+                base_ + in_pos_, in_len_ },
+            const_buffer{ base_, 0} };
+    return {
+        const_buffer{
+            base_ + in_pos_, cap_ - in_pos_},
+        const_buffer{
+            base_, in_len_- (cap_ - in_pos_)}};
+}
+
+auto
+persistent_ring::
+prepare(std::size_t n) ->
+    mutable_buffers_type
+{
+    // Buffer is too small for n
+    if(n > cap_ - in_len_)
+        detail::throw_length_error();
+
+    out_size_ = n;
+    auto const pos = (
+        in_pos_ + in_len_) % cap_;
+    if(pos + n <= cap_)
+        return {
+            mutable_buffer{
+                base_ + pos, n},
+            mutable_buffer{base_, 0}};
+    return {
+        mutable_buffer{
+            base_ + pos, cap_ - pos},
+        mutable_buffer{
+            base_, n - (cap_ - pos)}};
+}
+
+void
+persistent_ring::
+commit(std::size_t n) noexcept
+{
+    if(n > out_size_)
+        n = out_size_;
+    out_size_ = 0;
+    if(n == 0)
+        return;
+    in_len_ += n;
+    dirty_ += n;
+    if(dirty_ > cap_)
+        dirty_ = cap_;
+    publish();
+}
+
+void
+persistent_ring::
+consume(std::size_t n) noexcept
+{
+    if(n == 0 || in_len_ == 0)
+        return;
+    if(n < in_len_)
+    {
+        in_pos_ = (in_pos_ + n) % cap_;
+        in_len_ -= n;
+    }
+    else
+    {
+        // make prepare return a
+        // bigger single buffer
+        in_pos_ = 0;
+        in_len_ = 0;
+    }
+
+    // consumed bytes need no sync
+    if(dirty_ > in_len_)
+        dirty_ = in_len_;
+    publish();
+}
+
+void
+persistent_ring::
+sync()
+{
+    if(dirty_ > 0)
+    {
+        // the dirty bytes end the readable bytes
+        auto const end =
+            (in_pos_ + in_len_) % cap_;
+        auto const pos =
+            (end + cap_ - dirty_) % cap_;
+        if(pos + dirty_ <= cap_)
+        {
+            msync_storage(pos, dirty_);
+        }
+        else
+        {
+            msync_storage(pos, cap_ - pos);
+            msync_storage(0, dirty_ - (cap_ - pos));
+        }
+        dirty_ = 0;
+    }
+    if(::msync(h_, static_cast<std::size_t>(
+            base_ - reinterpret_cast<
+                unsigned char*>(h_)), MS_SYNC) != 0)
+        detail::throw_system_error(errno);
+}
+
+//------------------------------------------------
+
+// record the current state in the
+// slot which does not hold the last
+void
+persistent_ring::
+publish() noexcept
+{
+    ++seq_;
+    auto& s = h_->slot[seq_ % 2];
+    s.pos.store(in_pos_,
+        std::memory_order_relaxed);
+    s.len.store(in_len_,
+        std::memory_order_relaxed);
+    s.sum.store(checksum(cap_,
+        seq_, in_pos_, in_len_),
+        std::memory_order_relaxed);
+
+    // orders the bytes and the fields above
+    s.seq.store(seq_,
+        std::memory_order_release);
+}
+
+void
+persistent_ring::
+msync_storage(
+    std::size_t pos,
+    std::size_t n)
+{
+    // msync requires a page-aligned address,
+    // and the storage starts on a page
+    auto const ps = page_size();
+    auto const lo = pos / ps * ps;
+    if(::msync(base_ + lo, pos + n - lo,
+            MS_SYNC) != 0)
+        detail::throw_system_error(errno);
+}
+
+void
+persistent_ring::
+release() noexcept
+{
+    if(h_)
+    {
+        ::munmap(h_, map_size_);
+        h_ = nullptr;
+    }
+    if(fd_ != -1)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+} // buffers
+} // boost
+
+#endif
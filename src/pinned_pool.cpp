@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/pinned_pool.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/detail/except.hpp>
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <cerrno>
+#include <new>
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+namespace {
+
+std::size_t
+page_size() noexcept
+{
+    return static_cast<std::size_t>(
+        ::sysconf(_SC_PAGESIZE));
+}
+
+} // (anon)
+
+auto
+pinned_pool::
+page_faults() noexcept ->
+    fault_counts
+{
+    fault_counts fc;
+    struct rusage ru;
+#if defined(RUSAGE_THREAD)
+    if(::getrusage(RUSAGE_THREAD, &ru) != 0)
+        return fc;
+#else
+    if(::getrusage(RUSAGE_SELF, &ru) != 0)
+        return fc;
+#endif
+    fc.minor = static_cast<std::uint64_t>(ru.ru_minflt);
+    fc.major = static_cast<std::uint64_t>(ru.ru_majflt);
+    return fc;
+}
+
+pinned_pool::
+~pinned_pool()
+{
+    BOOST_ASSERT(free_.size() == n_);
+    ::munmap(base_, block_ * n_);
+}
+
+pinned_pool::
+pinned_pool()
+    : pinned_pool(options())
+{
+}
+
+pinned_pool::
+pinned_pool(
+    options const& opt)
+    : block_(opt.block_size)
+    , n_(opt.blocks)
+{
+    if(block_ == 0 || n_ == 0)
+        detail::throw_invalid_argument();
+    auto const ps = page_size();
+    if(block_ > std::size_t(-1) - ps)
+        throw_exception(std::bad_alloc());
+    block_ = (block_ + ps - 1) / ps * ps;
+    if(n_ > std::size_t(-1) / block_)
+        throw_exception(std::bad_alloc());
+    auto const size = block_ * n_;
+
+    // every block is on the free list, so
+    // deallocate never needs to grow it
+    free_.reserve(n_);
+
+    before_ = page_faults();
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_POPULATE)
+    flags |= MAP_POPULATE;
+#endif
+    void* p = ::mmap(nullptr, size,
+        PROT_READ | PROT_WRITE, flags, -1, 0);
+    if(p == MAP_FAILED)
+        detail::throw_system_error(errno);
+    base_ = static_cast<unsigned char*>(p);
+
+    // write every page, so none is left
+    // mapped to the shared zero page
+    for(std::size_t i = 0; i < size; i += ps)
+        static_cast<unsigned char volatile*>(
+            base_)[i] = 0;
+    if(opt.lock)
+        locked_ = ::mlock(base_, size) == 0;
+    after_ = page_faults();
+
+    // lowest addresses are handed out first
+    for(std::size_t i = n_; i > 0; --i)
+        free_.push_back(i - 1);
+}
+
+mutable_buffer
+pinned_pool::
+allocate()
+{
+    if(free_.empty())
+        throw_exception(std::bad_alloc());
+    auto const i = free_.back();
+    free_.pop_back();
+    return { base_ + i * block_, block_ };
+}
+
+void
+pinned_pool::
+deallocate(void* p) noexcept
+{
+    auto const off = static_cast<std::size_t>(
+        static_cast<unsigned char*>(p) - base_);
+    BOOST_ASSERT(off % block_ == 0);
+    BOOST_ASSERT(off / block_ < n_);
+    BOOST_ASSERT(free_.size() < n_);
+    free_.push_back(off / block_);
+}
+
+auto
+pinned_pool::
+stats() const noexcept ->
+    stats_type
+{
+    stats_type st;
+    st.blocks_free = free_.size();
+    st.blocks_in_use = n_ - free_.size();
+    st.bytes_mapped = block_ * n_;
+    st.locked = locked_;
+    st.before_warmup = before_;
+    st.after_warmup = after_;
+    return st;
+}
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,123 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/record_ring.hpp>
+#include <boost/buffers/algorithm.hpp>
+#include <boost/buffers/make_buffer.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <boost/assert.hpp>
+
+namespace boost {
+namespace buffers {
+
+namespace {
+
+// read the header at the
+// front of the sequence
+std::size_t
+read_header(
+    const_buffer_pair const& bs) noexcept
+{
+    std::uint32_t n = 0;
+    BOOST_ASSERT(buffer_size(bs) >=
+        record_ring::header_size);
+    buffer_copy(make_buffer(
+        &n, sizeof(n)), bs);
+    return n;
+}
+
+} // (anon)
+
+constexpr std::size_t record_ring::header_size;
+
+const_buffer_pair
+record_ring::
+front() const noexcept
+{
+    BOOST_ASSERT(! empty());
+    auto const d = cb_.data();
+    return prefix(sans_prefix(
+        d, header_size), read_header(d));
+}
+
+void
+record_ring::
+pop(std::size_t k) noexcept
+{
+    while(k-- > 0 && count_ > 0)
+    {
+        cb_.consume(header_size +
+            read_header(cb_.data()));
+        --count_;
+    }
+}
+
+auto
+record_ring::
+gather(
+    const_buffer* dest,
+    std::size_t n,
+    std::size_t k) const noexcept ->
+        gather_result
+{
+    gather_result r{ 0, 0, 0 };
+    auto const d = cb_.data();
+    std::size_t pos = 0;
+    while(
+        r.records < k &&
+        r.records < count_)
+    {
+        auto const rest =
+            sans_prefix(d, pos);
+        auto const len = read_header(rest);
+        auto const bs = prefix(sans_prefix(
+            rest, header_size), len);
+        std::size_t nb = 0;
+        for(auto b : bs)
+            if(b.size() > 0)
+                ++nb;
+        if(nb > n - r.buffers)
+            break;
+        for(auto b : bs)
+            if(b.size() > 0)
+                dest[r.buffers++] = b;
+        ++r.records;
+        r.bytes += len;
+        pos += header_size + len;
+    }
+    return r;
+}
+
+mutable_buffer_pair
+record_ring::
+prepare(std::size_t n)
+{
+    // record is too large
+    if(! fits(n))
+        detail::throw_length_error();
+
+    auto const mb =
+        cb_.prepare(header_size + n);
+    std::uint32_t const h =
+        static_cast<std::uint32_t>(n);
+    buffer_copy(mb, make_buffer(
+        &h, sizeof(h)));
+    return sans_prefix(mb, header_size);
+}
+
+void
+record_ring::
+commit(std::size_t n) noexcept
+{
+    cb_.commit(header_size + n);
+    ++count_;
+}
+
+} // buffers
+} // boost
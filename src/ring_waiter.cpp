@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/ring_waiter.hpp>
+#include <boost/static_assert.hpp>
+#include <climits>
+
+#if defined(__linux__)
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <time.h>
+# include <unistd.h>
+#endif
+
+namespace boost {
+namespace buffers {
+
+// The futex operates on the object
+// representation of the atomic word.
+BOOST_STATIC_ASSERT(
+    sizeof(std::atomic<std::uint32_t>) ==
+        sizeof(std::uint32_t));
+
+#if defined(__linux__)
+
+// FUTEX_PRIVATE_FLAG is deliberately not
+// used, so a waiter placed in shared memory
+// can be woken from another process.
+
+void
+ring_waiter::
+park(
+    std::uint32_t expected,
+    std::chrono::nanoseconds timeout) noexcept
+{
+    timespec ts;
+    timespec* pts = nullptr;
+    if(timeout != (std::chrono::nanoseconds::max)())
+    {
+        auto const ns = timeout.count();
+        ts.tv_sec = static_cast<
+            time_t>(ns / 1000000000);
+        ts.tv_nsec = static_cast<
+            long>(ns % 1000000000);
+        pts = &ts;
+    }
+    // returns immediately with EAGAIN if the
+    // word changed after it was loaded
+    ::syscall(SYS_futex,
+        reinterpret_cast<std::uint32_t*>(&word_),
+        FUTEX_WAIT, expected,
+        pts, nullptr, 0);
+}
+
+void
+ring_waiter::
+wake(bool all) noexcept
+{
+    ::syscall(SYS_futex,
+        reinterpret_cast<std::uint32_t*>(&word_),
+        FUTEX_WAKE, all ? INT_MAX : 1,
+        nullptr, nullptr, 0);
+}
+
+#else
+
+void
+ring_waiter::
+park(
+    std::uint32_t expected,
+    std::chrono::nanoseconds timeout) noexcept
+{
+    if(word_.load(
+        std::memory_order_acquire) != expected)
+        return;
+    std::chrono::nanoseconds const poll =
+        std::chrono::microseconds(50);
+    std::this_thread::sleep_for(
+        timeout < poll ? timeout : poll);
+}
+
+void
+ring_waiter::
+wake(bool) noexcept
+{
+}
+
+#endif
+
+} // buffers
+} // boost
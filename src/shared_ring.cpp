@@ -0,0 +1,520 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/shared_ring.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/type_traits.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <boost/static_assert.hpp>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+namespace detail {
+
+// The layout of the start of the segment.
+// Positions count bytes since creation, so
+// the offset into the storage is the
+// position modulo the capacity.
+struct shared_ring_header
+{
+    std::atomic<std::uint64_t> magic;
+    std::uint64_t capacity;
+
+    // written by the producer
+    alignas(64) std::atomic<std::uint64_t> head;
+    std::atomic<std::int32_t> producer_pid;
+    ring_waiter not_full;
+
+    // written by the consumer
+    alignas(64) std::atomic<std::uint64_t> tail;
+    std::atomic<std::int32_t> consumer_pid;
+    ring_waiter not_empty;
+};
+
+} // detail
+
+// The header is shared between processes,
+// which needs atomics that are not
+// implemented with a lock
+#ifdef __cpp_lib_atomic_is_always_lock_free
+BOOST_STATIC_ASSERT(
+    std::atomic<std::uint64_t>::is_always_lock_free);
+BOOST_STATIC_ASSERT(
+    std::atomic<std::int32_t>::is_always_lock_free);
+#else
+BOOST_STATIC_ASSERT(ATOMIC_LLONG_LOCK_FREE == 2);
+BOOST_STATIC_ASSERT(ATOMIC_INT_LOCK_FREE == 2);
+#endif
+
+namespace {
+
+// "bbring01"
+constexpr std::uint64_t ring_magic =
+    0x3130676e69726262ULL;
+
+// the pid recorded for a role which was
+// released; zero means never attached
+constexpr std::int32_t closed_pid = -1;
+
+constexpr std::size_t
+header_size() noexcept
+{
+    return (sizeof(detail::shared_ring_header) + 63) & ~std::size_t(63);
+}
+
+std::atomic<std::int32_t>&
+role_pid(
+    detail::shared_ring_header& h,
+    int role) noexcept
+{
+    if(role == shared_ring::producer)
+        return h.producer_pid;
+    return h.consumer_pid;
+}
+
+bool
+is_alive(std::int32_t pid) noexcept
+{
+    if(pid <= 0)
+        return false;
+    if(::kill(pid, 0) == 0)
+        return true;
+    return errno == EPERM;
+}
+
+// how often a blocked side checks its peer
+constexpr std::chrono::milliseconds
+    peer_poll_interval{50};
+
+} // (anon)
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<shared_ring>::value);
+
+int
+shared_ring::
+create(
+    std::size_t capacity,
+    char const* name)
+{
+    if(capacity == 0)
+        detail::throw_invalid_argument();
+
+    int fd;
+    if(name)
+    {
+        fd = ::shm_open(name,
+            O_RDWR | O_CREAT | O_EXCL, 0600);
+    }
+    else
+    {
+#if defined(__linux__)
+        fd = ::memfd_create(
+            "boost.buffers.shared_ring",
+            MFD_CLOEXEC);
+#else
+        // create a unique name and
+        // unlink it immediately
+        char tmp[64];
+        for(unsigned i = 0;; ++i)
+        {
+            std::snprintf(tmp, sizeof(tmp),
+                "/boost.buffers.%ld.%u",
+                static_cast<long>(::getpid()), i);
+            fd = ::shm_open(tmp,
+                O_RDWR | O_CREAT | O_EXCL, 0600);
+            if(fd != -1 || errno != EEXIST)
+                break;
+        }
+        if(fd != -1)
+            ::shm_unlink(tmp);
+#endif
+    }
+    if(fd == -1)
+        detail::throw_system_error(errno);
+
+    auto const size = segment_size(capacity);
+    if(::ftruncate(fd,
+        static_cast<off_t>(size)) == -1)
+    {
+        int const ev = errno;
+        ::close(fd);
+        if(name)
+            ::shm_unlink(name);
+        detail::throw_system_error(ev);
+    }
+    void* p = ::mmap(nullptr, header_size(),
+        PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(p == MAP_FAILED)
+    {
+        int const ev = errno;
+        ::close(fd);
+        if(name)
+            ::shm_unlink(name);
+        detail::throw_system_error(ev);
+    }
+
+    // the segment is zero-filled, which is
+    // the initial state of every member
+    auto h = ::new(p)
+        detail::shared_ring_header();
+    h->capacity = capacity;
+    h->magic.store(ring_magic,
+        std::memory_order_release);
+    ::munmap(p, header_size());
+    return fd;
+}
+
+std::size_t
+shared_ring::
+segment_size(
+    std::size_t capacity) noexcept
+{
+    return header_size() + capacity;
+}
+
+shared_ring::
+~shared_ring()
+{
+    release();
+}
+
+shared_ring::
+shared_ring(
+    int fd,
+    role_type role)
+{
+    struct stat st;
+    if(::fstat(fd, &st) == -1)
+        detail::throw_system_error(errno);
+    auto const size =
+        static_cast<std::size_t>(st.st_size);
+    if(size <= header_size())
+        detail::throw_invalid_argument();
+
+    void* p = ::mmap(nullptr, size,
+        PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(p == MAP_FAILED)
+        detail::throw_system_error(errno);
+
+    auto const h = static_cast<
+        detail::shared_ring_header*>(p);
+    if( h->magic.load(
+            std::memory_order_acquire) != ring_magic ||
+        h->capacity != size - header_size())
+    {
+        ::munmap(p, size);
+        detail::throw_invalid_argument();
+    }
+
+    // claim the role, taking it over from a
+    // process which died or released it. A
+    // second claim from this process fails too
+    auto& pid = role_pid(*h, role);
+    std::int32_t const self = ::getpid();
+    auto cur = pid.load();
+    for(;;)
+    {
+        if(is_alive(cur))
+        {
+            ::munmap(p, size);
+            detail::throw_system_error(EBUSY);
+        }
+        if(pid.compare_exchange_weak(cur, self))
+            break;
+    }
+
+    h_ = h;
+    base_ = static_cast<
+        unsigned char*>(p) + header_size();
+    cap_ = static_cast<std::size_t>(h->capacity);
+    map_size_ = size;
+    role_ = role;
+}
+
+shared_ring::
+shared_ring(
+    shared_ring&& other) noexcept
+    : h_(other.h_)
+    , base_(other.base_)
+    , cap_(other.cap_)
+    , map_size_(other.map_size_)
+    , out_size_(other.out_size_)
+    , role_(other.role_)
+{
+    other.h_ = nullptr;
+    other.base_ = nullptr;
+    other.cap_ = 0;
+    other.map_size_ = 0;
+    other.out_size_ = 0;
+    other.role_ = 0;
+}
+
+shared_ring&
+shared_ring::
+operator=(
+    shared_ring&& other) noexcept
+{
+    if(this != &other)
+    {
+        release();
+        h_ = other.h_;
+        base_ = other.base_;
+        cap_ = other.cap_;
+        map_size_ = other.map_size_;
+        out_size_ = other.out_size_;
+        role_ = other.role_;
+        other.h_ = nullptr;
+        other.base_ = nullptr;
+        other.cap_ = 0;
+        other.map_size_ = 0;
+        other.out_size_ = 0;
+        other.role_ = 0;
+    }
+    return *this;
+}
+
+void
+shared_ring::
+release() noexcept
+{
+    if(! h_)
+        return;
+    role_pid(*h_, role_).store(closed_pid);
+
+    // a side which blocks on the
+    // other must notice the detach
+    if(role_ == producer)
+        h_->not_empty.notify();
+    else
+        h_->not_full.notify();
+    ::munmap(h_, map_size_);
+    h_ = nullptr;
+}
+
+std::size_t
+shared_ring::
+size() const noexcept
+{
+    if(! h_)
+        return 0;
+    auto const head = h_->head.load(
+        std::memory_order_acquire);
+    auto const tail = h_->tail.load(
+        std::memory_order_acquire);
+    return static_cast<
+        std::size_t>(head - tail);
+}
+
+auto
+shared_ring::
+data() const noexcept ->
+    const_buffers_type
+{
+    BOOST_ASSERT(role_ == consumer);
+    auto const head = h_->head.load(
+        std::memory_order_acquire);
+    auto const tail = h_->tail.load(
+        std::memory_order_relaxed);
+    auto const len = static_cast<
+        std::size_t>(head - tail);
+    auto const pos = static_cast<
+        std::size_t>(tail % cap_);
+    if(pos + len <= cap_)
+        return {
+            const_buffer{
+                base_ + pos, len },
+            const_buffer{ base_, 0 } };
+    return {
+        const_buffer{
+            base_ + pos, cap_ - pos },
+        const_buffer{
+            base_, len - (cap_ - pos) } };
+}
+
+auto
+shared_ring::
+prepare(std::size_t n) ->
+    mutable_buffers_type
+{
+    BOOST_ASSERT(role_ == producer);
+    auto const head = h_->head.load(
+        std::memory_order_relaxed);
+    auto const tail = h_->tail.load(
+        std::memory_order_acquire);
+
+    // Buffer is too small for n
+    if(n > cap_ - static_cast<
+            std::size_t>(head - tail))
+        detail::throw_length_error();
+
+    out_size_ = n;
+    auto const pos = static_cast<
+        std::size_t>(head % cap_);
+    if(pos + n <= cap_)
+        return {
+            mutable_buffer{
+                base_ + pos, n },
+            mutable_buffer{ base_, 0 } };
+    return {
+        mutable_buffer{
+            base_ + pos, cap_ - pos },
+        mutable_buffer{
+            base_, n - (cap_ - pos) } };
+}
+
+void
+shared_ring::
+commit(std::size_t n) noexcept
+{
+    BOOST_ASSERT(role_ == producer);
+    if(n > out_size_)
+        n = out_size_;
+    out_size_ = 0;
+    if(n == 0)
+        return;
+    h_->head.fetch_add(n,
+        std::memory_order_release);
+    h_->not_empty.notify();
+}
+
+void
+shared_ring::
+consume(std::size_t n) noexcept
+{
+    BOOST_ASSERT(role_ == consumer);
+    auto const head = h_->head.load(
+        std::memory_order_acquire);
+    auto const tail = h_->tail.load(
+        std::memory_order_relaxed);
+    if(n > head - tail)
+        n = static_cast<
+            std::size_t>(head - tail);
+    if(n == 0)
+        return;
+    h_->tail.fetch_add(n,
+        std::memory_order_release);
+    h_->not_full.notify();
+}
+
+bool
+shared_ring::
+wait_readable(
+    wait_options const& opt)
+{
+    BOOST_ASSERT(role_ == consumer);
+    auto const pred = [this]
+        {
+            return size() > 0;
+        };
+    // the peer is checked each time
+    // the waiter stops parking
+    std::chrono::nanoseconds const poll =
+        peer_poll_interval;
+    auto o = opt;
+    auto remain = opt.park_timeout;
+    for(;;)
+    {
+        o.park_timeout = remain < poll
+            ? remain : poll;
+        if(h_->not_empty.wait(pred, o))
+            return true;
+
+        // a producer which has yet to
+        // attach is waited for
+        auto const ps = peer();
+        if( ps == peer_state::closed ||
+            ps == peer_state::dead)
+            return pred();
+        if(remain != (std::chrono::nanoseconds::max)())
+        {
+            remain -= o.park_timeout;
+            if(remain.count() <= 0)
+                return false;
+        }
+        o.spin_time = std::chrono::nanoseconds(0);
+        o.yield_count = 0;
+    }
+}
+
+bool
+shared_ring::
+wait_writable(
+    std::size_t n,
+    wait_options const& opt)
+{
+    BOOST_ASSERT(role_ == producer);
+    if(n > cap_)
+        detail::throw_length_error();
+    auto const pred = [this, n]
+        {
+            return capacity() >= n;
+        };
+    std::chrono::nanoseconds const poll =
+        peer_poll_interval;
+    auto o = opt;
+    auto remain = opt.park_timeout;
+    for(;;)
+    {
+        o.park_timeout = remain < poll
+            ? remain : poll;
+        if(h_->not_full.wait(pred, o))
+            return true;
+        auto const ps = peer();
+        if( ps == peer_state::closed ||
+            ps == peer_state::dead)
+            return false;
+        if(remain != (std::chrono::nanoseconds::max)())
+        {
+            remain -= o.park_timeout;
+            if(remain.count() <= 0)
+                return false;
+        }
+        o.spin_time = std::chrono::nanoseconds(0);
+        o.yield_count = 0;
+    }
+}
+
+auto
+shared_ring::
+peer() const noexcept ->
+    peer_state
+{
+    BOOST_ASSERT(h_);
+    auto const pid = role_pid(*h_,
+        role_ == producer ? consumer : producer
+            ).load(std::memory_order_acquire);
+    if(pid == 0)
+        return peer_state::detached;
+    if(pid == closed_pid)
+        return peer_state::closed;
+    if(is_alive(pid))
+        return peer_state::alive;
+    return peer_state::dead;
+}
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,415 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/spill_buffer.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/type_traits.hpp>
+#include <boost/buffers/detail/except.hpp>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+namespace {
+
+std::uint64_t
+align_down(std::uint64_t n) noexcept
+{
+    return n & ~std::uint64_t(
+        spill_buffer::window_size - 1);
+}
+
+std::uint64_t
+align_up(std::uint64_t n) noexcept
+{
+    return align_down(n +
+        spill_buffer::window_size - 1);
+}
+
+} // (anon)
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<spill_buffer>::value);
+
+constexpr std::size_t spill_buffer::window_size;
+
+spill_buffer::
+~spill_buffer()
+{
+    release();
+}
+
+spill_buffer::
+spill_buffer(
+    std::size_t memory_limit,
+    std::size_t max_size,
+    char const* dir)
+    : mem_cap_(memory_limit)
+    , max_(max_size)
+{
+    // file offsets must fit in off_t
+    auto const lim = static_cast<std::size_t>(
+        (std::numeric_limits<off_t>::max)() / 2);
+    if(max_ > lim)
+        max_ = lim;
+    if(max_ < mem_cap_)
+        mem_cap_ = max_;
+    if(! dir)
+    {
+        dir = std::getenv("TMPDIR");
+        if(! dir || ! *dir)
+            dir = "/tmp";
+    }
+    dir_ = dir;
+}
+
+spill_buffer::
+spill_buffer(
+    spill_buffer&& other) noexcept
+    : mem_(other.mem_)
+    , mem_cap_(other.mem_cap_)
+    , max_(other.max_)
+    , in_pos_(other.in_pos_)
+    , in_size_(other.in_size_)
+    , out_size_(other.out_size_)
+    , dir_(std::move(other.dir_))
+    , fd_(other.fd_)
+    , file_size_(other.file_size_)
+    , map_(other.map_)
+    , map_pos_(other.map_pos_)
+    , map_size_(other.map_size_)
+{
+    other.mem_ = nullptr;
+    other.in_pos_ = 0;
+    other.in_size_ = 0;
+    other.out_size_ = 0;
+    other.fd_ = -1;
+    other.file_size_ = 0;
+    other.map_ = nullptr;
+    other.map_pos_ = 0;
+    other.map_size_ = 0;
+}
+
+spill_buffer&
+spill_buffer::
+operator=(
+    spill_buffer&& other) noexcept
+{
+    if(this != &other)
+    {
+        release();
+        mem_ = other.mem_;
+        mem_cap_ = other.mem_cap_;
+        max_ = other.max_;
+        in_pos_ = other.in_pos_;
+        in_size_ = other.in_size_;
+        out_size_ = other.out_size_;
+        dir_ = std::move(other.dir_);
+        fd_ = other.fd_;
+        file_size_ = other.file_size_;
+        map_ = other.map_;
+        map_pos_ = other.map_pos_;
+        map_size_ = other.map_size_;
+        other.mem_ = nullptr;
+        other.in_pos_ = 0;
+        other.in_size_ = 0;
+        other.out_size_ = 0;
+        other.fd_ = -1;
+        other.file_size_ = 0;
+        other.map_ = nullptr;
+        other.map_pos_ = 0;
+        other.map_size_ = 0;
+    }
+    return *this;
+}
+
+auto
+spill_buffer::
+data() const noexcept ->
+    const_buffers_type
+{
+    auto const end = in_pos_ + in_size_;
+    if(end <= mem_cap_)
+        return {
+            const_buffer{
+                mem_ + in_pos_, in_size_ },
+            const_buffer{} };
+
+    // the window always covers
+    // the readable bytes in the file
+    auto const lo = in_pos_ > mem_cap_
+        ? in_pos_ - mem_cap_ : 0;
+    auto const hi = end - mem_cap_;
+    BOOST_ASSERT(lo >= map_pos_);
+    BOOST_ASSERT(hi <= map_pos_ + map_size_);
+    const_buffer const fb(
+        map_ + (lo - map_pos_), hi - lo);
+    if(in_pos_ >= mem_cap_)
+        return { fb, const_buffer{} };
+    return {
+        const_buffer{
+            mem_ + in_pos_, mem_cap_ - in_pos_ },
+        fb };
+}
+
+auto
+spill_buffer::
+prepare(std::size_t n) ->
+    mutable_buffers_type
+{
+    // n exceeds available space
+    if(n > max_ - in_size_)
+        detail::throw_length_error();
+
+    // nothing is committable until
+    // the space is obtained
+    out_size_ = 0;
+
+    if( in_pos_ + in_size_ + n > mem_cap_ &&
+        in_pos_ > 0 &&
+        in_size_ <= in_pos_ &&
+        in_size_ <= mem_cap_)
+    {
+        // bring the readable bytes back
+        // to memory instead of spilling
+        rebase();
+    }
+
+    auto const end = in_pos_ + in_size_;
+    if(end < mem_cap_ && ! mem_)
+        mem_ = new unsigned char[mem_cap_];
+    if(end + n <= mem_cap_)
+    {
+        out_size_ = n;
+        return {
+            mutable_buffer{
+                mem_ + end, n },
+            mutable_buffer{} };
+    }
+
+    // part or all of the space is in the file
+    if(fd_ == -1)
+        open_file();
+    auto const lo = in_pos_ > mem_cap_
+        ? in_pos_ - mem_cap_ : 0;
+    auto const wlo = end > mem_cap_
+        ? end - mem_cap_ : 0;
+    auto const whi = end + n - mem_cap_;
+    if( ! map_ || lo < map_pos_ ||
+        whi > map_pos_ + map_size_)
+        map_window(lo, whi);
+    out_size_ = n;
+    mutable_buffer const fb(
+        map_ + (wlo - map_pos_), whi - wlo);
+    if(end >= mem_cap_)
+        return { fb, mutable_buffer{} };
+    return {
+        mutable_buffer{
+            mem_ + end, mem_cap_ - end },
+        fb };
+}
+
+void
+spill_buffer::
+commit(std::size_t n) noexcept
+{
+    if(n < out_size_)
+        in_size_ += n;
+    else
+        in_size_ += out_size_;
+    out_size_ = 0;
+}
+
+void
+spill_buffer::
+consume(std::size_t n) noexcept
+{
+    out_size_ = 0;
+    if(n >= in_size_)
+    {
+        in_pos_ = 0;
+        in_size_ = 0;
+        if(file_size_ > 0)
+        {
+            unmap();
+            if(::ftruncate(fd_, 0) == 0)
+                file_size_ = 0;
+        }
+        return;
+    }
+    in_pos_ += n;
+    in_size_ -= n;
+    if(! map_ || in_pos_ <= mem_cap_)
+        return;
+
+    // unmap the window behind the read
+    // position and free it in the file
+    auto const behind =
+        align_down(in_pos_ - mem_cap_);
+    if(behind <= map_pos_)
+        return;
+    auto const k = static_cast<
+        std::size_t>(behind - map_pos_);
+    ::munmap(map_, k);
+#if defined(__linux__) && defined(FALLOC_FL_PUNCH_HOLE)
+    ::fallocate(fd_,
+        FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+        static_cast<off_t>(map_pos_),
+        static_cast<off_t>(k));
+#endif
+    map_ += k;
+    map_pos_ = behind;
+    map_size_ -= k;
+}
+
+void
+spill_buffer::
+rebase() noexcept
+{
+    auto const end = in_pos_ + in_size_;
+    if(in_size_ > 0)
+    {
+        if(end <= mem_cap_)
+        {
+            std::memmove(mem_,
+                mem_ + in_pos_, in_size_);
+        }
+        else
+        {
+            // the pieces do not overlap the
+            // front of memory, since the bytes
+            // consumed are at least as many
+            auto const b = data();
+            auto const a = b[0].size();
+            std::memmove(mem_, b[0].data(), a);
+            if(b[1].size() > 0)
+                std::memcpy(mem_ + a,
+                    b[1].data(), b[1].size());
+        }
+    }
+    in_pos_ = 0;
+    if(file_size_ > 0)
+    {
+        unmap();
+        if(::ftruncate(fd_, 0) == 0)
+            file_size_ = 0;
+    }
+}
+
+void
+spill_buffer::
+open_file()
+{
+    int fd = -1;
+#if defined(__linux__) && defined(O_TMPFILE)
+    fd = ::open(dir_.c_str(),
+        O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+    if(fd == -1 &&
+        errno != EISDIR &&
+        errno != EOPNOTSUPP &&
+        errno != EINVAL)
+        detail::throw_system_error(errno);
+#endif
+    if(fd == -1)
+    {
+        // the file system cannot make
+        // unnamed files, so create a
+        // named one and unlink it
+        std::vector<char> path(
+            dir_.begin(), dir_.end());
+        char const tmpl[] = "/boost.buffers.XXXXXX";
+        path.insert(path.end(),
+            tmpl, tmpl + sizeof(tmpl));
+        fd = ::mkstemp(path.data());
+        if(fd == -1)
+            detail::throw_system_error(errno);
+        ::unlink(path.data());
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    fd_ = fd;
+    file_size_ = 0;
+}
+
+void
+spill_buffer::
+map_window(
+    std::uint64_t lo,
+    std::uint64_t hi)
+{
+    auto const pos = align_down(lo);
+    auto end = align_up(hi);
+
+    // grow geometrically, so a stream
+    // of small prepares remaps rarely
+    if(map_ && end < map_pos_ + 2 * map_size_)
+        end = align_up(map_pos_ + 2 * map_size_);
+    if(end > file_size_)
+    {
+        if(::ftruncate(fd_,
+            static_cast<off_t>(end)) == -1)
+            detail::throw_system_error(errno);
+        file_size_ = end;
+    }
+    auto const size =
+        static_cast<std::size_t>(end - pos);
+    void* p = ::mmap(nullptr, size,
+        PROT_READ | PROT_WRITE, MAP_SHARED,
+        fd_, static_cast<off_t>(pos));
+    if(p == MAP_FAILED)
+        detail::throw_system_error(errno);
+    unmap();
+    map_ = static_cast<unsigned char*>(p);
+    map_pos_ = pos;
+    map_size_ = size;
+}
+
+void
+spill_buffer::
+unmap() noexcept
+{
+    if(map_)
+        ::munmap(map_, map_size_);
+    map_ = nullptr;
+    map_pos_ = 0;
+    map_size_ = 0;
+}
+
+void
+spill_buffer::
+release() noexcept
+{
+    unmap();
+    if(fd_ != -1)
+        ::close(fd_);
+    fd_ = -1;
+    file_size_ = 0;
+    delete[] mem_;
+    mem_ = nullptr;
+    in_pos_ = 0;
+    in_size_ = 0;
+    out_size_ = 0;
+}
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,123 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/cppalliance/buffers
+//
+
+#include <boost/buffers/splice.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_SPLICE
+
+#include <boost/buffers/detail/except.hpp>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+namespace detail {
+
+std::size_t
+vmsplice_iov(
+    int pipe,
+    ::iovec const* iov,
+    std::size_t n,
+    bool gift)
+{
+    if(n == 0)
+        return 0;
+    unsigned flags = 0;
+    if(gift)
+    {
+        auto const ps = static_cast<std::uintptr_t>(
+            ::sysconf(_SC_PAGESIZE));
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            // gifted pages go whole
+            if( reinterpret_cast<std::uintptr_t>(
+                    iov[i].iov_base) % ps != 0 ||
+                iov[i].iov_len % ps != 0)
+                detail::throw_invalid_argument();
+        }
+        flags |= SPLICE_F_GIFT;
+    }
+
+    // vmsplice ignores O_NONBLOCK on the pipe
+    auto const fl = ::fcntl(pipe, F_GETFL);
+    if(fl == -1)
+        detail::throw_system_error(errno);
+    if(fl & O_NONBLOCK)
+        flags |= SPLICE_F_NONBLOCK;
+    for(;;)
+    {
+        auto const rv = ::vmsplice(
+            pipe, iov, n, flags);
+        if(rv >= 0)
+            return static_cast<std::size_t>(rv);
+        if(errno == EINTR)
+            continue;
+        if(errno == EAGAIN)
+            return 0;
+        detail::throw_system_error(errno);
+    }
+}
+
+} // detail
+
+std::size_t
+splice_some(
+    int in,
+    int out,
+    std::size_t n,
+    std::uint64_t* in_offset,
+    std::uint64_t* out_offset)
+{
+    loff_t in_off = 0;
+    loff_t out_off = 0;
+    if(in_offset)
+        in_off = static_cast<loff_t>(*in_offset);
+    if(out_offset)
+        out_off = static_cast<loff_t>(*out_offset);
+    for(;;)
+    {
+        auto const rv = ::splice(
+            in, in_offset ? &in_off : nullptr,
+            out, out_offset ? &out_off : nullptr,
+            n, SPLICE_F_MOVE);
+        if(rv >= 0)
+        {
+            if(in_offset)
+                *in_offset = static_cast<
+                    std::uint64_t>(in_off);
+            if(out_offset)
+                *out_offset = static_cast<
+                    std::uint64_t>(out_off);
+            return static_cast<std::size_t>(rv);
+        }
+        if(errno == EINTR)
+            continue;
+        if(errno == EAGAIN)
+            return 0;
+        detail::throw_system_error(errno);
+    }
+}
+
+std::size_t
+pipe_pending(int pipe)
+{
+    int n = 0;
+    if(::ioctl(pipe, FIONREAD, &n) == -1)
+        detail::throw_system_error(errno);
+    return static_cast<std::size_t>(n);
+}
+
+} // buffers
+} // boost
+
+#endif
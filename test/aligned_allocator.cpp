@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/aligned_allocator.hpp>
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/dynamic_flat_buffer.hpp>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+struct aligned_allocator_test
+{
+    template<class T>
+    static
+    std::uintptr_t
+    address(T const* p) noexcept
+    {
+        return reinterpret_cast<std::uintptr_t>(p);
+    }
+
+    void
+    testAllocator()
+    {
+        using alloc_type =
+            aligned_allocator<unsigned char, 4096>;
+        alloc_type a;
+        BOOST_TEST_EQ(alloc_type::alignment, 4096);
+        for(std::size_t n = 1; n < 10000; n += 1111)
+        {
+            auto const p = a.allocate(n);
+            BOOST_TEST_EQ(address(p) % 4096, 0);
+            std::memset(p, '*', n);
+            a.deallocate(p, n);
+        }
+        BOOST_TEST_THROWS(
+            a.allocate(std::size_t(-1)),
+            std::bad_alloc);
+
+        // rebinding keeps the alignment
+        using traits = std::allocator_traits<alloc_type>;
+        traits::rebind_alloc<int> ai(a);
+        auto const q = ai.allocate(3);
+        BOOST_TEST_EQ(address(q) % 4096, 0);
+        ai.deallocate(q, 3);
+        BOOST_TEST(ai == a);
+        BOOST_TEST(! (ai != a));
+
+        // alignments below that of a pointer
+        aligned_allocator<char, 1> a1;
+        auto const c = a1.allocate(1);
+        *c = 'x';
+        a1.deallocate(c, 1);
+
+        std::vector<std::uint64_t, aligned_allocator<
+            std::uint64_t, 512>> v(100, 7);
+        BOOST_TEST_EQ(address(v.data()) % 512, 0);
+    }
+
+    void
+    testBuffer()
+    {
+        auto const& pat = test_pattern();
+        basic_dynamic_flat_buffer<aligned_allocator<
+            unsigned char, 4096>> b;
+        b.commit(buffer_copy(
+            b.prepare(pat.size()),
+            const_buffer(pat.data(), pat.size())));
+        BOOST_TEST_EQ(address(b.data().data()) % 4096, 0);
+        BOOST_TEST_EQ(test_to_string(b.data()), pat);
+
+        // growing starts the data at the front
+        b.consume(3);
+        b.commit(buffer_copy(
+            b.prepare(10000),
+            const_buffer(pat.data(), pat.size())));
+        BOOST_TEST_EQ(address(b.data().data()) % 4096, 0);
+        BOOST_TEST_EQ(test_to_string(b.data()),
+            pat.substr(3) + pat);
+    }
+
+    void
+    run()
+    {
+        testAllocator();
+        testBuffer();
+    }
+};
+
+TEST_SUITE(
+    aligned_allocator_test,
+    "boost.buffers.aligned_allocator");
+
+} // buffers
+} // boost
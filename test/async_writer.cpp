@@ -0,0 +1,211 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/async_writer.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/system/system_error.hpp>
+#include <string>
+#include "test_helpers.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+struct async_writer_test
+{
+    static
+    std::string
+    read_file(std::string const& path)
+    {
+        std::string s;
+        auto const fd = ::open(path.c_str(), O_RDONLY);
+        BOOST_TEST_NE(fd, -1);
+        char buf[4096];
+        for(;;)
+        {
+            auto const rv = ::read(fd, buf, sizeof(buf));
+            if(rv <= 0)
+                break;
+            s.append(buf, static_cast<std::size_t>(rv));
+        }
+        ::close(fd);
+        return s;
+    }
+
+    static
+    void
+    write(
+        async_writer& w,
+        std::string const& s)
+    {
+        w.commit(buffer_copy(
+            w.prepare(s.size()),
+            const_buffer(s.data(), s.size())));
+    }
+
+    // records of varying length
+    static
+    std::string
+    record(std::size_t i)
+    {
+        auto const& pat = test_pattern();
+        std::string s;
+        for(std::size_t j = 0; j <= i % 37; ++j)
+            s += pat[(i + j) % pat.size()];
+        return s;
+    }
+
+    void
+    testOptions()
+    {
+        test_temp_file tp;
+        async_writer::options opt;
+        opt.buffers = 1;
+        BOOST_TEST_THROWS(
+            async_writer(tp.path.c_str(), opt),
+            std::invalid_argument);
+        opt.buffers = 2;
+        opt.buffer_size = 0;
+        BOOST_TEST_THROWS(
+            async_writer(tp.path.c_str(), opt),
+            std::invalid_argument);
+        opt.buffer_size = std::size_t(-1) / 2;
+        opt.buffers = 4;
+        BOOST_TEST_THROWS(
+            async_writer(tp.path.c_str(), opt),
+            std::bad_alloc);
+
+        BOOST_TEST_THROWS(
+            async_writer("/nonexistent/dir/file"),
+            system::system_error);
+
+        opt.buffer_size = 100;
+        opt.buffers = 2;
+        async_writer w(tp.path.c_str(), opt);
+        BOOST_TEST_EQ(w.buffer_size(), 100);
+        BOOST_TEST_EQ(w.size(), 0);
+        BOOST_TEST_THROWS(
+            w.prepare(101),
+            std::length_error);
+        BOOST_TEST_EQ(w.prepare(100).size(), 100);
+        auto const st = w.stats();
+        BOOST_TEST_EQ(st.swaps, 0);
+        BOOST_TEST_EQ(st.flushes, 0);
+    }
+
+    void
+    testWrite(std::size_t buffers)
+    {
+        test_temp_file tp;
+        async_writer::options opt;
+        opt.buffer_size = 1000;
+        opt.buffers = buffers;
+        std::string expect;
+        {
+            async_writer w(tp.path.c_str(), opt);
+            for(std::size_t i = 0; i < 5000; ++i)
+            {
+                auto const s = record(i);
+                write(w, s);
+                expect += s;
+                if(i % 1000 == 0)
+                {
+                    w.flush();
+                    BOOST_TEST_EQ(read_file(tp.path), expect);
+                }
+            }
+            BOOST_TEST_EQ(w.size(), expect.size());
+
+            // a record which fills a buffer
+            auto const big = std::string(1000, '#');
+            write(w, big);
+            expect += big;
+            w.flush();
+
+            auto const st = w.stats();
+            BOOST_TEST_GT(st.swaps, expect.size() / 1000);
+            BOOST_TEST_GE(st.flushes, 1);
+            BOOST_TEST_LE(st.flushes, st.swaps);
+            BOOST_TEST_EQ(st.bytes_written, expect.size());
+            BOOST_TEST_LE(st.max_flush_ns, st.flush_ns);
+            BOOST_TEST_LE(st.swap_waits, st.swaps);
+            if(st.swap_waits == 0)
+                BOOST_TEST_EQ(st.swap_wait_ns, 0);
+            w.close();
+            w.close();
+        }
+        BOOST_TEST_EQ(read_file(tp.path), expect);
+
+        // the destructor flushes
+        {
+            async_writer w(tp.path.c_str(), opt);
+            write(w, "hello");
+        }
+        BOOST_TEST_EQ(read_file(tp.path), "hello");
+
+        // an empty file
+        {
+            async_writer w(tp.path.c_str(), opt);
+            w.flush();
+            BOOST_TEST_EQ(w.stats().swaps, 0);
+        }
+        BOOST_TEST_EQ(read_file(tp.path), "");
+    }
+
+    void
+    testError()
+    {
+        // writes fail with ENOSPC
+        if(::access("/dev/full", W_OK) != 0)
+            return;
+        async_writer::options opt;
+        opt.buffer_size = 100;
+        async_writer w("/dev/full", opt);
+        write(w, std::string(100, '*'));
+        BOOST_TEST_THROWS(
+            w.flush(),
+            system::system_error);
+        BOOST_TEST_THROWS(
+            w.prepare(1000),
+            std::length_error);
+        write(w, std::string(100, '*'));
+        BOOST_TEST_THROWS(
+            w.prepare(1),
+            system::system_error);
+        BOOST_TEST_THROWS(
+            w.close(),
+            system::system_error);
+        BOOST_TEST_EQ(w.stats().bytes_written, 0);
+        w.close();
+    }
+
+    void
+    run()
+    {
+        testOptions();
+        testWrite(2);
+        testWrite(5);
+        testError();
+    }
+};
+
+TEST_SUITE(
+    async_writer_test,
+    "boost.buffers.async_writer");
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/bip_buffer.hpp>
+
+#include <boost/buffers/type_traits.hpp>
+#include <boost/static_assert.hpp>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+struct bip_buffer_test
+{
+    BOOST_STATIC_ASSERT(
+        is_dynamic_buffer<
+            bip_buffer>::value);
+
+    BOOST_STATIC_ASSERT(
+        std::is_same<
+            bip_buffer::mutable_buffers_type,
+            mutable_buffer>::value);
+
+    void
+    testMembers()
+    {
+        std::string pat = test_pattern();
+
+        // bip_buffer()
+        {
+            bip_buffer bb;
+            BOOST_TEST_EQ(bb.size(), 0);
+            BOOST_TEST_EQ(bb.max_size(), 0);
+            BOOST_TEST_EQ(bb.capacity(), 0);
+        }
+
+        // bip_buffer(void*, std::size_t)
+        {
+            bip_buffer bb(
+                &pat[0], pat.size());
+            BOOST_TEST_EQ(bb.size(), 0);
+            BOOST_TEST_EQ(bb.capacity(), pat.size());
+            BOOST_TEST_EQ(bb.max_size(), pat.size());
+            BOOST_TEST_EQ(bb.waste(), 0);
+        }
+
+        // bip_buffer(
+        //  void*, std::size_t, std:size_t)
+        {
+            bip_buffer bb(
+                &pat[0], pat.size(), 6);
+            BOOST_TEST_EQ(bb.size(), 6);
+            BOOST_TEST_EQ(
+                bb.capacity(), pat.size() - 6);
+            BOOST_TEST_EQ(
+                test_to_string(bb.data()),
+                pat.substr(0, 6));
+        }
+        {
+            BOOST_TEST_THROWS(
+                bip_buffer(
+                    &pat[0], pat.size(), 600),
+                std::invalid_argument);
+        }
+
+        // bip_buffer(mutable_buffer)
+        {
+            bip_buffer bb(make_buffer(
+                &pat[0], pat.size()), 3);
+            BOOST_TEST_EQ(bb.size(), 3);
+            BOOST_TEST_EQ(bb.max_size(), pat.size());
+        }
+
+        // bip_buffer(bip_buffer const&)
+        // operator=(bip_buffer const&)
+        {
+            bip_buffer bb0(
+                &pat[0], pat.size(), 4);
+            bip_buffer bb1(bb0);
+            BOOST_TEST_EQ(bb1.size(), bb0.size());
+            bip_buffer bb2;
+            bb2 = bb0;
+            BOOST_TEST_EQ(bb2.capacity(), bb0.capacity());
+        }
+
+        // prepare(std::size_t)
+        {
+            bip_buffer bb(
+                &pat[0], pat.size());
+            BOOST_TEST_THROWS(
+                bb.prepare(bb.capacity() + 1),
+                std::length_error);
+        }
+
+        // commit(std::size_t)
+        {
+            bip_buffer bb(
+                &pat[0], pat.size());
+            auto n = pat.size() / 2;
+            bb.prepare(pat.size());
+            bb.commit(n);
+            BOOST_TEST_EQ(
+                test_to_string(bb.data()),
+                pat.substr(0, n));
+            bb.commit(100);
+            BOOST_TEST_EQ(bb.size(), n);
+        }
+    }
+
+    void
+    testWrap()
+    {
+        std::string s(10, '.');
+        bip_buffer bb(&s[0], s.size());
+
+        // A = [0,7)
+        bb.commit(buffer_copy(
+            bb.prepare(7),
+            make_buffer("abcdefg", 7)));
+        bb.consume(5);
+        BOOST_TEST_EQ(bb.capacity(), 5);
+
+        // 4 bytes fit before A but
+        // not after it, so B is used
+        auto mb = bb.prepare(4);
+        BOOST_TEST_EQ(mb.data(), &s[0]);
+        BOOST_TEST_EQ(mb.size(), 4);
+        BOOST_TEST_EQ(bb.waste(), 0);
+        bb.commit(buffer_copy(mb,
+            make_buffer("hijk", 4)));
+        BOOST_TEST_EQ(bb.waste(), 3);
+        BOOST_TEST_EQ(bb.size(), 6);
+        BOOST_TEST_EQ(bb.capacity(), 1);
+        BOOST_TEST_EQ(
+            test_to_string(bb.data()), "fghijk");
+
+        // B is bounded by A
+        BOOST_TEST_THROWS(
+            bb.prepare(2),
+            std::length_error);
+        bb.commit(buffer_copy(
+            bb.prepare(1),
+            make_buffer("l", 1)));
+        BOOST_TEST_EQ(bb.capacity(), 0);
+        BOOST_TEST_EQ(
+            test_to_string(bb.data()), "fghijkl");
+
+        // consuming A reclaims the tail
+        bb.consume(3);
+        BOOST_TEST_EQ(bb.waste(), 0);
+        BOOST_TEST_EQ(
+            test_to_string(bb.data()), "ijkl");
+        BOOST_TEST_EQ(bb.capacity(), 5);
+        mb = bb.prepare(5);
+        BOOST_TEST_EQ(mb.data(), &s[5]);
+        bb.commit(buffer_copy(mb,
+            make_buffer("mnop", 4)));
+        bb.consume(3);
+        BOOST_TEST_EQ(
+            test_to_string(bb.data()), "lmnop");
+
+        // committing nothing does not wrap
+        mb = bb.prepare(3);
+        BOOST_TEST_EQ(mb.data(), &s[0]);
+        bb.commit(0);
+        BOOST_TEST_EQ(bb.waste(), 0);
+        BOOST_TEST_EQ(bb.capacity(), 4);
+        mb = bb.prepare(1);
+        BOOST_TEST_EQ(mb.data(), &s[9]);
+
+        // consume everything
+        bb.consume(100);
+        BOOST_TEST_EQ(bb.size(), 0);
+        BOOST_TEST_EQ(bb.capacity(), 10);
+    }
+
+    void
+    testBuffer()
+    {
+        auto const& pat = test_pattern();
+
+        for(std::size_t i = 0;
+            i <= pat.size(); ++i)
+        for(std::size_t j = 0;
+            j <= pat.size(); ++j)
+        for(std::size_t k = 0;
+            k <= pat.size(); ++k)
+        {
+            // junk prefix of i bytes moves
+            // region A so the rest may wrap
+            std::string s(pat.size() + 3, 0);
+            if(i + j > s.size())
+                continue;
+            bip_buffer bs(
+                &s[0], s.size());
+            bs.commit(bs.prepare(i).size());
+            bs.commit(buffer_copy(
+                bs.prepare(j),
+                make_buffer(
+                    pat.data(), j)));
+            bs.consume(i);
+            auto const n = pat.size() - j;
+            if(bs.capacity() >= n)
+            {
+                bs.commit(buffer_copy(
+                    bs.prepare(n),
+                    make_buffer(
+                        pat.data() + j, n)));
+                BOOST_TEST_EQ(test_to_string(
+                    bs.data()), pat);
+                test_buffer_sequence(bs.data());
+                bs.consume(k);
+                BOOST_TEST_EQ(test_to_string(
+                    bs.data()), pat.substr(k));
+            }
+        }
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testWrap();
+        testBuffer();
+    }
+};
+
+TEST_SUITE(
+    bip_buffer_test,
+    "boost.buffers.bip_buffer");
+
+} // buffers
+} // boost
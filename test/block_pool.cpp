@@ -0,0 +1,426 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/block_pool.hpp>
+
+#include <boost/buffers/dynamic_circular_buffer.hpp>
+#include <boost/buffers/dynamic_flat_buffer.hpp>
+#include <boost/buffers/multi_buffer.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+struct block_pool_test
+{
+    static
+    block_pool::options
+    small_options()
+    {
+        block_pool::options opt;
+        opt.size_classes = { 16, 64 };
+        opt.high_watermark = 8;
+        opt.low_watermark = 2;
+        return opt;
+    }
+
+    void
+    testOptions()
+    {
+        auto const bad = [](
+            std::vector<std::size_t> v,
+            std::size_t hi,
+            std::size_t lo)
+        {
+            block_pool::options opt;
+            opt.size_classes = v;
+            opt.high_watermark = hi;
+            opt.low_watermark = lo;
+            BOOST_TEST_THROWS(
+                block_pool p(opt),
+                std::invalid_argument);
+        };
+        bad({}, 4, 2);
+        bad({ 0, 16 }, 4, 2);
+        bad({ 64, 16 }, 4, 2);
+        bad({ 16, 16 }, 4, 2);
+        bad({ 16 }, 2, 4);
+
+        block_pool p(small_options());
+        BOOST_TEST_EQ(p.block_size(0), 16);
+        BOOST_TEST_EQ(p.block_size(1), 16);
+        BOOST_TEST_EQ(p.block_size(16), 16);
+        BOOST_TEST_EQ(p.block_size(17), 64);
+        BOOST_TEST_EQ(p.block_size(64), 64);
+        BOOST_TEST_EQ(p.block_size(65), 65);
+
+        block_pool p1;
+        BOOST_TEST_EQ(p1.block_size(100), 256);
+        BOOST_TEST_EQ(p1.stats().hit_rate(), 0);
+    }
+
+    void
+    testThread()
+    {
+        block_pool p(small_options());
+
+        // first use comes from the heap
+        void* v[10];
+        for(auto& e : v)
+        {
+            e = p.allocate(10);
+            std::memset(e, 0xcc, 10);
+        }
+        auto st = p.stats();
+        BOOST_TEST_EQ(st.allocations, 10);
+        BOOST_TEST_EQ(st.heap_allocations, 10);
+        BOOST_TEST_EQ(st.cache_hits, 0);
+        BOOST_TEST_EQ(st.blocks_in_use, 10);
+        BOOST_TEST_EQ(st.bytes_in_use, 10 * 16);
+        BOOST_TEST_EQ(st.bytes_retained, 0);
+
+        // the magazine keeps 8, then
+        // spills down to 2
+        for(std::size_t i = 0; i < 8; ++i)
+            p.deallocate(v[i], 10);
+        BOOST_TEST_EQ(p.stats().bytes_retained, 8 * 16);
+        p.deallocate(v[8], 10);
+        BOOST_TEST_EQ(p.stats().bytes_retained, 9 * 16);
+        p.deallocate(v[9], 10);
+        BOOST_TEST_EQ(p.stats().bytes_retained, 10 * 16);
+        BOOST_TEST_EQ(p.stats().blocks_in_use, 0);
+        BOOST_TEST_EQ(p.stats().bytes_in_use, 0);
+
+        // served from the magazine,
+        // then from the depot
+        for(auto& e : v)
+            e = p.allocate(16);
+        st = p.stats();
+        BOOST_TEST_EQ(st.allocations, 20);
+        BOOST_TEST_EQ(st.heap_allocations, 10);
+        BOOST_TEST_EQ(st.bytes_retained, 0);
+        BOOST_TEST_GT(st.cache_hits, 0);
+        BOOST_TEST_GT(st.depot_hits, 0);
+        BOOST_TEST_EQ(st.cache_hits + st.depot_hits, 10);
+        for(auto& e : v)
+            p.deallocate(e, 16);
+
+        // trim releases the depot
+        p.trim();
+        BOOST_TEST_LE(p.stats().bytes_retained, 8 * 16);
+
+        // size classes are separate
+        auto const a = p.allocate(40);
+        std::memset(a, 0, 64);
+        BOOST_TEST_EQ(p.stats().heap_allocations, 11);
+        p.deallocate(a, 40);
+        BOOST_TEST_EQ(p.allocate(33), a);
+        p.deallocate(a, 33);
+
+        // larger than every class
+        auto const big = p.allocate(1000);
+        std::memset(big, 0, 1000);
+        auto const retained = p.stats().bytes_retained;
+        p.deallocate(big, 1000);
+        BOOST_TEST_EQ(p.stats().bytes_retained, retained);
+        p.deallocate(nullptr, 0);
+    }
+
+    void
+    testRemote()
+    {
+        block_pool p(small_options());
+
+        // freed by another thread
+        void* v[6];
+        for(auto& e : v)
+            e = p.allocate(16);
+        std::thread t([&]
+            {
+                for(auto e : v)
+                    p.deallocate(e, 16);
+            });
+        t.join();
+        auto st = p.stats();
+        BOOST_TEST_EQ(st.remote_frees, 6);
+        BOOST_TEST_EQ(st.bytes_retained, 6 * 16);
+
+        // collected in one batch by the owner
+        for(auto& e : v)
+            e = p.allocate(16);
+        st = p.stats();
+        BOOST_TEST_EQ(st.heap_allocations, 6);
+        BOOST_TEST_EQ(st.cache_hits, 6);
+        BOOST_TEST_EQ(st.bytes_retained, 0);
+        for(auto e : v)
+            p.deallocate(e, 16);
+
+        // a thread's cache outlives it
+        void* w[4];
+        std::thread t1([&]
+            {
+                for(auto& e : w)
+                    e = p.allocate(64);
+                p.deallocate(w[0], 64);
+            });
+        t1.join();
+        BOOST_TEST_EQ(p.stats().bytes_retained,
+            6 * 16 + 64);
+        for(std::size_t i = 1; i < 4; ++i)
+            p.deallocate(w[i], 64);
+        BOOST_TEST_EQ(p.stats().remote_frees, 9);
+        BOOST_TEST_EQ(p.stats().bytes_retained,
+            6 * 16 + 4 * 64);
+
+        // and is adopted by the next thread
+        std::thread t2([&]
+            {
+                for(auto& e : w)
+                    e = p.allocate(64);
+                for(auto e : w)
+                    p.deallocate(e, 64);
+            });
+        t2.join();
+        st = p.stats();
+        BOOST_TEST_EQ(st.heap_allocations, 10);
+        BOOST_TEST_EQ(st.bytes_retained,
+            6 * 16 + 4 * 64);
+    }
+
+    void
+    testStress()
+    {
+        // producers allocate, a consumer frees
+        block_pool p;
+        std::size_t const N = 20000;
+        std::atomic<void*> slots[64];
+        for(auto& s : slots)
+            s.store(nullptr);
+        std::atomic<bool> done{false};
+        std::thread consumer([&]
+            {
+                for(;;)
+                {
+                    bool any = false;
+                    for(auto& s : slots)
+                    {
+                        auto const q = s.exchange(nullptr);
+                        if(q)
+                        {
+                            BOOST_TEST_EQ(*static_cast<
+                                unsigned char*>(q), 0x5a);
+                            p.deallocate(q, 4096);
+                            any = true;
+                        }
+                    }
+                    if(! any && done.load())
+                        break;
+                }
+            });
+        std::thread producers[2];
+        for(std::size_t j = 0; j < 2; ++j)
+            producers[j] = std::thread([&, j]
+                {
+                    for(std::size_t i = 0; i < N; ++i)
+                    {
+                        auto const q = p.allocate(4096);
+                        std::memset(q, 0x5a, 4096);
+                        auto& s = slots[
+                            (i * 2 + j) % 64];
+                        void* expected = nullptr;
+                        while(! s.compare_exchange_weak(
+                            expected, q))
+                        {
+                            expected = nullptr;
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+        for(auto& t : producers)
+            t.join();
+        done.store(true);
+        consumer.join();
+        auto const st = p.stats();
+        BOOST_TEST_EQ(st.allocations, 2 * N);
+        BOOST_TEST_EQ(st.remote_frees, 2 * N);
+        BOOST_TEST_LT(st.heap_allocations, 2 * N);
+        BOOST_TEST_EQ(st.blocks_in_use, 0);
+        BOOST_TEST_EQ(st.bytes_in_use, 0);
+    }
+
+    void
+    testAllocator()
+    {
+        block_pool p;
+        {
+            using alloc_type =
+                block_pool_allocator<unsigned char>;
+            basic_multi_buffer<alloc_type> b(
+                std::size_t(-1), 16, alloc_type(p));
+            BOOST_TEST(&b.get_allocator().pool() == &p);
+            for(std::size_t i = 0; i < 100; ++i)
+            {
+                for(std::size_t j = 0; j < 4; ++j)
+                    b.commit(buffer_copy(
+                        b.prepare(test_pattern().size()),
+                        const_buffer(test_pattern().data(),
+                            test_pattern().size())));
+                BOOST_TEST_EQ(b.size(), 60);
+                b.consume(60);
+            }
+            BOOST_TEST_GT(p.stats().allocations, 0);
+        }
+        auto const st = p.stats();
+        BOOST_TEST_GT(st.hit_rate(), 0.5);
+        BOOST_TEST_GT(st.bytes_retained, 0);
+
+        block_pool p2;
+        BOOST_TEST(block_pool_allocator<char>(p) ==
+            block_pool_allocator<int>(p));
+        BOOST_TEST(block_pool_allocator<char>(p) !=
+            block_pool_allocator<char>(p2));
+    }
+
+    template<class DynamicBuffer>
+    static
+    void
+    write(DynamicBuffer& b)
+    {
+        auto const& pat = test_pattern();
+        b.commit(buffer_copy(
+            b.prepare(pat.size()),
+            const_buffer(pat.data(), pat.size())));
+    }
+
+    void
+    testIdle()
+    {
+        using alloc_type =
+            block_pool_allocator<unsigned char>;
+
+        // idle buffers hold no storage
+        block_pool p;
+        std::vector<basic_dynamic_circular_buffer<
+            alloc_type>> cv;
+        std::vector<basic_dynamic_flat_buffer<
+            alloc_type>> fv;
+        for(std::size_t i = 0; i < 50; ++i)
+        {
+            cv.emplace_back(alloc_type(p));
+            cv.back().idle_capacity(0);
+            fv.emplace_back(alloc_type(p));
+            fv.back().idle_capacity(0);
+        }
+        BOOST_TEST_EQ(p.stats().allocations, 0);
+
+        for(std::size_t i = 0; i < 10; ++i)
+        {
+            write(cv[i]);
+            write(fv[i]);
+        }
+        auto st = p.stats();
+        BOOST_TEST_EQ(st.blocks_in_use, 20);
+        BOOST_TEST_EQ(st.bytes_in_use, 20 * 1024);
+        BOOST_TEST_EQ(st.bytes_retained, 0);
+
+        // draining returns the storage
+        for(std::size_t i = 0; i < 5; ++i)
+        {
+            cv[i].consume(cv[i].size());
+            fv[i].consume(fv[i].size());
+            BOOST_TEST_EQ(fv[i].capacity(), 0);
+        }
+        st = p.stats();
+        BOOST_TEST_EQ(st.blocks_in_use, 10);
+        BOOST_TEST_EQ(st.bytes_in_use, 10 * 1024);
+        BOOST_TEST_EQ(st.bytes_retained, 10 * 1024);
+
+        // and the next prepare takes it back
+        for(std::size_t i = 10; i < 15; ++i)
+        {
+            write(cv[i]);
+            write(fv[i]);
+        }
+        st = p.stats();
+        BOOST_TEST_EQ(st.blocks_in_use, 20);
+        BOOST_TEST_EQ(st.bytes_retained, 0);
+        BOOST_TEST_EQ(st.heap_allocations, 20);
+
+        cv.clear();
+        fv.clear();
+        st = p.stats();
+        BOOST_TEST_EQ(st.blocks_in_use, 0);
+        BOOST_TEST_EQ(st.bytes_in_use, 0);
+
+        // oversized blocks are counted
+        auto const q = p.allocate(100000);
+        BOOST_TEST_EQ(p.stats().blocks_in_use, 1);
+        BOOST_TEST_EQ(p.stats().bytes_in_use, 100000);
+        p.deallocate(q, 100000);
+        BOOST_TEST_EQ(p.stats().blocks_in_use, 0);
+    }
+
+    void
+    testResource()
+    {
+#ifdef BOOST_BUFFERS_HAS_PMR
+        block_pool p;
+        block_pool_resource mr(p);
+        BOOST_TEST(&mr.pool() == &p);
+        {
+            pmr::multi_buffer b(&mr);
+            for(std::size_t i = 0; i < 10; ++i)
+                b.commit(buffer_copy(
+                    b.prepare(test_pattern().size()),
+                    const_buffer(test_pattern().data(),
+                        test_pattern().size())));
+            BOOST_TEST_EQ(b.size(), 150);
+        }
+        BOOST_TEST_GT(p.stats().allocations, 0);
+
+        // overaligned requests bypass the pool
+        auto const n = p.stats().allocations;
+        auto const q = mr.allocate(64, 256);
+        BOOST_TEST_EQ(reinterpret_cast<
+            std::uintptr_t>(q) % 256, 0);
+        mr.deallocate(q, 64, 256);
+        BOOST_TEST_EQ(p.stats().allocations, n);
+
+        block_pool p2;
+        block_pool_resource mr2(p);
+        block_pool_resource mr3(p2);
+        BOOST_TEST(mr.is_equal(mr2));
+        BOOST_TEST(! mr.is_equal(mr3));
+#endif
+    }
+
+    void
+    run()
+    {
+        testOptions();
+        testThread();
+        testRemote();
+        testStress();
+        testAllocator();
+        testIdle();
+        testResource();
+    }
+};
+
+TEST_SUITE(
+    block_pool_test,
+    "boost.buffers.block_pool");
+
+} // buffers
+} // boost
@@ -0,0 +1,360 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/buffer_rope.hpp>
+
+#include <boost/buffers/algorithm.hpp>
+#include <boost/static_assert.hpp>
+#include <iterator>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_const_buffer_sequence<buffer_rope>::value);
+
+BOOST_STATIC_ASSERT(
+    is_const_buffer_sequence<local_buffer_rope>::value);
+
+BOOST_STATIC_ASSERT(
+    detail::is_bidirectional_iterator<
+        buffer_rope::const_iterator>::value);
+
+struct buffer_rope_test
+{
+    static
+    const_buffer
+    cb(std::string const& s)
+    {
+        return { s.data(), s.size() };
+    }
+
+    // count the pieces by walking backwards
+    template<class Rope>
+    static
+    std::size_t
+    walk_back(Rope const& r)
+    {
+        std::size_t n = 0;
+        std::string s;
+        auto it = r.end();
+        while(it != r.begin())
+        {
+            --it;
+            std::string const b(
+                static_cast<char const*>(it->data()),
+                it->size());
+            s.insert(0, b);
+            ++n;
+        }
+        BOOST_TEST_EQ(s, test_to_string(r));
+        return n;
+    }
+
+    void
+    testMembers()
+    {
+        auto const& pat = test_pattern();
+
+        // basic_buffer_rope()
+        {
+            buffer_rope r;
+            BOOST_TEST(r.empty());
+            BOOST_TEST_EQ(r.size(), 0);
+            BOOST_TEST_EQ(r.pieces(), 0);
+            BOOST_TEST(r.begin() == r.end());
+            BOOST_TEST_EQ(buffer_size(r), 0);
+            r.erase(0, 10);
+            r.consume(10);
+            BOOST_TEST_THROWS(
+                r.erase(1, 0),
+                std::invalid_argument);
+            BOOST_TEST_THROWS(
+                r.insert(1, cb("x")),
+                std::invalid_argument);
+        }
+
+        // insert
+        {
+            buffer_rope r;
+            r.insert(0, cb(pat.substr(5)));
+            r.insert(0, cb(pat.substr(0, 3)));
+            r.insert(3, cb(pat.substr(3, 2)));
+            BOOST_TEST_EQ(test_to_string(r), pat);
+            BOOST_TEST_EQ(r.pieces(), 3);
+            BOOST_TEST_EQ(walk_back(r), 3);
+
+            // into the middle of a piece
+            r.insert(8, cb(std::string("-")));
+            BOOST_TEST_EQ(r.pieces(), 5);
+            BOOST_TEST_EQ(test_to_string(r),
+                pat.substr(0, 8) + "-" + pat.substr(8));
+
+            // empty
+            r.insert(4, cb(std::string()));
+            BOOST_TEST_EQ(r.pieces(), 5);
+        }
+
+        // shared pieces are not copied
+        {
+            shared_buffer const b(shared_block(cb(pat)));
+            buffer_rope r;
+            r.append(b);
+            r.insert(5, b);
+            BOOST_TEST_EQ(r.pieces(), 3);
+            BOOST_TEST_EQ(b.block().use_count(), 4);
+            BOOST_TEST_EQ(test_to_string(r),
+                pat.substr(0, 5) + pat + pat.substr(5));
+            for(auto const& e : r)
+            {
+                auto const p = static_cast<
+                    unsigned char const*>(e.data());
+                auto const q = static_cast<
+                    unsigned char const*>(b.data());
+                BOOST_TEST(p >= q && p < q + pat.size());
+            }
+            r.clear();
+            BOOST_TEST(r.empty());
+            BOOST_TEST_EQ(r.pieces(), 0);
+            BOOST_TEST_EQ(b.block().use_count(), 1);
+
+            shared_buffers bs{ b, b + 10 };
+            r.append(bs);
+            r.insert(0, bs);
+            BOOST_TEST_EQ(r.pieces(), 4);
+            BOOST_TEST_EQ(test_to_string(r),
+                pat + pat.substr(10) +
+                pat + pat.substr(10));
+        }
+
+        // erase
+        {
+            buffer_rope r;
+            r.append(cb(pat));
+            r.erase(3, 4);
+            BOOST_TEST_EQ(r.pieces(), 2);
+            BOOST_TEST_EQ(test_to_string(r),
+                pat.substr(0, 3) + pat.substr(7));
+            r.erase(0, 1);
+            BOOST_TEST_EQ(test_to_string(r),
+                pat.substr(1, 2) + pat.substr(7));
+            r.erase(2, 100);
+            BOOST_TEST_EQ(test_to_string(r),
+                pat.substr(1, 2));
+            r.erase(0, 2);
+            BOOST_TEST(r.empty());
+            BOOST_TEST_EQ(r.pieces(), 0);
+        }
+
+        // replace
+        {
+            buffer_rope r;
+            r.append(cb(pat));
+            r.replace(4, 3, cb(std::string("XY")));
+            BOOST_TEST_EQ(test_to_string(r),
+                pat.substr(0, 4) + "XY" + pat.substr(7));
+            r.replace(0, 100, cb(pat));
+            BOOST_TEST_EQ(test_to_string(r), pat);
+            BOOST_TEST_THROWS(
+                r.replace(16, 0, cb(pat)),
+                std::invalid_argument);
+            BOOST_TEST_EQ(test_to_string(r), pat);
+        }
+
+        // consume
+        {
+            buffer_rope r;
+            r.append(cb(pat.substr(0, 5)));
+            r.append(cb(pat.substr(5)));
+            r.consume(2);
+            BOOST_TEST_EQ(test_to_string(r),
+                pat.substr(2));
+            BOOST_TEST_EQ(r.pieces(), 2);
+            r.consume(3);
+            BOOST_TEST_EQ(r.pieces(), 1);
+            r.consume(100);
+            BOOST_TEST(r.empty());
+        }
+
+        // copy, move
+        {
+            buffer_rope r0;
+            r0.append(cb(pat.substr(0, 5)));
+            r0.append(cb(pat.substr(5)));
+            buffer_rope r1(r0);
+            BOOST_TEST_EQ(test_to_string(r1), pat);
+            BOOST_TEST_EQ(r1.begin()->data(),
+                r0.begin()->data());
+            r1.erase(0, 7);
+            BOOST_TEST_EQ(test_to_string(r0), pat);
+
+            buffer_rope r2(std::move(r1));
+            BOOST_TEST(r1.empty());
+            BOOST_TEST_EQ(r1.pieces(), 0);
+            BOOST_TEST_EQ(test_to_string(r2),
+                pat.substr(7));
+            r1 = r0;
+            BOOST_TEST_EQ(test_to_string(r1), pat);
+            r1 = std::move(r2);
+            BOOST_TEST_EQ(test_to_string(r1),
+                pat.substr(7));
+
+            // a rope into itself
+            r0.insert(5, r0);
+            BOOST_TEST_EQ(test_to_string(r0),
+                pat.substr(0, 5) + pat + pat.substr(5));
+        }
+    }
+
+    void
+    testSequence()
+    {
+        auto const& pat = test_pattern();
+        for(std::size_t i = 0; i <= pat.size(); ++i)
+        for(std::size_t j = i; j <= pat.size(); ++j)
+        {
+            local_buffer_rope r;
+            r.append(cb(pat.substr(j)));
+            r.insert(0, cb(pat.substr(0, i)));
+            r.insert(i, cb(pat.substr(i, j - i)));
+            test_buffer_sequence(r);
+            BOOST_TEST_EQ(test_to_string(
+                sans_prefix(r, i)), pat.substr(i));
+            BOOST_TEST_EQ(test_to_string(
+                sans_suffix(r, j)),
+                pat.substr(0, pat.size() - j));
+        }
+    }
+
+    void
+    testRandom()
+    {
+        // compare against std::string
+        local_buffer_rope r;
+        std::string s;
+        std::uint32_t seed = 1;
+        auto const rand = [&seed]
+            {
+                seed = seed * 1103515245 + 12345;
+                return (seed >> 8) & 0xffff;
+            };
+        std::string const text =
+            "the quick brown fox jumps over the lazy dog";
+        for(std::size_t i = 0; i < 20000; ++i)
+        {
+            auto const pos = rand() % (s.size() + 1);
+            auto const n = rand() % 24;
+            auto const t = text.substr(
+                rand() % text.size(), rand() % 16);
+            switch(rand() % 4)
+            {
+            case 0:
+            case 1:
+                r.insert(pos, cb(t));
+                s.insert(pos, t);
+                break;
+            case 2:
+                r.erase(pos, n);
+                s.erase(pos, n);
+                break;
+            case 3:
+                r.replace(pos, n, cb(t));
+                s.replace(pos, n, t);
+                break;
+            }
+            BOOST_TEST_EQ(r.size(), s.size());
+            if(i % 1000 == 0)
+            {
+                BOOST_TEST_EQ(test_to_string(r), s);
+                BOOST_TEST_EQ(walk_back(r), r.pieces());
+            }
+        }
+        BOOST_TEST_EQ(test_to_string(r), s);
+        BOOST_TEST_EQ(
+            std::size_t(std::distance(
+                r.begin(), r.end())), r.pieces());
+    }
+
+    void
+    testAllocator()
+    {
+        using rope_type = basic_buffer_rope<
+            true, test_allocator<unsigned char>>;
+        auto const& pat = test_pattern();
+        std::size_t bytes0 = 0;
+        std::size_t bytes1 = 0;
+        {
+            rope_type r0(
+                (test_allocator<unsigned char>(&bytes0)));
+            r0.append(cb(pat));
+            r0.insert(4, cb(pat));
+            BOOST_TEST_GT(bytes0, 0);
+            auto const s = test_to_string(r0);
+
+            rope_type r1(r0);
+            BOOST_TEST(r1.get_allocator() ==
+                r0.get_allocator());
+            BOOST_TEST_EQ(test_to_string(r1), s);
+
+            // the allocator does not propagate
+            rope_type r2(
+                (test_allocator<unsigned char>(&bytes1)));
+            r2 = r0;
+            BOOST_TEST_EQ(test_to_string(r2), s);
+            BOOST_TEST(r2.get_allocator() ==
+                test_allocator<unsigned char>(&bytes1));
+            BOOST_TEST_GT(bytes1, 0);
+            r2.clear();
+            r2 = std::move(r0);
+            BOOST_TEST_EQ(test_to_string(r2), s);
+            BOOST_TEST(r2.get_allocator() ==
+                test_allocator<unsigned char>(&bytes1));
+
+            // equal allocators take the pieces
+            rope_type r3(
+                (test_allocator<unsigned char>(&bytes1)));
+            r3 = std::move(r2);
+            BOOST_TEST_EQ(test_to_string(r3), s);
+            BOOST_TEST(r2.empty());
+            rope_type r4(std::move(r3));
+            BOOST_TEST_EQ(test_to_string(r4), s);
+        }
+        BOOST_TEST_EQ(bytes0, 0);
+        BOOST_TEST_EQ(bytes1, 0);
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+        {
+            std::pmr::unsynchronized_pool_resource mr;
+            pmr::buffer_rope r(&mr);
+            r.append(cb(pat));
+            r.erase(4, 4);
+            BOOST_TEST_EQ(test_to_string(r),
+                pat.substr(0, 4) + pat.substr(8));
+        }
+#endif
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testSequence();
+        testRandom();
+        testAllocator();
+    }
+};
+
+TEST_SUITE(
+    buffer_rope_test,
+    "boost.buffers.buffer_rope");
+
+} // buffers
+} // boost
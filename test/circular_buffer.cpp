@@ -171,11 +171,99 @@ struct circular_buffer_test
         }
     }
 
+    void
+    testLinearize()
+    {
+        auto const& pat = test_pattern();
+
+        for(std::size_t cap = 1;
+            cap <= pat.size(); ++cap)
+        for(std::size_t pos = 0;
+            pos < cap; ++pos)
+        for(std::size_t len = 1;
+            len <= cap; ++len)
+        {
+            // len bytes of pat, starting
+            // at pos in the storage
+            std::string s(cap, '*');
+            circular_buffer cb(&s[0], s.size());
+            cb.commit(buffer_copy(
+                cb.prepare(pos + 1),
+                make_buffer(
+                    (std::string(pos, '-') +
+                        pat[0]).data(), pos + 1)));
+            cb.consume(pos);
+            cb.commit(buffer_copy(
+                cb.prepare(len - 1),
+                make_buffer(
+                    pat.data() + 1, len - 1)));
+            BOOST_TEST_EQ(test_to_string(
+                cb.data()), pat.substr(0, len));
+
+            auto const wrapped =
+                cb.data()[1].size() != 0;
+            auto const d0 = cb.data()[0].data();
+
+            // peek_contiguous
+            for(std::size_t n = 0; n <= len; ++n)
+            {
+                circular_buffer cb1(cb);
+                std::string s1(s);
+                auto const b = cb1.peek_contiguous(n);
+                BOOST_TEST_EQ(b.size(), n);
+                BOOST_TEST_EQ(std::string(
+                    static_cast<char const*>(b.data()),
+                    b.size()), pat.substr(0, n));
+                BOOST_TEST_EQ(test_to_string(
+                    cb1.data()), pat.substr(0, len));
+                if(pos + n <= cap)
+                    BOOST_TEST_EQ(
+                        cb1.data()[0].data(), d0);
+                s = s1;
+            }
+            BOOST_TEST_THROWS(
+                cb.peek_contiguous(len + 1),
+                std::invalid_argument);
+
+            // linearize
+            auto const b = cb.linearize();
+            BOOST_TEST_EQ(b.size(), len);
+            BOOST_TEST_EQ(b.data(),
+                cb.data()[0].data());
+            BOOST_TEST_EQ(cb.data()[1].size(), 0);
+            BOOST_TEST_EQ(test_to_string(
+                cb.data()), pat.substr(0, len));
+            if(! wrapped)
+                BOOST_TEST_EQ(
+                    cb.data()[0].data(), d0);
+
+            // still usable as a ring
+            BOOST_TEST_EQ(cb.size(), len);
+            BOOST_TEST_EQ(
+                cb.capacity(), cap - len);
+            cb.commit(buffer_copy(
+                cb.prepare(cap - len),
+                make_buffer(pat.data() + len,
+                    cap - len)));
+            BOOST_TEST_EQ(test_to_string(
+                cb.data()), pat.substr(0, cap));
+        }
+
+        // empty
+        {
+            circular_buffer cb;
+            BOOST_TEST_EQ(cb.linearize().size(), 0);
+            BOOST_TEST_EQ(
+                cb.peek_contiguous(0).size(), 0);
+        }
+    }
+
     void
     run()
     {
         testMembers();
         testBuffer();
+        testLinearize();
     }
 };
 
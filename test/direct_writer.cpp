@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/direct_writer.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/system/system_error.hpp>
+#include <cstdint>
+#include <string>
+#include "test_helpers.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+struct direct_writer_test
+{
+    static
+    std::string
+    read_file(std::string const& path)
+    {
+        std::string s;
+        auto const fd = ::open(path.c_str(), O_RDONLY);
+        BOOST_TEST_NE(fd, -1);
+        char buf[4096];
+        for(;;)
+        {
+            auto const rv = ::read(fd, buf, sizeof(buf));
+            if(rv <= 0)
+                break;
+            s.append(buf, static_cast<std::size_t>(rv));
+        }
+        ::close(fd);
+        return s;
+    }
+
+    static
+    void
+    write(
+        direct_writer& w,
+        std::string const& s)
+    {
+        w.commit(buffer_copy(
+            w.prepare(s.size()),
+            const_buffer(s.data(), s.size())));
+    }
+
+    // records of varying length
+    static
+    std::string
+    record(std::size_t i)
+    {
+        auto const& pat = test_pattern();
+        std::string s;
+        for(std::size_t j = 0; j <= i % 37; ++j)
+            s += pat[(i + j) % pat.size()];
+        return s;
+    }
+
+    void
+    testOptions()
+    {
+        test_temp_file tp;
+        direct_writer::options opt;
+        opt.block_size = 1000;
+        BOOST_TEST_THROWS(
+            direct_writer(tp.path.c_str(), opt),
+            std::invalid_argument);
+        opt.block_size = 0;
+        BOOST_TEST_THROWS(
+            direct_writer(tp.path.c_str(), opt),
+            std::invalid_argument);
+
+        BOOST_TEST_THROWS(
+            direct_writer("/nonexistent/dir/file"),
+            system::system_error);
+
+        // rounded up to whole blocks
+        opt.block_size = 512;
+        opt.buffer_size = 1000;
+        direct_writer w(tp.path.c_str(), opt);
+        BOOST_TEST_EQ(w.block_size(), 512);
+        BOOST_TEST_EQ(w.capacity(), 1024);
+        BOOST_TEST_EQ(w.size(), 0);
+        BOOST_TEST_NE(w.native_handle(), -1);
+        BOOST_TEST_THROWS(
+            w.prepare(1025),
+            std::length_error);
+        BOOST_TEST_EQ(w.prepare(1024).size(), 1024);
+    }
+
+    void
+    testWrite(
+        char const* dir,
+        bool direct)
+    {
+        test_temp_file tp(dir);
+        direct_writer::options opt;
+        opt.buffer_size = 3 * 4096;
+        opt.direct = direct;
+        std::string expect;
+        {
+            direct_writer w(tp.path.c_str(), opt);
+            if(! direct)
+                BOOST_TEST(! w.is_direct());
+            for(std::size_t i = 0; i < 2000; ++i)
+            {
+                auto const s = record(i);
+                write(w, s);
+                expect += s;
+
+                // padded tails, rewritten in place
+                if(i % 500 == 0)
+                {
+                    w.flush();
+                    BOOST_TEST_EQ(read_file(tp.path), expect);
+                }
+            }
+            BOOST_TEST_EQ(w.size(), expect.size());
+
+            // a record which fills the buffer
+            auto const big = std::string(
+                w.capacity() - 4095, '#');
+            write(w, big);
+            expect += big;
+            w.close();
+            w.close();
+        }
+        BOOST_TEST_EQ(read_file(tp.path), expect);
+
+        // the destructor flushes
+        {
+            direct_writer w(tp.path.c_str(), opt);
+            write(w, "hello");
+        }
+        BOOST_TEST_EQ(read_file(tp.path), "hello");
+
+        // an empty file
+        {
+            direct_writer w(tp.path.c_str(), opt);
+            w.flush();
+        }
+        BOOST_TEST_EQ(read_file(tp.path), "");
+    }
+
+    void
+    run()
+    {
+        testOptions();
+        testWrite("/tmp", true);
+        testWrite("/tmp", false);
+
+        // tmpfs, which may reject O_DIRECT
+        if(::access("/dev/shm", W_OK) == 0)
+            testWrite("/dev/shm", true);
+    }
+};
+
+TEST_SUITE(
+    direct_writer_test,
+    "boost.buffers.direct_writer");
+
+} // buffers
+} // boost
+
+#endif
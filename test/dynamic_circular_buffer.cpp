@@ -0,0 +1,369 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/dynamic_circular_buffer.hpp>
+
+#include <boost/buffers/type_traits.hpp>
+#include <boost/static_assert.hpp>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<
+        dynamic_circular_buffer>::value);
+
+struct dynamic_circular_buffer_test
+{
+    using buffer_type =
+        basic_dynamic_circular_buffer<
+            test_allocator<char>>;
+
+    template<class DynamicBuffer>
+    static
+    void
+    write(
+        DynamicBuffer& b,
+        std::string const& s)
+    {
+        b.commit(buffer_copy(
+            b.prepare(s.size()),
+            const_buffer(s.data(), s.size())));
+    }
+
+    void
+    testMembers()
+    {
+        auto const& pat = test_pattern();
+
+        // basic_dynamic_circular_buffer()
+        {
+            dynamic_circular_buffer b;
+            BOOST_TEST_EQ(b.size(), 0);
+            BOOST_TEST_EQ(b.capacity(), 0);
+            BOOST_TEST_GT(b.max_size(), 0);
+            auto const mb = b.prepare(0);
+            BOOST_TEST_EQ(buffer_size(mb), 0);
+            b.commit(0);
+            b.consume(1);
+        }
+
+        // basic_dynamic_circular_buffer(Allocator)
+        {
+            std::size_t bytes = 0;
+            {
+                buffer_type b(
+                    (test_allocator<char>(&bytes)));
+                BOOST_TEST_EQ(b.capacity(), 0);
+                BOOST_TEST_GT(b.max_size(), 0);
+                BOOST_TEST_EQ(b.idle_capacity(),
+                    std::size_t(-1));
+                write(b, pat);
+                BOOST_TEST_GT(bytes, 0);
+
+                // the storage is kept by default
+                auto const n = bytes;
+                b.consume(pat.size());
+                BOOST_TEST_EQ(bytes, n);
+                BOOST_TEST_EQ(b.capacity(), n);
+            }
+            BOOST_TEST_EQ(bytes, 0);
+        }
+
+        // basic_dynamic_circular_buffer(
+        //  std::size_t, std::size_t, Allocator)
+        {
+            std::size_t bytes = 0;
+            {
+                buffer_type b(100, 10,
+                    test_allocator<char>(&bytes));
+                BOOST_TEST_EQ(b.size(), 0);
+                BOOST_TEST_EQ(b.capacity(), 10);
+                BOOST_TEST_EQ(b.max_size(), 100);
+                BOOST_TEST_EQ(bytes, 10);
+                BOOST_TEST(b.get_allocator() ==
+                    test_allocator<char>(&bytes));
+            }
+            BOOST_TEST_EQ(bytes, 0);
+
+            BOOST_TEST_THROWS(
+                buffer_type(10, 11,
+                    test_allocator<char>(&bytes)),
+                std::invalid_argument);
+
+            // the default allocates nothing
+            buffer_type b(100, std::size_t(-1),
+                test_allocator<char>(&bytes));
+            BOOST_TEST_EQ(b.capacity(), 0);
+            BOOST_TEST_EQ(bytes, 0);
+            BOOST_TEST_EQ(b.idle_capacity(),
+                std::size_t(-1));
+        }
+
+        // prepare(std::size_t)
+        {
+            std::size_t bytes = 0;
+            buffer_type b(1000, 0,
+                test_allocator<char>(&bytes));
+            BOOST_TEST_EQ(bytes, 0);
+            write(b, pat);
+            BOOST_TEST_EQ(test_to_string(b.data()), pat);
+            BOOST_TEST_EQ(b.size() + b.capacity(), 512);
+            BOOST_TEST_EQ(bytes, 512);
+            BOOST_TEST_THROWS(
+                b.prepare(1000 - pat.size() + 1),
+                std::length_error);
+
+            // clamped to max_size
+            b.prepare(1000 - pat.size());
+            BOOST_TEST_EQ(b.size() + b.capacity(), 1000);
+            BOOST_TEST_EQ(bytes, 1000);
+            BOOST_TEST_EQ(test_to_string(b.data()), pat);
+        }
+
+        // geometric growth
+        {
+            std::size_t bytes = 0;
+            buffer_type b(std::size_t(-1), 0,
+                test_allocator<char>(&bytes));
+            std::size_t grows = 0;
+            std::size_t last = 0;
+            std::string s;
+            for(std::size_t i = 0; i < 10000; ++i)
+            {
+                s.push_back(pat[i % pat.size()]);
+                write(b, s.substr(i));
+                BOOST_TEST_EQ(b.data()[1].size(), 0);
+                if(bytes != last)
+                {
+                    ++grows;
+                    last = bytes;
+                }
+            }
+            BOOST_TEST_EQ(test_to_string(b.data()), s);
+            BOOST_TEST_LE(grows, 6);
+        }
+
+        // growth relinearizes
+        {
+            dynamic_circular_buffer b(64, 8);
+            write(b, "12345678");
+            b.consume(5);
+            write(b, "abcde");
+            BOOST_TEST_GT(b.data()[1].size(), 0);
+            {
+                auto b1 = b;
+                BOOST_TEST_EQ(
+                    b1.peek_contiguous(4).size(), 4);
+                BOOST_TEST_EQ(b1.linearize().size(), 8);
+                BOOST_TEST_EQ(test_to_string(
+                    b1.data()), "678abcde");
+            }
+            write(b, "XYZ");
+            BOOST_TEST_EQ(b.data()[1].size(), 0);
+            BOOST_TEST_EQ(test_to_string(
+                b.data()), "678abcdeXYZ");
+        }
+
+        // consume releases storage when idle
+        {
+            std::size_t bytes = 0;
+            buffer_type b(10000, 16,
+                test_allocator<char>(&bytes));
+            write(b, pat);
+            BOOST_TEST_EQ(bytes, 16);
+            b.consume(3);
+            write(b, pat);
+            BOOST_TEST_EQ(bytes, 512);
+            b.consume(b.size() - 1);
+            BOOST_TEST_EQ(bytes, 512);
+            b.consume(1);
+            BOOST_TEST_EQ(bytes, 0);
+            BOOST_TEST_EQ(b.capacity(), 0);
+            write(b, "x");
+            BOOST_TEST_EQ(bytes, 512);
+        }
+        {
+            // idle storage is kept
+            std::size_t bytes = 0;
+            buffer_type b(100, 16,
+                test_allocator<char>(&bytes));
+            write(b, pat);
+            b.consume(pat.size());
+            BOOST_TEST_EQ(bytes, 16);
+            BOOST_TEST_EQ(b.capacity(), 16);
+        }
+
+        // idle_capacity
+        {
+            std::size_t bytes = 0;
+            buffer_type b(1000, 16,
+                test_allocator<char>(&bytes));
+            BOOST_TEST_EQ(b.idle_capacity(), 16);
+            write(b, pat);
+            b.consume(pat.size());
+            BOOST_TEST_EQ(bytes, 16);
+
+            // releases at once when empty
+            b.idle_capacity(0);
+            BOOST_TEST_EQ(b.idle_capacity(), 0);
+            BOOST_TEST_EQ(bytes, 0);
+
+            // does not allocate
+            b.idle_capacity(64);
+            BOOST_TEST_EQ(bytes, 0);
+            write(b, pat);
+            BOOST_TEST_EQ(bytes, 512);
+            b.consume(pat.size());
+            BOOST_TEST_EQ(bytes, 0);
+        }
+
+        // shrink_to_fit()
+        {
+            std::size_t bytes = 0;
+            buffer_type b(10000, 4,
+                test_allocator<char>(&bytes));
+            b.prepare(1000);
+            write(b, pat);
+            BOOST_TEST_GE(bytes, 1000);
+            b.consume(5);
+            b.shrink_to_fit();
+            BOOST_TEST_EQ(bytes, pat.size() - 5);
+            BOOST_TEST_EQ(b.capacity(), 0);
+            BOOST_TEST_EQ(test_to_string(
+                b.data()), pat.substr(5));
+            b.shrink_to_fit();
+            BOOST_TEST_EQ(bytes, pat.size() - 5);
+        }
+        {
+            std::size_t bytes = 0;
+            buffer_type b(10000, 0,
+                test_allocator<char>(&bytes));
+            b.prepare(1000);
+            BOOST_TEST_GE(bytes, 1000);
+            b.shrink_to_fit();
+            BOOST_TEST_EQ(bytes, 0);
+        }
+
+        // copy
+        {
+            std::size_t bytes = 0;
+            buffer_type b0(100, 0,
+                test_allocator<char>(&bytes));
+            write(b0, pat);
+            buffer_type b1(b0);
+            BOOST_TEST_EQ(bytes, 100 + pat.size());
+            BOOST_TEST_EQ(test_to_string(b1.data()), pat);
+            BOOST_TEST_EQ(b1.max_size(), 100);
+
+            buffer_type b2(100, 0,
+                test_allocator<char>(&bytes));
+            b2 = b0;
+            BOOST_TEST_EQ(test_to_string(b2.data()), pat);
+            b2.consume(2);
+            b2 = b1;
+            BOOST_TEST_EQ(test_to_string(b2.data()), pat);
+        }
+
+        // move
+        {
+            std::size_t bytes = 0;
+            buffer_type b0(100, 0,
+                test_allocator<char>(&bytes));
+            write(b0, pat);
+            buffer_type b1(std::move(b0));
+            BOOST_TEST_EQ(b0.size(), 0);
+            BOOST_TEST_EQ(b0.capacity(), 0);
+            BOOST_TEST_EQ(test_to_string(b1.data()), pat);
+            BOOST_TEST_EQ(bytes, 100);
+
+            std::size_t bytes2 = 0;
+            buffer_type b2(100, 0,
+                test_allocator<char>(&bytes2));
+            write(b2, "x");
+            b2 = std::move(b1);
+            BOOST_TEST_EQ(test_to_string(b2.data()), pat);
+            BOOST_TEST_EQ(b1.size(), 0);
+
+            // allocator does not propagate
+            BOOST_TEST_EQ(bytes, 0);
+            BOOST_TEST_EQ(bytes2, 100);
+        }
+    }
+
+    void
+    testBuffer()
+    {
+        auto const& pat = test_pattern();
+
+        for(std::size_t i = 0;
+            i <= pat.size(); ++i)
+        for(std::size_t j = 0;
+            j <= pat.size(); ++j)
+        {
+            dynamic_circular_buffer b(
+                pat.size() + 1, 8);
+            b.commit(buffer_copy(
+                b.prepare(i),
+                const_buffer(pat.data(), i)));
+            b.consume(i > 0 ? i - 1 : 0);
+            b.commit(buffer_copy(
+                b.prepare(j),
+                const_buffer(pat.data(), j)));
+            if(i > 0)
+                b.consume(1);
+            b.commit(buffer_copy(
+                b.prepare(pat.size() - j),
+                const_buffer(pat.data() + j,
+                    pat.size() - j)));
+            BOOST_TEST_EQ(test_to_string(
+                b.data()), pat);
+            test_buffer_sequence(b.data());
+        }
+    }
+
+    void
+    testPmr()
+    {
+#ifdef BOOST_BUFFERS_HAS_PMR
+        auto const& pat = test_pattern();
+        std::pmr::unsynchronized_pool_resource mr0;
+        std::pmr::unsynchronized_pool_resource mr1;
+        pmr::dynamic_circular_buffer b0(&mr0);
+        write(b0, pat);
+        BOOST_TEST(b0.get_allocator().resource() == &mr0);
+
+        // the resource does not propagate
+        pmr::dynamic_circular_buffer b1(&mr1);
+        b1 = b0;
+        BOOST_TEST_EQ(test_to_string(b1.data()), pat);
+        BOOST_TEST(b1.get_allocator().resource() == &mr1);
+        b1 = std::move(b0);
+        BOOST_TEST_EQ(test_to_string(b1.data()), pat);
+        BOOST_TEST(b1.get_allocator().resource() == &mr1);
+#endif
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testBuffer();
+        testPmr();
+    }
+};
+
+TEST_SUITE(
+    dynamic_circular_buffer_test,
+    "boost.buffers.dynamic_circular_buffer");
+
+} // buffers
+} // boost
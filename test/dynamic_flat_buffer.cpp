@@ -0,0 +1,371 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/dynamic_flat_buffer.hpp>
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/type_traits.hpp>
+#include <boost/static_assert.hpp>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<
+        dynamic_flat_buffer>::value);
+
+struct dynamic_flat_buffer_test
+{
+    using buffer_type =
+        basic_dynamic_flat_buffer<
+            test_allocator<char>>;
+
+    template<class DynamicBuffer>
+    static
+    void
+    write(
+        DynamicBuffer& b,
+        std::string const& s)
+    {
+        b.commit(buffer_copy(
+            b.prepare(s.size()),
+            const_buffer(s.data(), s.size())));
+    }
+
+    void
+    testMembers()
+    {
+        auto const& pat = test_pattern();
+
+        // basic_dynamic_flat_buffer()
+        {
+            dynamic_flat_buffer b;
+            BOOST_TEST_EQ(b.size(), 0);
+            BOOST_TEST_EQ(b.capacity(), 0);
+            BOOST_TEST_GT(b.max_size(), 0);
+            BOOST_TEST_EQ(b.growth_factor(), 2);
+            BOOST_TEST_EQ(b.prepare(0).size(), 0);
+            b.commit(1);
+            b.consume(1);
+            BOOST_TEST_EQ(b.size(), 0);
+        }
+
+        // basic_dynamic_flat_buffer(Allocator)
+        {
+            std::size_t bytes = 0;
+            {
+                buffer_type b(
+                    (test_allocator<char>(&bytes)));
+                BOOST_TEST_EQ(b.size(), 0);
+                BOOST_TEST_GT(b.max_size(), 0);
+                write(b, pat);
+                BOOST_TEST_GT(bytes, 0);
+            }
+            BOOST_TEST_EQ(bytes, 0);
+        }
+
+        // basic_dynamic_flat_buffer(
+        //  std::size_t, double, Allocator)
+        {
+            std::size_t bytes = 0;
+            {
+                buffer_type b(100, 1.5,
+                    test_allocator<char>(&bytes));
+                BOOST_TEST_EQ(b.max_size(), 100);
+                BOOST_TEST_EQ(b.growth_factor(), 1.5);
+                BOOST_TEST_EQ(bytes, 0);
+                write(b, pat);
+                BOOST_TEST_EQ(bytes, 100);
+                BOOST_TEST(b.get_allocator() ==
+                    test_allocator<char>(&bytes));
+            }
+            BOOST_TEST_EQ(bytes, 0);
+
+            BOOST_TEST_THROWS(
+                dynamic_flat_buffer(100, 1),
+                std::invalid_argument);
+            BOOST_TEST_THROWS(
+                dynamic_flat_buffer(100, 0.5),
+                std::invalid_argument);
+        }
+
+        // prepare(std::size_t)
+        {
+            std::size_t bytes = 0;
+            buffer_type b(1000, 2,
+                test_allocator<char>(&bytes));
+            write(b, pat);
+            BOOST_TEST_EQ(b.capacity(), 512);
+            BOOST_TEST_THROWS(
+                b.prepare(1000 - pat.size() + 1),
+                std::length_error);
+
+            // clamped to max_size
+            auto const mb = b.prepare(
+                1000 - pat.size());
+            BOOST_TEST_EQ(mb.size(), 1000 - pat.size());
+            BOOST_TEST_EQ(b.capacity(), 1000);
+            BOOST_TEST_EQ(bytes, 1000);
+            BOOST_TEST_EQ(test_to_string(b.data()), pat);
+        }
+
+        // growth factor
+        {
+            dynamic_flat_buffer b(
+                std::size_t(-1), 1.5);
+            write(b, std::string(500, '*'));
+            BOOST_TEST_EQ(b.capacity(), 512);
+            write(b, std::string(20, '*'));
+            BOOST_TEST_EQ(b.capacity(), 768);
+            write(b, std::string(1000, '*'));
+            BOOST_TEST_EQ(b.capacity(), 1520);
+        }
+
+        // compaction
+        {
+            std::size_t bytes = 0;
+            buffer_type b(std::size_t(-1), 2,
+                test_allocator<char>(&bytes));
+            b.reserve(100);
+            BOOST_TEST_EQ(b.capacity(), 100);
+            write(b, std::string(60, '-') + pat);
+            auto const p = static_cast<
+                unsigned char const*>(b.data().data());
+
+            // small live data moves to the front
+            b.consume(60);
+            write(b, std::string(30, '*'));
+            BOOST_TEST_EQ(b.capacity(), 100);
+            BOOST_TEST_EQ(b.data().data(), p);
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                pat + std::string(30, '*'));
+
+            // large live data grows instead
+            b.consume(5);
+            write(b, std::string(70, '+'));
+            BOOST_TEST_EQ(b.capacity(), 512);
+            BOOST_TEST_EQ(bytes, 512);
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                pat.substr(5) + std::string(30, '*') +
+                std::string(70, '+'));
+
+            // unless it cannot grow
+            buffer_type b1(32, 2,
+                test_allocator<char>(&bytes));
+            write(b1, pat + pat);
+            b1.consume(10);
+            write(b1, "0123456789ab");
+            BOOST_TEST_EQ(b1.capacity(), 32);
+            BOOST_TEST_EQ(test_to_string(b1.data()),
+                pat.substr(10) + pat + "0123456789ab");
+
+            // an empty buffer starts over
+            b1.consume(100);
+            BOOST_TEST_EQ(b1.prepare(32).size(), 32);
+        }
+
+        // reserve, shrink_to_fit
+        {
+            std::size_t bytes = 0;
+            buffer_type b(1000, 2,
+                test_allocator<char>(&bytes));
+            b.reserve(10);
+            BOOST_TEST_EQ(bytes, 10);
+            write(b, "abc");
+            b.reserve(5);
+            BOOST_TEST_EQ(b.capacity(), 10);
+            BOOST_TEST_THROWS(
+                b.reserve(1001),
+                std::length_error);
+            b.shrink_to_fit();
+            BOOST_TEST_EQ(b.capacity(), 3);
+            BOOST_TEST_EQ(bytes, 3);
+            BOOST_TEST_EQ(test_to_string(b.data()), "abc");
+            b.consume(3);
+            b.shrink_to_fit();
+            BOOST_TEST_EQ(b.capacity(), 0);
+            BOOST_TEST_EQ(bytes, 0);
+        }
+
+        // idle_capacity
+        {
+            std::size_t bytes = 0;
+            buffer_type b(1000, 2,
+                test_allocator<char>(&bytes));
+            BOOST_TEST_EQ(b.idle_capacity(),
+                std::size_t(-1));
+            write(b, pat);
+            b.consume(pat.size());
+            BOOST_TEST_EQ(bytes, 512);
+
+            // releases at once when empty
+            b.idle_capacity(0);
+            BOOST_TEST_EQ(b.idle_capacity(), 0);
+            BOOST_TEST_EQ(bytes, 0);
+
+            // storage is held only while not empty
+            write(b, pat);
+            BOOST_TEST_EQ(bytes, 512);
+            b.consume(1);
+            BOOST_TEST_EQ(bytes, 512);
+            b.consume(pat.size());
+            BOOST_TEST_EQ(bytes, 0);
+            BOOST_TEST_EQ(b.capacity(), 0);
+
+            // kept when small enough
+            b.idle_capacity(512);
+            write(b, pat);
+            b.consume(pat.size());
+            BOOST_TEST_EQ(bytes, 512);
+
+            // copies and moves keep the setting
+            buffer_type b1(b);
+            BOOST_TEST_EQ(b1.idle_capacity(), 512);
+            buffer_type b2(std::move(b1));
+            BOOST_TEST_EQ(b2.idle_capacity(), 512);
+            b.idle_capacity(0);
+            b2 = b;
+            BOOST_TEST_EQ(b2.idle_capacity(), 0);
+        }
+
+        // copy
+        {
+            dynamic_flat_buffer b0(100);
+            write(b0, pat);
+            b0.consume(2);
+            dynamic_flat_buffer b1(b0);
+            BOOST_TEST_EQ(b1.capacity(), pat.size() - 2);
+            BOOST_TEST_EQ(test_to_string(
+                b1.data()), pat.substr(2));
+
+            dynamic_flat_buffer b2(100, 3);
+            write(b2, "xyz");
+            b2 = b0;
+            BOOST_TEST_EQ(b2.growth_factor(), 2);
+            BOOST_TEST_EQ(test_to_string(
+                b2.data()), pat.substr(2));
+            b2 = b2;
+            BOOST_TEST_EQ(test_to_string(
+                b2.data()), pat.substr(2));
+        }
+
+        // move
+        {
+            std::size_t bytes = 0;
+            buffer_type b0(100, 2,
+                test_allocator<char>(&bytes));
+            write(b0, pat);
+            auto const p = b0.data().data();
+            buffer_type b1(std::move(b0));
+            BOOST_TEST_EQ(b0.size(), 0);
+            BOOST_TEST_EQ(b0.capacity(), 0);
+            BOOST_TEST_EQ(b1.data().data(), p);
+
+            // equal allocators: no copy
+            buffer_type b2(100, 2,
+                test_allocator<char>(&bytes));
+            b2 = std::move(b1);
+            BOOST_TEST_EQ(b2.data().data(), p);
+            BOOST_TEST_EQ(b1.size(), 0);
+
+            // unequal allocators: copy
+            std::size_t bytes2 = 0;
+            buffer_type b3(100, 2,
+                test_allocator<char>(&bytes2));
+            b3 = std::move(b2);
+            BOOST_TEST_NE(b3.data().data(), p);
+            BOOST_TEST_EQ(test_to_string(b3.data()), pat);
+            BOOST_TEST_EQ(b2.size(), 0);
+        }
+    }
+
+    void
+    testStream()
+    {
+        // a long stream stays within a small
+        // multiple of the largest backlog
+        auto const& pat = test_pattern();
+        dynamic_flat_buffer b;
+        std::string s;
+        for(std::size_t i = 0; i < 5000; ++i)
+        {
+            auto const chunk = pat.substr(i % 11);
+            write(b, chunk);
+            s += chunk;
+            auto const n = (i % 4) * 4;
+            BOOST_TEST_EQ(test_to_string(b.data()), s);
+            b.consume(n);
+            s.erase(0, n);
+        }
+        BOOST_TEST_EQ(test_to_string(b.data()), s);
+        BOOST_TEST_LE(b.capacity(), 4 * s.size() + 512);
+    }
+
+    void
+    testBuffer()
+    {
+        auto const& pat = test_pattern();
+        for(std::size_t i = 0; i <= pat.size(); ++i)
+        {
+            dynamic_flat_buffer b(pat.size() + i);
+            write(b, std::string(i, '-'));
+            b.consume(i);
+            write(b, pat.substr(0, i));
+            write(b, pat.substr(i));
+            BOOST_TEST_EQ(test_to_string(
+                b.data()), pat);
+            test_buffer_sequence(b.data());
+        }
+    }
+
+    void
+    testPmr()
+    {
+#ifdef BOOST_BUFFERS_HAS_PMR
+        auto const& pat = test_pattern();
+        std::pmr::unsynchronized_pool_resource mr0;
+        std::pmr::unsynchronized_pool_resource mr1;
+        pmr::dynamic_flat_buffer b0(&mr0);
+        write(b0, pat);
+        BOOST_TEST(b0.get_allocator().resource() == &mr0);
+
+        // the resource does not propagate
+        pmr::dynamic_flat_buffer b1(&mr1);
+        b1 = b0;
+        BOOST_TEST_EQ(test_to_string(b1.data()), pat);
+        BOOST_TEST(b1.get_allocator().resource() == &mr1);
+        b1 = std::move(b0);
+        BOOST_TEST_EQ(test_to_string(b1.data()), pat);
+        BOOST_TEST(b1.get_allocator().resource() == &mr1);
+
+        // the default resource
+        pmr::dynamic_flat_buffer b2;
+        BOOST_TEST(b2.get_allocator().resource() ==
+            std::pmr::get_default_resource());
+#endif
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testStream();
+        testBuffer();
+        testPmr();
+    }
+};
+
+TEST_SUITE(
+    dynamic_flat_buffer_test,
+    "boost.buffers.dynamic_flat_buffer");
+
+} // buffers
+} // boost
@@ -129,6 +129,31 @@ struct flat_buffer_test
 
         // consume(std::size_t)
         {
+            std::string s(pat.size(), 0);
+            flat_buffer fb(&s[0], s.size());
+            fb.commit(buffer_copy(
+                fb.prepare(10),
+                make_buffer(&pat[0], 10)));
+            fb.consume(7);
+            BOOST_TEST_EQ(fb.size(), 3);
+            BOOST_TEST_EQ(fb.capacity(), s.size());
+            BOOST_TEST_EQ(test_to_string(
+                fb.data()), pat.substr(7, 3));
+
+            // the consumed space is reclaimed
+            auto const mb = fb.prepare(12);
+            BOOST_TEST_EQ(mb.size(), 12);
+            BOOST_TEST_EQ(mb.data(), &s[3]);
+            BOOST_TEST_EQ(test_to_string(
+                fb.data()), pat.substr(7, 3));
+            BOOST_TEST_THROWS(
+                fb.prepare(13),
+                std::invalid_argument);
+
+            fb.consume(100);
+            BOOST_TEST_EQ(fb.size(), 0);
+            BOOST_TEST_EQ(fb.prepare(
+                s.size()).size(), s.size());
         }
     }
 
@@ -0,0 +1,216 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/huge_page_arena.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/dynamic_flat_buffer.hpp>
+#include <boost/buffers/multi_buffer.hpp>
+#include <cstdint>
+#include <cstring>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+struct huge_page_arena_test
+{
+    static
+    std::uint64_t
+    mapped_allocations(
+        huge_page_arena::stats_type const& st)
+    {
+        return
+            st.hugetlb_allocations +
+            st.transparent_allocations +
+            st.normal_allocations;
+    }
+
+    void
+    testArena()
+    {
+        // huge_page_arena()
+        {
+            huge_page_arena a;
+            BOOST_TEST_EQ(a.huge_page_size(),
+                huge_page_arena::default_huge_page_size());
+            BOOST_TEST_EQ(a.threshold(),
+                a.huge_page_size() / 2);
+            auto const st = a.stats();
+            BOOST_TEST_EQ(mapped_allocations(st), 0);
+            BOOST_TEST_EQ(st.small_allocations, 0);
+            BOOST_TEST_EQ(st.bytes_mapped, 0);
+        }
+
+        // huge_page_arena(options)
+        {
+            huge_page_arena::options opt;
+            opt.huge_page_size = 4097;
+            BOOST_TEST_THROWS(
+                huge_page_arena{opt},
+                std::invalid_argument);
+        }
+
+        // allocate, deallocate
+        {
+            huge_page_arena a;
+            auto const hp = a.huge_page_size();
+            auto const n = hp + 1;
+            auto const p = static_cast<
+                unsigned char*>(a.allocate(n));
+            BOOST_TEST_EQ(reinterpret_cast<
+                std::uintptr_t>(p) % hp, 0);
+            std::memset(p, '*', n);
+            auto st = a.stats();
+            BOOST_TEST_EQ(mapped_allocations(st), 1);
+            BOOST_TEST_EQ(st.bytes_mapped, 2 * hp);
+
+            // small requests use the heap
+            auto const q = a.allocate(100);
+            std::memset(q, '*', 100);
+            st = a.stats();
+            BOOST_TEST_EQ(st.small_allocations, 1);
+            BOOST_TEST_EQ(st.bytes_mapped, 2 * hp);
+            a.deallocate(q, 100);
+
+            a.deallocate(p, n);
+            BOOST_TEST_EQ(a.stats().bytes_mapped, 0);
+        }
+
+        // each path can be turned off
+        {
+            huge_page_arena::options opt;
+            opt.use_hugetlb = false;
+            opt.use_transparent = false;
+            huge_page_arena a(opt);
+            auto const n = a.huge_page_size();
+            auto const p = a.allocate(n);
+            std::memset(p, '*', n);
+            auto const st = a.stats();
+            BOOST_TEST_EQ(st.normal_allocations, 1);
+            BOOST_TEST_EQ(st.hugetlb_allocations, 0);
+            BOOST_TEST_EQ(st.transparent_allocations, 0);
+            a.deallocate(p, n);
+        }
+        {
+            huge_page_arena::options opt;
+            opt.use_hugetlb = false;
+            huge_page_arena a(opt);
+            auto const n = a.huge_page_size();
+            auto const p = a.allocate(n);
+            auto const st = a.stats();
+            BOOST_TEST_EQ(st.hugetlb_allocations, 0);
+            BOOST_TEST_EQ(
+                st.transparent_allocations +
+                st.normal_allocations, 1);
+            a.deallocate(p, n);
+        }
+
+        // a lower threshold
+        {
+            huge_page_arena::options opt;
+            opt.threshold = 1;
+            huge_page_arena a(opt);
+            auto const p = a.allocate(10);
+            BOOST_TEST_EQ(mapped_allocations(a.stats()), 1);
+            BOOST_TEST_EQ(a.stats().bytes_mapped,
+                a.huge_page_size());
+            a.deallocate(p, 10);
+            BOOST_TEST_EQ(a.stats().bytes_mapped, 0);
+        }
+    }
+
+    void
+    testAllocator()
+    {
+        auto const& pat = test_pattern();
+        huge_page_arena::options opt;
+        opt.threshold = 64;
+        huge_page_arena a(opt);
+        huge_page_allocator<unsigned char> alloc(a);
+        BOOST_TEST(alloc == huge_page_allocator<char>(alloc));
+        BOOST_TEST(&alloc.arena() == &a);
+
+        {
+            basic_dynamic_flat_buffer<
+                huge_page_allocator<unsigned char>> b(
+                    std::size_t(-1), 2, alloc);
+            b.commit(buffer_copy(
+                b.prepare(pat.size()),
+                const_buffer(pat.data(), pat.size())));
+            BOOST_TEST_EQ(test_to_string(b.data()), pat);
+            BOOST_TEST_EQ(mapped_allocations(a.stats()), 1);
+        }
+        BOOST_TEST_EQ(a.stats().bytes_mapped, 0);
+
+        {
+            basic_multi_buffer<
+                huge_page_allocator<unsigned char>> b(
+                    std::size_t(-1), 16, alloc);
+            for(int i = 0; i < 4; ++i)
+                b.commit(buffer_copy(
+                    b.prepare(pat.size()),
+                    const_buffer(pat.data(), pat.size())));
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                pat + pat + pat + pat);
+        }
+        BOOST_TEST_EQ(a.stats().bytes_mapped, 0);
+    }
+
+    void
+    testResource()
+    {
+#ifdef BOOST_BUFFERS_HAS_PMR
+        huge_page_arena::options opt;
+        opt.threshold = 64;
+        huge_page_arena a(opt);
+        huge_page_resource mr(a);
+        BOOST_TEST(&mr.arena() == &a);
+        {
+            pmr::dynamic_flat_buffer b(&mr);
+            b.commit(buffer_copy(
+                b.prepare(1000),
+                const_buffer(test_pattern().data(),
+                    test_pattern().size())));
+            BOOST_TEST_EQ(mapped_allocations(a.stats()), 1);
+        }
+        BOOST_TEST_EQ(a.stats().bytes_mapped, 0);
+
+        // small overaligned requests bypass the arena
+        auto const q = mr.allocate(16, 256);
+        BOOST_TEST_EQ(reinterpret_cast<
+            std::uintptr_t>(q) % 256, 0);
+        mr.deallocate(q, 16, 256);
+        BOOST_TEST_EQ(a.stats().small_allocations, 0);
+
+        huge_page_resource mr2(a);
+        BOOST_TEST(mr.is_equal(mr2));
+#endif
+    }
+
+    void
+    run()
+    {
+        testArena();
+        testAllocator();
+        testResource();
+    }
+};
+
+TEST_SUITE(
+    huge_page_arena_test,
+    "boost.buffers.huge_page_arena");
+
+} // buffers
+} // boost
+
+#endif
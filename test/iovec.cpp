@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/iovec.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/const_buffer_pair.hpp>
+#include <boost/buffers/mutable_buffer.hpp>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+struct iovec_test
+{
+    void
+    testToIovec()
+    {
+        auto const& pat = test_pattern();
+        ::iovec iov[4];
+
+        // const_buffer
+        {
+            const_buffer b(pat.data(), pat.size());
+            BOOST_TEST_EQ(to_iovec(b, iov, 4), 1);
+            BOOST_TEST_EQ(iov[0].iov_base, pat.data());
+            BOOST_TEST_EQ(iov[0].iov_len, pat.size());
+            BOOST_TEST_EQ(to_iovec(b, iov, 0), 0);
+            BOOST_TEST_EQ(to_iovec(
+                const_buffer(), iov, 4), 0);
+        }
+
+        // mutable_buffer
+        {
+            std::string s = pat;
+            mutable_buffer b(&s[0], s.size());
+            BOOST_TEST_EQ(to_iovec(b, iov, 4), 1);
+            BOOST_TEST_EQ(iov[0].iov_base, s.data());
+        }
+
+        // empty buffers are skipped
+        {
+            const_buffer_pair b(
+                const_buffer(pat.data(), 0),
+                const_buffer(pat.data() + 3, 5));
+            BOOST_TEST_EQ(to_iovec(b, iov, 4), 1);
+            BOOST_TEST_EQ(iov[0].iov_base, pat.data() + 3);
+            BOOST_TEST_EQ(iov[0].iov_len, 5);
+        }
+
+        // the array limits the count
+        {
+            const_buffer_pair b(
+                const_buffer(pat.data(), 3),
+                const_buffer(pat.data() + 3, 5));
+            BOOST_TEST_EQ(to_iovec(b, iov, 4), 2);
+            BOOST_TEST_EQ(iov[1].iov_base, pat.data() + 3);
+            BOOST_TEST_EQ(iov[1].iov_len, 5);
+            iov[1].iov_len = 0;
+            BOOST_TEST_EQ(to_iovec(b, iov, 1), 1);
+            BOOST_TEST_EQ(iov[0].iov_len, 3);
+            BOOST_TEST_EQ(iov[1].iov_len, 0);
+        }
+    }
+
+    void
+    run()
+    {
+        testToIovec();
+    }
+};
+
+TEST_SUITE(
+    iovec_test,
+    "boost.buffers.iovec");
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,237 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/mapped_file.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/algorithm.hpp>
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/system/system_error.hpp>
+#include <boost/static_assert.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include "test_helpers.hpp"
+
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_const_buffer_sequence<mapped_file>::value);
+
+BOOST_STATIC_ASSERT(
+    is_const_buffer_sequence<mapped_file_buffers>::value);
+
+BOOST_STATIC_ASSERT(
+    detail::is_bidirectional_iterator<
+        mapped_file::const_iterator>::value);
+
+struct mapped_file_test
+{
+    static
+    std::size_t
+    page()
+    {
+        return static_cast<std::size_t>(
+            ::sysconf(_SC_PAGESIZE));
+    }
+
+    static
+    std::string
+    make_data(std::size_t n)
+    {
+        std::string s(n, 0);
+        std::uint32_t seed = 1;
+        for(auto& c : s)
+        {
+            seed = seed * 1103515245 + 12345;
+            c = static_cast<char>(seed >> 24);
+        }
+        return s;
+    }
+
+    void
+    testMembers()
+    {
+        auto const w = page();
+        auto const s = make_data(3 * w + w / 2);
+        test_temp_file tf;
+        tf.append(s);
+
+        // mapped_file()
+        {
+            mapped_file f;
+            BOOST_TEST_EQ(f.size(), 0);
+            BOOST_TEST(f.begin() == f.end());
+            BOOST_TEST_EQ(buffer_size(f), 0);
+            f.consume(1);
+        }
+
+        // mapped_file(int, ...)
+        {
+            mapped_file f(tf.fd, 0, std::uint64_t(-1), w);
+            BOOST_TEST_EQ(f.size(), s.size());
+            BOOST_TEST_EQ(f.window_size(), w);
+            BOOST_TEST_EQ(f.mapped_windows(), 4);
+            BOOST_TEST_EQ(std::distance(
+                f.begin(), f.end()), 4);
+            BOOST_TEST(test_to_string(f) == s);
+            BOOST_TEST_EQ(f.mapped_windows(), 4);
+            BOOST_TEST_EQ(buffer_size(f), s.size());
+            BOOST_TEST_EQ(buffer_size(
+                f.buffers()), s.size());
+            BOOST_TEST_EQ(buffer_size(
+                prefix(f, w + 1)), w + 1);
+            BOOST_TEST_EQ(buffer_size(
+                suffix(f, 10)), 10);
+
+            // the last window is short
+            auto it = f.end();
+            --it;
+            BOOST_TEST_EQ((*it).size(), w / 2);
+        }
+
+        // a range which does not start
+        // or end on a window boundary
+        {
+            mapped_file f(tf.fd, w - 10, w + 20, w);
+            BOOST_TEST_EQ(f.size(), w + 20);
+            BOOST_TEST_EQ(std::distance(
+                f.begin(), f.end()), 3);
+            BOOST_TEST(test_to_string(f) ==
+                s.substr(w - 10, w + 20));
+            auto it = f.begin();
+            BOOST_TEST_EQ((*it++).size(), 10);
+            BOOST_TEST_EQ((*it++).size(), w);
+            BOOST_TEST_EQ((*it++).size(), 10);
+            BOOST_TEST(it == f.end());
+        }
+
+        // length clamped to the file
+        {
+            mapped_file f(tf.fd, w, 100 * w, w);
+            BOOST_TEST_EQ(f.size(), s.size() - w);
+            mapped_file f1(tf.fd, s.size(),
+                std::uint64_t(-1), w);
+            BOOST_TEST_EQ(f1.size(), 0);
+            BOOST_TEST(f1.begin() == f1.end());
+        }
+
+        // consume(std::size_t)
+        {
+            mapped_file f(tf.fd, 0, std::uint64_t(-1), w);
+            test_to_string(f);
+            BOOST_TEST_EQ(f.mapped_windows(), 4);
+            f.consume(w - 1);
+            BOOST_TEST_EQ(f.mapped_windows(), 4);
+            f.consume(1);
+            BOOST_TEST_EQ(f.mapped_windows(), 3);
+            BOOST_TEST(test_to_string(f) == s.substr(w));
+            f.consume(2 * w + 1);
+            BOOST_TEST_EQ(f.mapped_windows(), 1);
+            BOOST_TEST(test_to_string(f) ==
+                s.substr(3 * w + 1));
+            f.consume(s.size());
+            BOOST_TEST_EQ(f.size(), 0);
+            BOOST_TEST_EQ(f.mapped_windows(), 0);
+            BOOST_TEST(f.begin() == f.end());
+        }
+
+        // buffer_copy
+        {
+            mapped_file f(tf.fd, 0, std::uint64_t(-1), w);
+            std::string out;
+            char buf[1000];
+            while(f.size() > 0)
+            {
+                auto const n = buffer_copy(
+                    make_buffer(buf, sizeof(buf)), f);
+                out.append(buf, n);
+                f.consume(n);
+
+                // consumed windows are unmapped
+                auto const pos = s.size() - f.size();
+                BOOST_TEST_EQ(f.mapped_windows(),
+                    f.size() == 0 ? 0 : 4 - pos / w);
+            }
+            BOOST_TEST(out == s);
+        }
+
+        // move
+        {
+            mapped_file f0(tf.fd, 5, 10, w);
+            mapped_file f1(std::move(f0));
+            BOOST_TEST_EQ(f0.size(), 0);
+            BOOST_TEST_EQ(test_to_string(f1), s.substr(5, 10));
+            mapped_file f2(tf.fd, 0, 10, w);
+            test_to_string(f2);
+            f2 = std::move(f1);
+            BOOST_TEST_EQ(test_to_string(f2), s.substr(5, 10));
+        }
+
+        // errors
+        {
+            BOOST_TEST_THROWS(
+                mapped_file("/nonexistent/boost.buffers"),
+                system::system_error);
+            BOOST_TEST_THROWS(
+                mapped_file(tf.fd, 0, 10, w + 1),
+                std::invalid_argument);
+            BOOST_TEST_THROWS(
+                mapped_file(tf.fd, s.size() + 1),
+                std::invalid_argument);
+        }
+    }
+
+    void
+    testSequence()
+    {
+        // the pattern straddles a window boundary
+        auto const& pat = test_pattern();
+        auto const w = page();
+        test_temp_file tf;
+        tf.append(std::string(w - 7, '-') + pat);
+        mapped_file f(tf.fd, w - 7,
+            std::uint64_t(-1), w);
+        BOOST_TEST_EQ(std::distance(
+            f.begin(), f.end()), 2);
+        test_buffer_sequence(f);
+        test_buffer_sequence(f.buffers());
+        for(std::size_t i = 0; i <= pat.size(); ++i)
+        {
+            BOOST_TEST_EQ(test_to_string(
+                prefix(f, i)), pat.substr(0, i));
+            BOOST_TEST_EQ(test_to_string(
+                suffix(f, i)),
+                pat.substr(pat.size() - i));
+            BOOST_TEST_EQ(test_to_string(
+                sans_prefix(f, i)), pat.substr(i));
+        }
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testSequence();
+    }
+};
+
+TEST_SUITE(
+    mapped_file_test,
+    "boost.buffers.mapped_file");
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,269 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/monotonic_arena.hpp>
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/dynamic_flat_buffer.hpp>
+#include <boost/buffers/multi_buffer.hpp>
+#include <boost/buffers/vector_buffer.hpp>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+struct monotonic_arena_test
+{
+    static
+    bool
+    inside(
+        void const* p,
+        void const* first,
+        std::size_t n) noexcept
+    {
+        auto const a = reinterpret_cast<std::uintptr_t>(p);
+        auto const b = reinterpret_cast<std::uintptr_t>(first);
+        return a >= b && a < b + n;
+    }
+
+    void
+    testArena()
+    {
+        // monotonic_arena()
+        {
+            monotonic_arena a;
+            auto const st = a.stats();
+            BOOST_TEST_EQ(st.bytes_allocated, 0);
+            BOOST_TEST_EQ(st.chunks, 0);
+            BOOST_TEST_EQ(st.bytes_reserved, 0);
+
+            auto const p = a.allocate(10);
+            std::memset(p, '*', 10);
+            BOOST_TEST_EQ(a.stats().chunks, 1);
+            BOOST_TEST_EQ(a.stats().bytes_reserved,
+                monotonic_arena::default_chunk_size);
+            BOOST_TEST_EQ(a.stats().bytes_allocated, 10);
+        }
+
+        // monotonic_arena(void*, std::size_t)
+        {
+            alignas(std::max_align_t) char buf[256];
+            monotonic_arena a(buf, sizeof(buf));
+            auto const p = a.allocate(100);
+            auto const q = a.allocate(100);
+            BOOST_TEST(inside(p, buf, sizeof(buf)));
+            BOOST_TEST(inside(q, buf, sizeof(buf)));
+            BOOST_TEST_EQ(a.stats().chunks, 0);
+
+            // the buffer is exhausted
+            auto const r = a.allocate(100);
+            BOOST_TEST(! inside(r, buf, sizeof(buf)));
+            BOOST_TEST_EQ(a.stats().chunks, 1);
+        }
+
+        // allocate alignment
+        {
+            monotonic_arena a;
+            a.allocate(1, 1);
+            auto const p = a.allocate(8, 64);
+            BOOST_TEST_EQ(reinterpret_cast<
+                std::uintptr_t>(p) % 64, 0);
+            auto const q = a.allocate(8, 4096);
+            BOOST_TEST_EQ(reinterpret_cast<
+                std::uintptr_t>(q) % 4096, 0);
+            BOOST_TEST_THROWS(a.allocate(1, 3),
+                std::invalid_argument);
+            BOOST_TEST_THROWS(a.allocate(1, 0),
+                std::invalid_argument);
+        }
+
+        // chunks grow geometrically
+        {
+            monotonic_arena a(64);
+            for(int i = 0; i < 8; ++i)
+                a.allocate(64);
+            BOOST_TEST_EQ(a.stats().chunks, 4);
+            BOOST_TEST_EQ(a.stats().bytes_reserved,
+                64 + 128 + 256 + 512);
+
+            // a large request gets a chunk of its own
+            a.allocate(10000);
+            BOOST_TEST_EQ(a.stats().chunks, 5);
+        }
+
+        // deallocate
+        {
+            alignas(std::max_align_t) char buf[64];
+            monotonic_arena a(buf, sizeof(buf));
+            auto const p = a.allocate(16);
+            auto const q = a.allocate(16);
+            a.deallocate(p, 16);
+            BOOST_TEST_EQ(a.stats().bytes_allocated, 32);
+
+            // the most recent allocation is given back
+            a.deallocate(q, 16);
+            BOOST_TEST_EQ(a.stats().bytes_allocated, 16);
+            BOOST_TEST_EQ(a.allocate(16), q);
+        }
+
+        // reset
+        {
+            alignas(std::max_align_t) char buf[64];
+            monotonic_arena a(buf, sizeof(buf), 128);
+            auto const p0 = a.allocate(64);
+            auto const p1 = a.allocate(128);
+            auto const p2 = a.allocate(256);
+            BOOST_TEST_EQ(p0, static_cast<void*>(buf));
+            BOOST_TEST_EQ(a.stats().chunks, 2);
+            auto const reserved =
+                a.stats().bytes_reserved;
+
+            a.reset();
+            BOOST_TEST_EQ(a.stats().bytes_allocated, 0);
+            BOOST_TEST_EQ(a.stats().chunks, 2);
+
+            // the same memory is reused, in order
+            BOOST_TEST_EQ(a.allocate(64), p0);
+            BOOST_TEST_EQ(a.allocate(128), p1);
+            BOOST_TEST_EQ(a.allocate(256), p2);
+            BOOST_TEST_EQ(a.stats().bytes_reserved,
+                reserved);
+
+            // chunks too small are skipped
+            a.reset();
+            a.allocate(200);
+            BOOST_TEST_EQ(a.stats().chunks, 2);
+            a.allocate(128);
+            BOOST_TEST_EQ(a.stats().chunks, 3);
+        }
+
+        // release
+        {
+            monotonic_arena a;
+            a.allocate(10);
+            a.allocate(10000);
+            BOOST_TEST_EQ(a.stats().chunks, 2);
+            a.release();
+            BOOST_TEST_EQ(a.stats().chunks, 0);
+            BOOST_TEST_EQ(a.stats().bytes_reserved, 0);
+            a.allocate(10);
+            BOOST_TEST_EQ(a.stats().chunks, 1);
+        }
+    }
+
+    void
+    testStatic()
+    {
+        static_monotonic_arena<512> a;
+        for(int i = 0; i < 8; ++i)
+            std::memset(a.allocate(64), '*', 64);
+        BOOST_TEST_EQ(a.stats().chunks, 0);
+        BOOST_TEST_EQ(a.stats().bytes_allocated, 512);
+        a.allocate(1);
+        BOOST_TEST_EQ(a.stats().chunks, 1);
+        a.reset();
+        a.allocate(512);
+        BOOST_TEST_EQ(a.stats().chunks, 1);
+        BOOST_TEST_EQ(a.stats().bytes_allocated, 512);
+    }
+
+    void
+    testAllocator()
+    {
+        auto const& pat = test_pattern();
+        static_monotonic_arena<1024> a;
+        monotonic_allocator<unsigned char> alloc(a);
+        BOOST_TEST(alloc == monotonic_allocator<char>(alloc));
+        BOOST_TEST(&alloc.arena() == &a);
+
+        {
+            basic_dynamic_flat_buffer<
+                monotonic_allocator<unsigned char>> b(
+                    std::size_t(-1), 2, alloc);
+            b.commit(buffer_copy(
+                b.prepare(pat.size()),
+                const_buffer(pat.data(), pat.size())));
+            BOOST_TEST_EQ(test_to_string(b.data()), pat);
+        }
+
+        {
+            basic_multi_buffer<
+                monotonic_allocator<unsigned char>> b(
+                    std::size_t(-1), 16, alloc);
+            for(int i = 0; i < 4; ++i)
+                b.commit(buffer_copy(
+                    b.prepare(pat.size()),
+                    const_buffer(pat.data(), pat.size())));
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                pat + pat + pat + pat);
+        }
+
+        {
+            using vector_type = std::vector<
+                unsigned char, default_init_allocator<
+                    unsigned char, monotonic_allocator<
+                        unsigned char>>>;
+            vector_type v{vector_type::allocator_type(alloc)};
+            basic_vector_buffer<
+                vector_type::allocator_type> b(&v);
+            b.commit(buffer_copy(
+                b.prepare(pat.size()),
+                const_buffer(pat.data(), pat.size())));
+            BOOST_TEST_EQ(test_to_string(b.data()), pat);
+        }
+
+        // nothing left the inline buffer
+        BOOST_TEST_EQ(a.stats().chunks, 0);
+        a.reset();
+        BOOST_TEST_EQ(a.stats().bytes_allocated, 0);
+    }
+
+    void
+    testResource()
+    {
+#ifdef BOOST_BUFFERS_HAS_PMR
+        static_monotonic_arena<1024> a;
+        monotonic_resource mr(a);
+        BOOST_TEST(&mr.arena() == &a);
+        {
+            std::pmr::vector<int> v(&mr);
+            for(int i = 0; i < 50; ++i)
+                v.push_back(i);
+            BOOST_TEST_EQ(v[49], 49);
+            BOOST_TEST(inside(v.data(), &a,
+                sizeof(a)));
+        }
+        monotonic_resource mr2(a);
+        BOOST_TEST(mr.is_equal(mr2));
+        monotonic_arena b;
+        monotonic_resource mr3(b);
+        BOOST_TEST(! mr.is_equal(mr3));
+#endif
+    }
+
+    void
+    run()
+    {
+        testArena();
+        testStatic();
+        testAllocator();
+        testResource();
+    }
+};
+
+TEST_SUITE(
+    monotonic_arena_test,
+    "boost.buffers.monotonic_arena");
+
+} // buffers
+} // boost
@@ -0,0 +1,498 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/multi_buffer.hpp>
+
+#include <boost/buffers/type_traits.hpp>
+#include <boost/static_assert.hpp>
+#include <memory>
+#include <new>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<multi_buffer>::value);
+
+// throws once a number of
+// allocations have been made
+template<class T>
+struct failing_allocator
+{
+    using value_type = T;
+
+    std::size_t* left;
+
+    explicit
+    failing_allocator(
+        std::size_t* p) noexcept
+        : left(p)
+    {
+    }
+
+    template<class U>
+    failing_allocator(
+        failing_allocator<U> const& other) noexcept
+        : left(other.left)
+    {
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        if(*left == 0)
+            throw std::bad_alloc();
+        --*left;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template<class U>
+    bool
+    operator==(
+        failing_allocator<U> const& other) const noexcept
+    {
+        return left == other.left;
+    }
+
+    template<class U>
+    bool
+    operator!=(
+        failing_allocator<U> const& other) const noexcept
+    {
+        return left != other.left;
+    }
+};
+
+struct multi_buffer_test
+{
+    using buffer_type =
+        basic_multi_buffer<
+            test_allocator<char>>;
+
+    template<class DynamicBuffer>
+    static
+    void
+    write(
+        DynamicBuffer& b,
+        std::string const& s)
+    {
+        b.commit(buffer_copy(
+            b.prepare(s.size()),
+            const_buffer(s.data(), s.size())));
+    }
+
+    static
+    std::size_t
+    length(const_buffer_span const& s)
+    {
+        return s.end() - s.begin();
+    }
+
+    static
+    std::size_t
+    length(mutable_buffer_span const& s)
+    {
+        return s.end() - s.begin();
+    }
+
+    void
+    testMembers()
+    {
+        auto const& pat = test_pattern();
+
+        // basic_multi_buffer()
+        {
+            multi_buffer b;
+            BOOST_TEST_EQ(b.size(), 0);
+            BOOST_TEST_EQ(b.capacity(), 0);
+            BOOST_TEST_EQ(b.blocks(), 0);
+            BOOST_TEST_EQ(b.block_size(),
+                multi_buffer::default_block_size);
+            BOOST_TEST_EQ(length(b.data()), 0);
+            BOOST_TEST_EQ(length(b.prepare(0)), 0);
+            b.commit(1);
+            b.consume(1);
+            BOOST_TEST_EQ(b.size(), 0);
+        }
+
+        // basic_multi_buffer(Allocator)
+        {
+            std::size_t bytes = 0;
+            {
+                buffer_type b(
+                    (test_allocator<char>(&bytes)));
+                BOOST_TEST_EQ(b.block_size(),
+                    buffer_type::default_block_size);
+                write(b, pat);
+                BOOST_TEST_GT(bytes, 0);
+            }
+            BOOST_TEST_EQ(bytes, 0);
+        }
+
+        // basic_multi_buffer(
+        //  std::size_t, std::size_t, Allocator)
+        {
+            std::size_t bytes = 0;
+            {
+                buffer_type b(100, 4,
+                    test_allocator<char>(&bytes));
+                BOOST_TEST_EQ(b.max_size(), 100);
+                BOOST_TEST_EQ(b.block_size(), 4);
+                write(b, pat);
+                BOOST_TEST_GT(bytes, 0);
+                BOOST_TEST(b.get_allocator() ==
+                    test_allocator<char>(&bytes));
+            }
+            BOOST_TEST_EQ(bytes, 0);
+
+            BOOST_TEST_THROWS(
+                multi_buffer(100, 0),
+                std::invalid_argument);
+        }
+
+        // prepare(std::size_t)
+        {
+            multi_buffer b(20, 4);
+            auto mb = b.prepare(10);
+            BOOST_TEST_EQ(buffer_size(mb), 10);
+            BOOST_TEST_EQ(length(mb), 3);
+            BOOST_TEST_EQ(b.blocks(), 3);
+            BOOST_TEST_EQ(b.capacity(), 12);
+
+            // spare blocks are reused
+            mb = b.prepare(12);
+            BOOST_TEST_EQ(length(mb), 3);
+            BOOST_TEST_EQ(b.blocks(), 3);
+            mb = b.prepare(13);
+            BOOST_TEST_EQ(b.blocks(), 4);
+
+            BOOST_TEST_THROWS(
+                b.prepare(21),
+                std::length_error);
+        }
+
+        // commit(std::size_t)
+        {
+            multi_buffer b(100, 4);
+            b.prepare(10);
+            b.commit(6);
+            BOOST_TEST_EQ(b.size(), 6);
+            BOOST_TEST_EQ(length(b.data()), 2);
+            BOOST_TEST_EQ(b.capacity(), 6);
+
+            // writes continue in the last block
+            auto mb = b.prepare(3);
+            BOOST_TEST_EQ(length(mb), 2);
+            BOOST_TEST_EQ(mb.begin()->size(), 2);
+            b.commit(100);
+            BOOST_TEST_EQ(b.size(), 9);
+            BOOST_TEST_EQ(length(b.data()), 3);
+        }
+
+        // consume(std::size_t)
+        {
+            std::size_t bytes = 0;
+            buffer_type b(100, 4,
+                test_allocator<char>(&bytes));
+            write(b, pat);
+            BOOST_TEST_EQ(b.blocks(), 4);
+            b.consume(3);
+            BOOST_TEST_EQ(b.blocks(), 4);
+            BOOST_TEST_EQ(test_to_string(
+                b.data()), pat.substr(3));
+            b.consume(1);
+            BOOST_TEST_EQ(b.blocks(), 3);
+            b.consume(5);
+            BOOST_TEST_EQ(b.blocks(), 2);
+            BOOST_TEST_EQ(test_to_string(
+                b.data()), pat.substr(9));
+
+            // the last block is kept
+            b.consume(100);
+            BOOST_TEST_EQ(b.size(), 0);
+            BOOST_TEST_EQ(b.blocks(), 1);
+            BOOST_TEST_EQ(b.capacity(), 4);
+            write(b, "abc");
+            BOOST_TEST_EQ(b.blocks(), 1);
+            BOOST_TEST_EQ(test_to_string(
+                b.data()), "abc");
+
+            b.shrink_to_fit();
+            BOOST_TEST_EQ(b.blocks(), 1);
+            b.consume(3);
+            b.shrink_to_fit();
+            BOOST_TEST_EQ(b.blocks(), 0);
+            BOOST_TEST_EQ(b.capacity(), 0);
+        }
+
+        // long stream
+        {
+            std::size_t bytes = 0;
+            buffer_type b(std::size_t(-1), 16,
+                test_allocator<char>(&bytes));
+            std::string s;
+            std::size_t max_blocks = 0;
+            for(std::size_t i = 0; i < 2000; ++i)
+            {
+                auto const chunk = pat.substr(i % 7);
+                write(b, chunk);
+                s += chunk;
+                auto const n = (i % 3) * 5;
+                BOOST_TEST_EQ(test_to_string(
+                    b.data()), s);
+                b.consume(n);
+                s.erase(0, n);
+                if(max_blocks < b.blocks())
+                    max_blocks = b.blocks();
+            }
+            BOOST_TEST_EQ(test_to_string(b.data()), s);
+            BOOST_TEST_EQ(b.size(), s.size());
+            BOOST_TEST_LE(b.blocks(),
+                s.size() / 16 + 2);
+        }
+
+        // copy
+        {
+            multi_buffer b0(100, 4);
+            write(b0, pat);
+            b0.consume(2);
+            multi_buffer b1(b0);
+            BOOST_TEST_EQ(test_to_string(
+                b1.data()), pat.substr(2));
+            BOOST_TEST_EQ(b1.block_size(), 4);
+
+            multi_buffer b2(100, 8);
+            write(b2, "xyz");
+            b2 = b0;
+            BOOST_TEST_EQ(test_to_string(
+                b2.data()), pat.substr(2));
+            BOOST_TEST_EQ(b2.block_size(), 4);
+        }
+
+        // move
+        {
+            std::size_t bytes = 0;
+            buffer_type b0(100, 4,
+                test_allocator<char>(&bytes));
+            write(b0, pat);
+            auto const p = b0.data().begin()->data();
+            buffer_type b1(std::move(b0));
+            BOOST_TEST_EQ(b0.size(), 0);
+            BOOST_TEST_EQ(b0.blocks(), 0);
+            BOOST_TEST_EQ(b1.data().begin()->data(), p);
+            BOOST_TEST_EQ(test_to_string(b1.data()), pat);
+
+            // equal allocators: no copy
+            buffer_type b2(100, 4,
+                test_allocator<char>(&bytes));
+            b2 = std::move(b1);
+            BOOST_TEST_EQ(b2.data().begin()->data(), p);
+            BOOST_TEST_EQ(b1.size(), 0);
+
+            // unequal allocators: copy
+            std::size_t bytes2 = 0;
+            buffer_type b3(100, 4,
+                test_allocator<char>(&bytes2));
+            b3 = std::move(b2);
+            BOOST_TEST_NE(b3.data().begin()->data(), p);
+            BOOST_TEST_EQ(test_to_string(b3.data()), pat);
+            BOOST_TEST_EQ(b2.size(), 0);
+        }
+    }
+
+    void
+    testSplice()
+    {
+        auto const& pat = test_pattern();
+
+        // blocks are moved
+        {
+            std::size_t bytes = 0;
+            buffer_type b0(100, 4,
+                test_allocator<char>(&bytes));
+            buffer_type b1(100, 4,
+                test_allocator<char>(&bytes));
+            write(b0, "abcde");
+            write(b1, pat);
+            b1.consume(1);
+            auto const p = b1.data().begin()->data();
+            b1.prepare(8);
+            auto const spare = b1.blocks() - 4;
+
+            b0.splice(b1);
+            BOOST_TEST_EQ(b1.size(), 0);
+            BOOST_TEST_EQ(b1.blocks(), spare);
+            BOOST_TEST_EQ(b0.size(), 5 + pat.size() - 1);
+            BOOST_TEST_EQ(test_to_string(
+                b0.data()), "abcde" + pat.substr(1));
+            BOOST_TEST_EQ(length(b0.data()), 6);
+            BOOST_TEST_EQ(
+                b0.data().begin()[2].data(), p);
+
+            // writing continues after the
+            // spliced blocks
+            write(b0, "XYZ");
+            BOOST_TEST_EQ(test_to_string(
+                b0.data()), "abcde" + pat.substr(1) + "XYZ");
+            b0.consume(7);
+            BOOST_TEST_EQ(test_to_string(
+                b0.data()), pat.substr(3) + "XYZ");
+
+            // b1 is still usable
+            write(b1, "123");
+            BOOST_TEST_EQ(test_to_string(
+                b1.data()), "123");
+        }
+
+        // into an empty buffer
+        {
+            multi_buffer b0(100, 4);
+            multi_buffer b1(100, 4);
+            write(b1, pat);
+            b0.splice(b1);
+            BOOST_TEST_EQ(test_to_string(
+                b0.data()), pat);
+            b0.splice(b1);
+            b0.splice(b0);
+            BOOST_TEST_EQ(test_to_string(
+                b0.data()), pat);
+        }
+
+        // different block sizes copy
+        {
+            multi_buffer b0(100, 4);
+            multi_buffer b1(100, 8);
+            write(b0, "ab");
+            write(b1, pat);
+            b0.splice(b1);
+            BOOST_TEST_EQ(b1.size(), 0);
+            BOOST_TEST_EQ(test_to_string(
+                b0.data()), "ab" + pat);
+        }
+
+        // the allocator fails part way
+        for(std::size_t k = 0;; ++k)
+        {
+            using failing_buffer =
+                basic_multi_buffer<
+                    failing_allocator<char>>;
+            std::size_t left = std::size_t(-1);
+            failing_buffer b0(100, 4,
+                failing_allocator<char>(&left));
+            failing_buffer b1(100, 4,
+                failing_allocator<char>(&left));
+            write(b0, "abcde");
+            b0.prepare(12);
+            write(b1, pat);
+            left = k;
+            try
+            {
+                b0.splice(b1);
+            }
+            catch(std::bad_alloc const&)
+            {
+                // both are unchanged
+                BOOST_TEST_EQ(test_to_string(
+                    b0.data()), "abcde");
+                BOOST_TEST_EQ(test_to_string(
+                    b1.data()), pat);
+                continue;
+            }
+            BOOST_TEST_EQ(test_to_string(
+                b0.data()), "abcde" + pat);
+            BOOST_TEST_EQ(b1.size(), 0);
+            left = std::size_t(-1);
+            write(b0, "XYZ");
+            write(b1, "123");
+            BOOST_TEST_EQ(test_to_string(
+                b0.data()), "abcde" + pat + "XYZ");
+            BOOST_TEST_EQ(test_to_string(
+                b1.data()), "123");
+            BOOST_TEST_GE(k, 1);
+            break;
+        }
+
+        // exceeds max_size
+        {
+            multi_buffer b0(10, 4);
+            multi_buffer b1(100, 4);
+            write(b0, "ab");
+            write(b1, pat);
+            BOOST_TEST_THROWS(
+                b0.splice(b1),
+                std::length_error);
+            BOOST_TEST_EQ(b1.size(), pat.size());
+        }
+    }
+
+    void
+    testBuffer()
+    {
+        auto const& pat = test_pattern();
+
+        for(std::size_t bs = 1; bs <= 6; ++bs)
+        for(std::size_t i = 0; i <= pat.size(); ++i)
+        {
+            multi_buffer b(pat.size() + bs, bs);
+            write(b, std::string(i, '-'));
+            b.consume(i);
+            write(b, pat.substr(0, i));
+            write(b, pat.substr(i));
+            BOOST_TEST_EQ(test_to_string(
+                b.data()), pat);
+            test_buffer_sequence(b.data());
+        }
+    }
+
+    void
+    testPmr()
+    {
+#ifdef BOOST_BUFFERS_HAS_PMR
+        auto const& pat = test_pattern();
+        std::pmr::unsynchronized_pool_resource mr0;
+        std::pmr::unsynchronized_pool_resource mr1;
+        pmr::multi_buffer b0(&mr0);
+        write(b0, pat);
+        BOOST_TEST(b0.get_allocator().resource() == &mr0);
+
+        // the resource does not propagate
+        pmr::multi_buffer b1(&mr1);
+        b1 = b0;
+        BOOST_TEST_EQ(test_to_string(b1.data()), pat);
+        BOOST_TEST(b1.get_allocator().resource() == &mr1);
+        b1 = std::move(b0);
+        BOOST_TEST_EQ(test_to_string(b1.data()), pat);
+        BOOST_TEST(b1.get_allocator().resource() == &mr1);
+#endif
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testSplice();
+        testBuffer();
+        testPmr();
+    }
+};
+
+TEST_SUITE(
+    multi_buffer_test,
+    "boost.buffers.multi_buffer");
+
+} // buffers
+} // boost
@@ -0,0 +1,285 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/persistent_ring.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/algorithm.hpp>
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/buffer_size.hpp>
+#include <boost/system/system_error.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include "test_helpers.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+struct persistent_ring_test
+{
+    static
+    void
+    write(
+        persistent_ring& r,
+        std::string const& s)
+    {
+        r.commit(buffer_copy(
+            r.prepare(s.size()),
+            const_buffer(s.data(), s.size())));
+    }
+
+    // a record is its length, its
+    // number, then a fill byte
+    static
+    std::string
+    record(std::uint32_t i)
+    {
+        std::uint32_t const len = 8 + i % 53;
+        std::string s(len, static_cast<char>(i));
+        std::memcpy(&s[0], &len, 4);
+        std::memcpy(&s[4], &i, 4);
+        return s;
+    }
+
+    void
+    testMembers()
+    {
+        test_temp_file tp;
+        auto const path = tp.path.c_str();
+        BOOST_TEST_THROWS(
+            persistent_ring(path, 0),
+            std::invalid_argument);
+        BOOST_TEST_THROWS(
+            persistent_ring("/nonexistent/dir/file", 10),
+            system::system_error);
+
+        // a new ring
+        {
+            persistent_ring r(path, 10);
+            BOOST_TEST_EQ(r.size(), 0);
+            BOOST_TEST_EQ(r.max_size(), 10);
+            BOOST_TEST_EQ(r.capacity(), 10);
+            BOOST_TEST_EQ(r.sequence(), 1);
+            BOOST_TEST_THROWS(
+                r.prepare(11),
+                std::length_error);
+            write(r, "0123456");
+            BOOST_TEST_EQ(r.sequence(), 2);
+            r.consume(5);
+            BOOST_TEST_EQ(r.sequence(), 3);
+
+            // wraps
+            auto mb = r.prepare(8);
+            BOOST_TEST_EQ(buffer_size(mb), 8);
+            BOOST_TEST_EQ(mb[0].size(), 3);
+            buffer_copy(mb,
+                const_buffer("abcdefgh", 8));
+            r.commit(100);
+            BOOST_TEST_EQ(test_to_string(
+                r.data()), "56abcdefgh");
+            BOOST_TEST_EQ(r.capacity(), 0);
+            r.sync();
+
+            // uncommitted bytes are not kept
+            r.consume(4);
+            r.prepare(4);
+            r.commit(0);
+        }
+
+        // reopened
+        {
+            persistent_ring r(path, 10);
+            BOOST_TEST_EQ(r.sequence(), 5);
+            BOOST_TEST_EQ(test_to_string(
+                r.data()), "cdefgh");
+            r.consume(100);
+            BOOST_TEST_EQ(r.size(), 0);
+            write(r, "xyz");
+        }
+        {
+            persistent_ring r(path, 10);
+            BOOST_TEST_EQ(test_to_string(
+                r.data()), "xyz");
+            r.sync();
+        }
+
+        // another capacity
+        BOOST_TEST_THROWS(
+            persistent_ring(path, 11),
+            std::invalid_argument);
+    }
+
+    void
+    testRecovery()
+    {
+        test_temp_file tp;
+        auto const path = tp.path.c_str();
+        {
+            persistent_ring r(path, 100);
+            write(r, "hello");
+            write(r, ", world");
+        }
+
+        // tear the newest slot, which for
+        // sequence 3 is the second
+        {
+            auto const fd = ::open(path, O_RDWR);
+            BOOST_TEST_NE(fd, -1);
+            std::uint64_t const v = 1;
+            BOOST_TEST_EQ(::pwrite(fd, &v, sizeof(v),
+                16 + 32 + 8), 8);
+            ::close(fd);
+        }
+        {
+            persistent_ring r(path, 100);
+            BOOST_TEST_EQ(r.sequence(), 2);
+            BOOST_TEST_EQ(test_to_string(
+                r.data()), "hello");
+        }
+
+        // tear both
+        {
+            auto const fd = ::open(path, O_RDWR);
+            BOOST_TEST_NE(fd, -1);
+            std::uint64_t const v = 1;
+            BOOST_TEST_EQ(::pwrite(fd, &v, sizeof(v),
+                16 + 8), 8);
+            ::close(fd);
+        }
+        BOOST_TEST_THROWS(
+            persistent_ring(path, 100),
+            std::invalid_argument);
+
+        // not a ring
+        {
+            auto const fd = ::open(path, O_RDWR);
+            BOOST_TEST_NE(fd, -1);
+            std::uint64_t const v = 1;
+            BOOST_TEST_EQ(::pwrite(fd, &v, sizeof(v), 0), 8);
+            ::close(fd);
+        }
+        BOOST_TEST_THROWS(
+            persistent_ring(path, 100),
+            std::invalid_argument);
+    }
+
+    // kill a writer at an arbitrary point,
+    // then check that the ring holds whole
+    // records which follow one another
+    void
+    testKill()
+    {
+        test_temp_file tp;
+        auto const path = tp.path.c_str();
+        std::size_t const cap = 4096;
+        {
+            persistent_ring r(path, cap);
+        }
+
+        int fds[2];
+        BOOST_TEST_EQ(::pipe(fds), 0);
+        pid_t pid = ::fork();
+        if(pid == 0)
+        {
+            ::close(fds[0]);
+            persistent_ring r(path, cap);
+            std::deque<std::size_t> sizes;
+            for(std::uint32_t i = 1;; ++i)
+            {
+                auto const s = record(i);
+                while(r.capacity() < s.size())
+                {
+                    r.consume(sizes.front());
+                    sizes.pop_front();
+                }
+
+                // the bytes of a record land in
+                // two copies, so a kill may come
+                // with a record half written
+                auto const mb = r.prepare(s.size());
+                auto const n = buffer_copy(mb,
+                    const_buffer(s.data(), s.size() / 2));
+                buffer_copy(sans_prefix(mb, n), const_buffer(
+                    s.data() + n, s.size() - n));
+                r.commit(s.size());
+                sizes.push_back(s.size());
+                if(i % 64 == 0)
+                    r.sync();
+                if(i == 10000)
+                {
+                    char c = 0;
+                    if(::write(fds[1], &c, 1) != 1)
+                        ::_exit(1);
+                }
+            }
+        }
+        ::close(fds[1]);
+        char c;
+        BOOST_TEST_EQ(::read(fds[0], &c, 1), 1);
+        ::close(fds[0]);
+        ::usleep(1000);
+        ::kill(pid, SIGKILL);
+        int st = 0;
+        while(::waitpid(pid, &st, 0) == -1 &&
+            errno == EINTR)
+        {
+        }
+        BOOST_TEST(WIFSIGNALED(st));
+
+        persistent_ring r(path, cap);
+        BOOST_TEST_GT(r.size(), 0);
+        std::string s(r.size(), 0);
+        buffer_copy(mutable_buffer(
+            &s[0], s.size()), r.data());
+        std::size_t pos = 0;
+        std::uint32_t prev = 0;
+        while(pos + 8 <= s.size())
+        {
+            std::uint32_t len;
+            std::uint32_t i;
+            std::memcpy(&len, &s[pos], 4);
+            std::memcpy(&i, &s[pos + 4], 4);
+            if(s.compare(pos, len, record(i)) != 0)
+                break;
+            if(prev != 0)
+                BOOST_TEST_EQ(i, prev + 1);
+            prev = i;
+            pos += len;
+        }
+        BOOST_TEST_EQ(pos, s.size());
+        BOOST_TEST_GE(prev, 10000);
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testRecovery();
+        testKill();
+    }
+};
+
+TEST_SUITE(
+    persistent_ring_test,
+    "boost.buffers.persistent_ring");
+
+} // buffers
+} // boost
+
+#endif
@@ -0,0 +1,179 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/pinned_pool.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/circular_buffer.hpp>
+#include <boost/buffers/flat_buffer.hpp>
+#include <cstdint>
+#include <cstring>
+#include "test_helpers.hpp"
+
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+struct pinned_pool_test
+{
+    static
+    std::size_t
+    page_size() noexcept
+    {
+        return static_cast<std::size_t>(
+            ::sysconf(_SC_PAGESIZE));
+    }
+
+    void
+    testPool()
+    {
+        auto const ps = page_size();
+
+        // pinned_pool()
+        {
+            pinned_pool p;
+            BOOST_TEST_EQ(p.block_size(), 64 * 1024);
+            BOOST_TEST_EQ(p.capacity(), 16);
+            BOOST_TEST_EQ(p.available(), 16);
+            BOOST_TEST(! p.locked());
+            auto const st = p.stats();
+            BOOST_TEST_EQ(st.blocks_free, 16);
+            BOOST_TEST_EQ(st.blocks_in_use, 0);
+            BOOST_TEST_EQ(st.bytes_mapped, 16 * 64 * 1024);
+
+            // warm-up faulted the pages in
+            BOOST_TEST_GE(st.after_warmup.minor,
+                st.before_warmup.minor);
+        }
+
+        // pinned_pool(options)
+        {
+            pinned_pool::options opt;
+            opt.block_size = 0;
+            BOOST_TEST_THROWS(
+                pinned_pool{opt},
+                std::invalid_argument);
+            opt.block_size = 100;
+            opt.blocks = 0;
+            BOOST_TEST_THROWS(
+                pinned_pool{opt},
+                std::invalid_argument);
+            opt.blocks = std::size_t(-1) / 2;
+            BOOST_TEST_THROWS(
+                pinned_pool{opt},
+                std::bad_alloc);
+
+            // rounded up to a page
+            opt.blocks = 3;
+            pinned_pool p(opt);
+            BOOST_TEST_EQ(p.block_size(), ps);
+        }
+
+        // allocate, deallocate
+        {
+            pinned_pool::options opt;
+            opt.block_size = 2 * ps;
+            opt.blocks = 3;
+            pinned_pool p(opt);
+            auto const b0 = p.allocate();
+            auto const b1 = p.allocate();
+            auto const b2 = p.allocate();
+            BOOST_TEST_EQ(b0.size(), 2 * ps);
+            BOOST_TEST_EQ(reinterpret_cast<
+                std::uintptr_t>(b0.data()) % ps, 0);
+            BOOST_TEST_EQ(static_cast<unsigned char*>(
+                b1.data()) - static_cast<unsigned char*>(
+                    b0.data()), 2 * ps);
+            BOOST_TEST_EQ(p.available(), 0);
+            BOOST_TEST_EQ(p.stats().blocks_in_use, 3);
+            BOOST_TEST_THROWS(p.allocate(), std::bad_alloc);
+
+            // first touch takes no fault
+            auto const f0 = pinned_pool::page_faults();
+            std::memset(b0.data(), '*', b0.size());
+            std::memset(b1.data(), '*', b1.size());
+            std::memset(b2.data(), '*', b2.size());
+            auto const f1 = pinned_pool::page_faults();
+            BOOST_TEST_EQ(f1.minor - f0.minor, 0);
+            BOOST_TEST_EQ(f1.major - f0.major, 0);
+
+            p.deallocate(b1.data());
+            BOOST_TEST_EQ(p.available(), 1);
+            BOOST_TEST_EQ(p.allocate().data(), b1.data());
+            p.deallocate(b0.data());
+            p.deallocate(b1.data());
+            p.deallocate(b2.data());
+            BOOST_TEST_EQ(p.stats().blocks_free, 3);
+        }
+
+        // lock
+        {
+            pinned_pool::options opt;
+            opt.block_size = ps;
+            opt.blocks = 1;
+            opt.lock = true;
+            pinned_pool p(opt);
+
+            // may fail for lack of privilege
+            BOOST_TEST_EQ(p.stats().locked, p.locked());
+        }
+    }
+
+    void
+    testBuffers()
+    {
+        auto const& pat = test_pattern();
+        pinned_pool::options opt;
+        opt.block_size = 1;
+        opt.blocks = 2;
+        pinned_pool p(opt);
+
+        {
+            auto const b = p.allocate();
+            flat_buffer fb(b);
+            BOOST_TEST_EQ(fb.capacity(), b.size());
+            fb.commit(buffer_copy(
+                fb.prepare(pat.size()),
+                const_buffer(pat.data(), pat.size())));
+            BOOST_TEST_EQ(test_to_string(fb.data()), pat);
+            p.deallocate(b.data());
+        }
+
+        {
+            auto const b = p.allocate();
+            circular_buffer cb(b.data(), b.size());
+            BOOST_TEST_EQ(cb.capacity(), b.size());
+            cb.commit(buffer_copy(
+                cb.prepare(pat.size()),
+                const_buffer(pat.data(), pat.size())));
+            BOOST_TEST_EQ(test_to_string(cb.data()), pat);
+            p.deallocate(b.data());
+        }
+    }
+
+    void
+    run()
+    {
+        testPool();
+        testBuffers();
+    }
+};
+
+TEST_SUITE(
+    pinned_pool_test,
+    "boost.buffers.pinned_pool");
+
+} // buffers
+} // boost
+
+#endif
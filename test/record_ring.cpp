@@ -0,0 +1,218 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/record_ring.hpp>
+
+#include <boost/buffers/const_buffer_span.hpp>
+#include <deque>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+struct record_ring_test
+{
+    void
+    testMembers()
+    {
+        // record_ring()
+        {
+            record_ring rr;
+            BOOST_TEST(rr.empty());
+            BOOST_TEST_EQ(rr.size(), 0);
+            BOOST_TEST_EQ(rr.bytes(), 0);
+            BOOST_TEST_EQ(rr.available(), 0);
+            BOOST_TEST(! rr.fits(0));
+            BOOST_TEST_THROWS(
+                rr.push(const_buffer()),
+                std::length_error);
+        }
+
+        // record_ring(void*, std::size_t)
+        {
+            char buf[32];
+            record_ring rr(buf, sizeof(buf));
+            BOOST_TEST(rr.empty());
+            BOOST_TEST_EQ(rr.max_size(), 32);
+            BOOST_TEST_EQ(rr.available(),
+                32 - record_ring::header_size);
+            BOOST_TEST(rr.fits(28));
+            BOOST_TEST(! rr.fits(29));
+        }
+
+        // push, front, pop
+        {
+            char buf[32];
+            record_ring rr(buf, sizeof(buf));
+            rr.push(make_buffer("abc", 3));
+            rr.push(const_buffer());
+            const_buffer const bs[2] = {
+                { "de", 2 }, { "fgh", 3 } };
+            rr.push(const_buffer_span(bs, 2));
+            BOOST_TEST_EQ(rr.size(), 3);
+            BOOST_TEST_EQ(rr.bytes(),
+                3 * record_ring::header_size + 8);
+            BOOST_TEST_EQ(
+                test_to_string(rr.front()), "abc");
+            rr.pop();
+            BOOST_TEST_EQ(
+                test_to_string(rr.front()), "");
+            rr.pop();
+            BOOST_TEST_EQ(
+                test_to_string(rr.front()), "defgh");
+            rr.pop(5);
+            BOOST_TEST(rr.empty());
+            BOOST_TEST_EQ(rr.bytes(), 0);
+        }
+
+        // push too large
+        {
+            char buf[16];
+            record_ring rr(buf, sizeof(buf));
+            BOOST_TEST_THROWS(
+                rr.push(make_buffer(
+                    "0123456789abc", 13)),
+                std::length_error);
+            rr.push(make_buffer(
+                "0123456789ab", 12));
+            BOOST_TEST_EQ(rr.available(), 0);
+            BOOST_TEST(! rr.fits(0));
+            BOOST_TEST_THROWS(
+                rr.push(const_buffer()),
+                std::length_error);
+        }
+    }
+
+    void
+    testWrap()
+    {
+        auto const& pat = test_pattern();
+        std::string const junk(24, 'x');
+
+        // keep the ring non-empty so every
+        // offset is visited and headers and
+        // payloads straddle the end
+        {
+            char buf[24];
+            record_ring rr(buf, sizeof(buf));
+            std::deque<std::string> q;
+            for(std::size_t i = 0; i < 200; ++i)
+            {
+                auto const s =
+                    pat.substr(i % 5, i % 9);
+                while(! rr.fits(s.size()))
+                {
+                    BOOST_TEST_EQ(test_to_string(
+                        rr.front()), q.front());
+                    rr.pop();
+                    q.pop_front();
+                }
+                rr.push(make_buffer(
+                    s.data(), s.size()));
+                q.push_back(s);
+                BOOST_TEST_EQ(rr.size(), q.size());
+            }
+            while(! rr.empty())
+            {
+                BOOST_TEST_EQ(test_to_string(
+                    rr.front()), q.front());
+                rr.pop();
+                q.pop_front();
+            }
+        }
+
+        // front meets the sequence requirements
+        {
+            char buf[24];
+            record_ring rr(buf, sizeof(buf));
+            rr.push(make_buffer(junk.data(), 10));
+            rr.push(make_buffer(junk.data(), 1));
+            rr.pop();
+            rr.push(make_buffer(
+                pat.data(), pat.size()));
+            rr.pop();
+            BOOST_TEST_NE(
+                rr.front()[1].size(), 0);
+            test_buffer_sequence(rr.front());
+        }
+    }
+
+    void
+    testGather()
+    {
+        auto const& pat = test_pattern();
+        std::string const junk(20, 'x');
+        char buf[40];
+        record_ring rr(buf, sizeof(buf));
+        rr.push(make_buffer(
+            junk.data(), junk.size()));
+        rr.push(make_buffer(pat.data(), 3));
+        rr.pop();
+
+        // the second record wraps
+        rr.push(make_buffer(pat.data() + 3, 12));
+        rr.push(const_buffer());
+        rr.push(make_buffer("x", 1));
+
+        const_buffer dest[8];
+        {
+            auto const g = rr.gather(dest, 8);
+            BOOST_TEST_EQ(g.records, 4);
+            BOOST_TEST_EQ(g.buffers, 4);
+            BOOST_TEST_EQ(g.bytes, 16);
+            BOOST_TEST_EQ(test_to_string(
+                const_buffer_span(dest, g.buffers)),
+                pat + "x");
+        }
+        {
+            auto const g = rr.gather(dest, 8, 2);
+            BOOST_TEST_EQ(g.records, 2);
+            BOOST_TEST_EQ(g.buffers, 3);
+            BOOST_TEST_EQ(test_to_string(
+                const_buffer_span(dest, g.buffers)),
+                pat);
+        }
+        {
+            // only whole records
+            auto const g = rr.gather(dest, 2);
+            BOOST_TEST_EQ(g.records, 1);
+            BOOST_TEST_EQ(g.buffers, 1);
+            BOOST_TEST_EQ(g.bytes, 3);
+        }
+        {
+            auto const g = rr.gather(dest, 0);
+            BOOST_TEST_EQ(g.records, 0);
+        }
+        rr.pop(2);
+        {
+            auto const g = rr.gather(dest, 8);
+            BOOST_TEST_EQ(g.records, 2);
+            BOOST_TEST_EQ(g.buffers, 1);
+            BOOST_TEST_EQ(test_to_string(
+                const_buffer_span(dest, g.buffers)),
+                "x");
+        }
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testWrap();
+        testGather();
+    }
+};
+
+TEST_SUITE(
+    record_ring_test,
+    "boost.buffers.record_ring");
+
+} // buffers
+} // boost
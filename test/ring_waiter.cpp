@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/ring_waiter.hpp>
+
+#include <thread>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+struct ring_waiter_test
+{
+    void
+    testReady()
+    {
+        // predicate already satisfied
+        ring_waiter w;
+        std::size_t calls = 0;
+        w.wait([&]
+            {
+                ++calls;
+                return true;
+            });
+        BOOST_TEST_EQ(calls, 1);
+        BOOST_TEST_EQ(w.parked(), 0);
+
+        // notify without waiters
+        w.notify();
+        w.notify(false);
+        BOOST_TEST_EQ(w.parked(), 0);
+    }
+
+    void
+    testPark()
+    {
+        // no spinning or yielding,
+        // so the waiter always parks
+        wait_options opt;
+        opt.spin_time =
+            std::chrono::nanoseconds(0);
+        opt.yield_count = 0;
+
+        ring_waiter w;
+        std::atomic<bool> ready{false};
+        std::thread t([&]
+            {
+                w.wait([&]
+                    {
+                        return ready.load(
+                            std::memory_order_acquire);
+                    }, opt);
+            });
+        while(w.parked() == 0)
+            std::this_thread::yield();
+        ready.store(true,
+            std::memory_order_release);
+        w.notify();
+        t.join();
+        BOOST_TEST_EQ(w.parked(), 0);
+    }
+
+    void
+    testTimeout()
+    {
+        wait_options opt;
+        opt.spin_time =
+            std::chrono::nanoseconds(0);
+        opt.yield_count = 0;
+        opt.park_timeout =
+            std::chrono::milliseconds(5);
+
+        ring_waiter w;
+        auto const t0 =
+            std::chrono::steady_clock::now();
+        BOOST_TEST(! w.wait(
+            []{ return false; }, opt));
+        BOOST_TEST(
+            std::chrono::steady_clock::now() - t0 >=
+                opt.park_timeout);
+        BOOST_TEST_EQ(w.parked(), 0);
+        BOOST_TEST(w.wait(
+            []{ return true; }, opt));
+    }
+
+    void
+    testPingPong()
+    {
+        std::size_t const N = 20000;
+        wait_options opt;
+        opt.spin_time =
+            std::chrono::nanoseconds(200);
+        opt.yield_count = 1;
+
+        // two waiters keyed on one index
+        // each, like a ring's head and tail
+        ring_waiter full;
+        ring_waiter empty;
+        std::atomic<std::size_t> head{0};
+        std::atomic<std::size_t> tail{0};
+        std::size_t const cap = 4;
+
+        std::thread producer([&]
+            {
+                for(std::size_t i = 0; i < N; ++i)
+                {
+                    full.wait([&]
+                        {
+                            return head.load(
+                                std::memory_order_relaxed) -
+                                tail.load(
+                                std::memory_order_acquire) < cap;
+                        }, opt);
+                    head.fetch_add(1,
+                        std::memory_order_release);
+                    empty.notify();
+                }
+            });
+
+        std::size_t got = 0;
+        while(got < N)
+        {
+            empty.wait([&]
+                {
+                    return head.load(
+                        std::memory_order_acquire) !=
+                        tail.load(
+                        std::memory_order_relaxed);
+                }, opt);
+            tail.fetch_add(1,
+                std::memory_order_release);
+            full.notify();
+            ++got;
+        }
+        producer.join();
+        BOOST_TEST_EQ(head.load(), N);
+        BOOST_TEST_EQ(tail.load(), N);
+    }
+
+    void
+    run()
+    {
+        testReady();
+        testPark();
+        testTimeout();
+        testPingPong();
+    }
+};
+
+TEST_SUITE(
+    ring_waiter_test,
+    "boost.buffers.ring_waiter");
+
+} // buffers
+} // boost
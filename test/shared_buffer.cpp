@@ -0,0 +1,417 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/shared_buffer.hpp>
+
+#include <boost/buffers/algorithm.hpp>
+#include <boost/buffers/const_buffer_pair.hpp>
+#include <boost/static_assert.hpp>
+#include <thread>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_const_buffer_sequence<shared_buffer>::value);
+
+BOOST_STATIC_ASSERT(
+    is_const_buffer_sequence<shared_buffers>::value);
+
+BOOST_STATIC_ASSERT(
+    is_const_buffer_sequence<local_shared_buffers>::value);
+
+BOOST_STATIC_ASSERT(
+    ! is_mutable_buffer_sequence<shared_buffers>::value);
+
+BOOST_STATIC_ASSERT(
+    std::is_same<prefix_type<shared_buffers>,
+        shared_buffers>::value);
+
+BOOST_STATIC_ASSERT(
+    std::is_same<suffix_type<shared_buffer>,
+        shared_buffer>::value);
+
+struct shared_buffer_test
+{
+    static
+    const_buffer
+    cb(std::string const& s)
+    {
+        return { s.data(), s.size() };
+    }
+
+    template<bool ThreadSafe>
+    void
+    testBlock()
+    {
+        using block_type =
+            basic_shared_block<ThreadSafe>;
+        auto const& pat = test_pattern();
+
+        // basic_shared_block()
+        {
+            block_type b;
+            BOOST_TEST_EQ(b.size(), 0);
+            BOOST_TEST_EQ(b.data(), nullptr);
+            BOOST_TEST_EQ(b.use_count(), 0);
+            block_type b1(b);
+            BOOST_TEST_EQ(b1.use_count(), 0);
+        }
+
+        // basic_shared_block(ConstBufferSequence)
+        {
+            std::string s = pat;
+            block_type b(cb(s));
+            s.assign(s.size(), '-');
+            BOOST_TEST_EQ(b.size(), pat.size());
+            BOOST_TEST_EQ(b.use_count(), 1);
+            BOOST_TEST_EQ(test_to_string(
+                b.buffer()), pat);
+
+            // copied from every buffer
+            std::string const s0 = pat.substr(0, 4);
+            std::string const s1 = pat.substr(4);
+            block_type b1(const_buffer_pair(
+                cb(s0), cb(s1)));
+            BOOST_TEST_EQ(test_to_string(
+                b1.buffer()), pat);
+
+            block_type b2((const_buffer()));
+            BOOST_TEST_EQ(b2.use_count(), 0);
+        }
+
+        // copy, move
+        {
+            block_type b0(cb(pat));
+            auto const p = b0.data();
+            {
+                block_type b1(b0);
+                BOOST_TEST_EQ(b1.data(), p);
+                BOOST_TEST_EQ(b0.use_count(), 2);
+                block_type b2(std::move(b1));
+                BOOST_TEST_EQ(b1.use_count(), 0);
+                BOOST_TEST_EQ(b2.use_count(), 2);
+                b1 = b2;
+                BOOST_TEST_EQ(b0.use_count(), 3);
+                b1 = std::move(b2);
+                BOOST_TEST_EQ(b0.use_count(), 2);
+                b1 = b1;
+                BOOST_TEST_EQ(b0.use_count(), 2);
+                b1 = block_type();
+                BOOST_TEST_EQ(b0.use_count(), 1);
+            }
+            BOOST_TEST_EQ(b0.use_count(), 1);
+            BOOST_TEST_EQ(test_to_string(
+                b0.buffer()), pat);
+        }
+    }
+
+    void
+    testBuffer()
+    {
+        auto const& pat = test_pattern();
+
+        shared_buffer b0;
+        BOOST_TEST_EQ(b0.size(), 0);
+        BOOST_TEST_EQ(buffer_size(b0), 0);
+
+        // outlives the block it was made from
+        shared_buffer b1;
+        {
+            shared_block blk(cb(pat));
+            b1 = shared_buffer(blk, 2, 5);
+            BOOST_TEST_EQ(blk.use_count(), 2);
+        }
+        BOOST_TEST_EQ(b1.block().use_count(), 1);
+        BOOST_TEST_EQ(b1.size(), 5);
+        BOOST_TEST_EQ(test_to_string(b1),
+            pat.substr(2, 5));
+        const_buffer b = b1;
+        BOOST_TEST_EQ(b.data(), b1.data());
+
+        BOOST_TEST_THROWS(
+            shared_buffer(b1.block(), 16, 0),
+            std::invalid_argument);
+        BOOST_TEST_THROWS(
+            shared_buffer(b1.block(), 10, 6),
+            std::invalid_argument);
+
+        // prefix, suffix
+        shared_buffer b2(shared_block(cb(pat)));
+        BOOST_TEST_EQ(test_to_string(
+            prefix(b2, 4)), pat.substr(0, 4));
+        BOOST_TEST_EQ(test_to_string(
+            suffix(b2, 4)), pat.substr(11));
+        BOOST_TEST_EQ(test_to_string(
+            sans_prefix(b2, 4)), pat.substr(4));
+        BOOST_TEST_EQ(prefix(b2, 4).block().data(),
+            b2.block().data());
+        BOOST_TEST_EQ(test_to_string(
+            b2 + 3), pat.substr(3));
+        b2 += 100;
+        BOOST_TEST_EQ(b2.size(), 0);
+
+        test_buffer_sequence(
+            shared_buffer(shared_block(cb(pat))));
+    }
+
+    void
+    testAllocator()
+    {
+        auto const& pat = test_pattern();
+        std::size_t bytes = 0;
+
+        // basic_shared_block(
+        //  ConstBufferSequence, Allocator)
+        {
+            shared_block b(cb(pat),
+                test_allocator<char>(&bytes));
+            BOOST_TEST_GT(bytes, pat.size());
+            BOOST_TEST_EQ(test_to_string(
+                b.buffer()), pat);
+            shared_block b1(b);
+            BOOST_TEST_EQ(b1.use_count(), 2);
+            b = shared_block();
+            BOOST_TEST_GT(bytes, 0);
+
+            local_shared_block b2((const_buffer()),
+                test_allocator<char>(&bytes));
+            BOOST_TEST_EQ(b2.use_count(), 0);
+        }
+        BOOST_TEST_EQ(bytes, 0);
+
+        // basic_shared_buffers(Allocator)
+        {
+            using buffers_type = basic_shared_buffers<
+                true, test_allocator<unsigned char>>;
+            buffers_type bs(
+                (test_allocator<unsigned char>(&bytes)));
+            bs.push_back(shared_buffer(
+                shared_block(cb(pat))));
+            BOOST_TEST_GT(bytes, 0);
+            BOOST_TEST_EQ(test_to_string(bs), pat);
+            auto const bs1 = prefix(bs, 4);
+            BOOST_TEST(bs1.get_allocator() ==
+                bs.get_allocator());
+            buffers_type bs2({ bs[0] },
+                test_allocator<unsigned char>(&bytes));
+            BOOST_TEST_EQ(test_to_string(bs2), pat);
+        }
+        BOOST_TEST_EQ(bytes, 0);
+
+#ifdef BOOST_BUFFERS_HAS_PMR
+        {
+            std::pmr::unsynchronized_pool_resource mr;
+            pmr::shared_buffers bs(&mr);
+            bs.push_back(shared_buffer(shared_block(cb(pat),
+                std::pmr::polymorphic_allocator<char>(&mr))));
+            BOOST_TEST_EQ(test_to_string(bs), pat);
+        }
+#endif
+    }
+
+    template<bool ThreadSafe>
+    void
+    testBuffers()
+    {
+        using block_type =
+            basic_shared_block<ThreadSafe>;
+        using buffers_type =
+            basic_shared_buffers<ThreadSafe>;
+        using buffer_type =
+            typename buffers_type::buffer_type;
+        auto const& pat = test_pattern();
+
+        block_type const blk(cb(pat));
+        auto const make =
+            [&](std::size_t i, std::size_t j)
+            {
+                buffers_type bs;
+                bs.push_back(buffer_type(blk, 0, i));
+                bs.push_back(buffer_type(blk, i, j - i));
+                bs.push_back(buffer_type(
+                    blk, j, pat.size() - j));
+                return bs;
+            };
+
+        // push_back, operator[]
+        {
+            buffers_type bs;
+            BOOST_TEST(bs.empty());
+            BOOST_TEST_EQ(buffer_size(bs), 0);
+            bs = make(3, 3);
+            BOOST_TEST_EQ(bs.length(), 2);
+            BOOST_TEST_EQ(blk.use_count(), 3);
+            BOOST_TEST_EQ(test_to_string(bs), pat);
+            BOOST_TEST_EQ(test_to_string(
+                bs[1]), pat.substr(3));
+            BOOST_TEST_EQ(bs[1].data(),
+                bs.begin()[1].data());
+        }
+        BOOST_TEST_EQ(blk.use_count(), 1);
+
+        // many push_back, in linear time
+        {
+            buffers_type bs;
+            for(std::size_t i = 0; i < 100000; ++i)
+                bs.push_back(buffer_type(blk, 0, 1));
+            BOOST_TEST_EQ(bs.length(), 100000);
+            BOOST_TEST_EQ(buffer_size(bs), 100000);
+            BOOST_TEST_EQ(blk.use_count(), 100001);
+            buffers_type bs2;
+            for(std::size_t i = 0; i < 1000; ++i)
+                bs2.append(make(3, 7));
+            BOOST_TEST_EQ(bs2.length(), 3000);
+        }
+        BOOST_TEST_EQ(blk.use_count(), 1);
+
+        // initializer list, append
+        {
+            block_type const blk1(cb(std::string("xyz")));
+            buffers_type bs{
+                buffer_type(blk), buffer_type(blk1) };
+            bs.append(bs);
+            BOOST_TEST_EQ(bs.length(), 4);
+            BOOST_TEST_EQ(test_to_string(bs),
+                pat + "xyz" + pat + "xyz");
+            bs.clear();
+            BOOST_TEST(bs.empty());
+            BOOST_TEST_EQ(blk1.use_count(), 1);
+        }
+
+        // append to itself, reallocating
+        {
+            block_type const blk1(cb(std::string("xyz")));
+            buffers_type bs;
+            bs.push_back(buffer_type(blk1));
+            std::string s = "xyz";
+            for(std::size_t i = 0; i < 10; ++i)
+            {
+                bs.append(bs);
+                s += s;
+            }
+            BOOST_TEST_EQ(bs.length(), 1024);
+            BOOST_TEST_EQ(blk1.use_count(), 1025);
+            BOOST_TEST_EQ(test_to_string(bs), s);
+        }
+
+        // consume
+        {
+            auto bs = make(4, 9);
+            bs.consume(2);
+            BOOST_TEST_EQ(bs.length(), 3);
+            BOOST_TEST_EQ(test_to_string(bs),
+                pat.substr(2));
+            bs.consume(2);
+            BOOST_TEST_EQ(bs.length(), 2);
+            BOOST_TEST_EQ(blk.use_count(), 3);
+            bs.consume(8);
+            BOOST_TEST_EQ(bs.length(), 1);
+            BOOST_TEST_EQ(test_to_string(bs),
+                pat.substr(12));
+            bs.consume(100);
+            BOOST_TEST(bs.empty());
+        }
+
+        // prefix, suffix
+        for(std::size_t i = 0; i <= pat.size(); ++i)
+        for(std::size_t j = i; j <= pat.size(); ++j)
+        {
+            auto const bs = make(i, j);
+            test_buffer_sequence(bs);
+            for(std::size_t n = 0;
+                n <= pat.size() + 1; ++n)
+            {
+                auto const m =
+                    n < pat.size() ? n : pat.size();
+                buffers_type p = prefix(bs, n);
+                buffers_type s = suffix(bs, n);
+                BOOST_TEST_EQ(test_to_string(p),
+                    pat.substr(0, m));
+                BOOST_TEST_EQ(test_to_string(s),
+                    pat.substr(pat.size() - m));
+                BOOST_TEST_EQ(test_to_string(
+                    sans_prefix(bs, n)),
+                    pat.substr(m));
+                BOOST_TEST_EQ(test_to_string(
+                    sans_suffix(bs, n)),
+                    pat.substr(0, pat.size() - m));
+            }
+        }
+
+        // retained after the original is gone
+        {
+            buffers_type p;
+            {
+                block_type b(cb(pat));
+                buffers_type bs;
+                bs.push_back(buffer_type(b));
+                p = prefix(bs, 5);
+            }
+            BOOST_TEST_EQ(test_to_string(p),
+                pat.substr(0, 5));
+        }
+
+        // buffer_copy
+        {
+            auto const bs = make(5, 10);
+            std::string s(pat.size(), ' ');
+            BOOST_TEST_EQ(buffer_copy(
+                mutable_buffer(&s[0], s.size()),
+                bs), pat.size());
+            BOOST_TEST_EQ(s, pat);
+        }
+    }
+
+    void
+    testThreads()
+    {
+        // fan out to many holders
+        auto const& pat = test_pattern();
+        shared_buffer const b(shared_block(cb(pat)));
+        std::thread t[4];
+        for(auto& e : t)
+            e = std::thread([&b, &pat]
+                {
+                    for(std::size_t i = 0; i < 10000; ++i)
+                    {
+                        shared_buffers bs;
+                        bs.push_back(b);
+                        bs.push_back(b);
+                        auto const p = prefix(bs, 20);
+                        BOOST_TEST_EQ(buffer_size(p), 20);
+                    }
+                    BOOST_TEST_EQ(test_to_string(b), pat);
+                });
+        for(auto& e : t)
+            e.join();
+        BOOST_TEST_EQ(b.block().use_count(), 1);
+    }
+
+    void
+    run()
+    {
+        testBlock<true>();
+        testBlock<false>();
+        testBuffer();
+        testBuffers<true>();
+        testBuffers<false>();
+        testAllocator();
+        testThreads();
+    }
+};
+
+TEST_SUITE(
+    shared_buffer_test,
+    "boost.buffers.shared_buffer");
+
+} // buffers
+} // boost
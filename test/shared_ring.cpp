@@ -0,0 +1,368 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/shared_ring.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/type_traits.hpp>
+#include <boost/system/system_error.hpp>
+#include <boost/static_assert.hpp>
+#include <cerrno>
+#include <thread>
+#include "test_helpers.hpp"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<shared_ring>::value);
+
+struct shared_ring_test
+{
+    // a child process, which reports
+    // failure through its exit status
+    template<class F>
+    static
+    pid_t
+    spawn(F const& f)
+    {
+        pid_t pid = ::fork();
+        if(pid == 0)
+        {
+            int rv = 1;
+            try
+            {
+                rv = f() ? 0 : 1;
+            }
+            catch(...)
+            {
+            }
+            ::_exit(rv);
+        }
+        return pid;
+    }
+
+    static
+    int
+    join(pid_t pid)
+    {
+        int st = 0;
+        while(::waitpid(pid, &st, 0) == -1 &&
+            errno == EINTR)
+        {
+        }
+        if(! WIFEXITED(st))
+            return -1;
+        return WEXITSTATUS(st);
+    }
+
+    void
+    testMembers()
+    {
+        BOOST_TEST_THROWS(
+            shared_ring::create(0),
+            std::invalid_argument);
+
+        BOOST_TEST_GT(
+            shared_ring::segment_size(100), 100);
+
+        // shared_ring()
+        {
+            shared_ring r;
+            BOOST_TEST_EQ(r.size(), 0);
+            BOOST_TEST_EQ(r.max_size(), 0);
+            BOOST_TEST_EQ(r.capacity(), 0);
+        }
+
+        // both roles in one process
+        {
+            int fd = shared_ring::create(10);
+            {
+                shared_ring w(fd, shared_ring::producer);
+                shared_ring r(fd, shared_ring::consumer);
+                BOOST_TEST(w.peer() ==
+                    shared_ring::peer_state::alive);
+                BOOST_TEST(r.peer() ==
+                    shared_ring::peer_state::alive);
+                BOOST_TEST_THROWS(
+                    shared_ring(fd, shared_ring::producer),
+                    system::system_error);
+                BOOST_TEST_EQ(w.max_size(), 10);
+                BOOST_TEST_EQ(w.capacity(), 10);
+                BOOST_TEST_EQ(r.size(), 0);
+                BOOST_TEST_THROWS(
+                    w.prepare(11),
+                    std::length_error);
+
+                w.commit(buffer_copy(
+                    w.prepare(7),
+                    const_buffer("0123456", 7)));
+                BOOST_TEST_EQ(r.size(), 7);
+                BOOST_TEST_EQ(w.capacity(), 3);
+                BOOST_TEST_EQ(test_to_string(
+                    r.data()), "0123456");
+                r.consume(5);
+                BOOST_TEST_EQ(w.capacity(), 8);
+
+                // wraps
+                auto mb = w.prepare(8);
+                BOOST_TEST_EQ(buffer_size(mb), 8);
+                BOOST_TEST_EQ(mb[0].size(), 3);
+                buffer_copy(mb,
+                    const_buffer("abcdefgh", 8));
+                w.commit(100);
+                BOOST_TEST_EQ(test_to_string(
+                    r.data()), "56abcdefgh");
+                BOOST_TEST_EQ(w.capacity(), 0);
+                BOOST_TEST(w.wait_writable(0));
+                BOOST_TEST(r.wait_readable());
+                r.consume(100);
+                BOOST_TEST_EQ(r.size(), 0);
+
+                // move
+                shared_ring r2(std::move(r));
+                BOOST_TEST_EQ(r.size(), 0);
+                BOOST_TEST(w.peer() ==
+                    shared_ring::peer_state::alive);
+                r = std::move(r2);
+                BOOST_TEST(r.peer() ==
+                    shared_ring::peer_state::alive);
+            }
+
+            // roles were released
+            shared_ring r(fd, shared_ring::consumer);
+            BOOST_TEST(r.peer() ==
+                shared_ring::peer_state::closed);
+            BOOST_TEST(! r.wait_readable());
+            ::close(fd);
+        }
+
+        // buffer sequence
+        {
+            auto const pat = test_pattern();
+            int fd = shared_ring::create(20);
+            shared_ring w(fd, shared_ring::producer);
+            shared_ring r(fd, shared_ring::consumer);
+            w.commit(buffer_copy(
+                w.prepare(8),
+                const_buffer("junk....", 8)));
+            r.consume(8);
+            w.commit(buffer_copy(
+                w.prepare(pat.size()),
+                const_buffer(pat.data(), pat.size())));
+            test_buffer_sequence(r.data());
+            ::close(fd);
+        }
+    }
+
+    void
+    testTimeout()
+    {
+        int fd = shared_ring::create(16);
+        shared_ring w(fd, shared_ring::producer);
+        shared_ring r(fd, shared_ring::consumer);
+        wait_options opt;
+        opt.spin_time =
+            std::chrono::nanoseconds(0);
+        opt.yield_count = 0;
+        opt.park_timeout =
+            std::chrono::milliseconds(5);
+        BOOST_TEST(! r.wait_readable(opt));
+        w.commit(buffer_copy(
+            w.prepare(16),
+            const_buffer("0123456789abcdef", 16)));
+        BOOST_TEST(! w.wait_writable(1, opt));
+        BOOST_TEST(r.wait_readable(opt));
+        BOOST_TEST_THROWS(
+            w.wait_writable(17),
+            std::length_error);
+        ::close(fd);
+    }
+
+    void
+    testTransfer()
+    {
+        // a child produces through a
+        // ring much smaller than the data
+        std::size_t const N = 1 << 20;
+        int fd = shared_ring::create(4096);
+        auto const pid = spawn([fd, N]
+            {
+                shared_ring w(fd, shared_ring::producer);
+                std::size_t i = 0;
+                while(i < N)
+                {
+                    if(! w.wait_writable(1))
+                        return false;
+                    auto n = w.capacity();
+                    if(n > N - i)
+                        n = N - i;
+                    auto const mb = w.prepare(n);
+                    for(auto it = begin(mb);
+                        it != end(mb); ++it)
+                    {
+                        auto p = static_cast<
+                            unsigned char*>(it->data());
+                        for(std::size_t j = 0;
+                            j < it->size(); ++j)
+                            p[j] = static_cast<
+                                unsigned char>(i++ % 251);
+                    }
+                    w.commit(n);
+                }
+                return true;
+            });
+
+        shared_ring r(fd, shared_ring::consumer);
+        std::size_t i = 0;
+        std::size_t bad = 0;
+        while(r.wait_readable())
+        {
+            auto const cb = r.data();
+            for(auto it = begin(cb);
+                it != end(cb); ++it)
+            {
+                auto p = static_cast<
+                    unsigned char const*>(it->data());
+                for(std::size_t j = 0;
+                    j < it->size(); ++j)
+                    if(p[j] != i++ % 251)
+                        ++bad;
+            }
+            r.consume(buffer_size(cb));
+        }
+        BOOST_TEST_EQ(join(pid), 0);
+        BOOST_TEST_EQ(i, N);
+        BOOST_TEST_EQ(bad, 0);
+
+        // the child detached normally
+        BOOST_TEST(r.peer() ==
+            shared_ring::peer_state::closed);
+        ::close(fd);
+    }
+
+    void
+    testLateAttach()
+    {
+        // the consumer attaches first, and
+        // waits across several peer checks
+        int fd = shared_ring::create(64);
+        shared_ring r(fd, shared_ring::consumer);
+        BOOST_TEST(r.peer() ==
+            shared_ring::peer_state::detached);
+        auto const pid = spawn([fd]
+            {
+                ::usleep(200000);
+                shared_ring w(fd, shared_ring::producer);
+                w.commit(buffer_copy(
+                    w.prepare(5),
+                    const_buffer("hello", 5)));
+                return true;
+            });
+        BOOST_TEST(r.wait_readable());
+        BOOST_TEST_EQ(test_to_string(
+            r.data()), "hello");
+        r.consume(5);
+        BOOST_TEST(! r.wait_readable());
+        BOOST_TEST_EQ(join(pid), 0);
+        ::close(fd);
+    }
+
+    void
+    testDeadPeer()
+    {
+        int fd = shared_ring::create(64);
+
+        // the child exits without
+        // destroying its shared_ring
+        int up[2];
+        int down[2];
+        BOOST_TEST_EQ(::pipe(up), 0);
+        BOOST_TEST_EQ(::pipe(down), 0);
+        auto const pid = spawn([fd, &up, &down]
+            {
+                auto w = new shared_ring(
+                    fd, shared_ring::producer);
+                w->commit(buffer_copy(
+                    w->prepare(5),
+                    const_buffer("hello", 5)));
+                char c = 0;
+                // wait for the parent to attempt
+                // a second producer, then die
+                if(::write(up[1], &c, 1) != 1)
+                    return false;
+                return ::read(down[0], &c, 1) == 1;
+            });
+
+        char c;
+        BOOST_TEST_EQ(::read(up[0], &c, 1), 1);
+
+        // the role is held by a living process
+        try
+        {
+            shared_ring w(fd, shared_ring::producer);
+            BOOST_TEST_FAIL();
+        }
+        catch(system::system_error const& e)
+        {
+            BOOST_TEST_EQ(e.code().value(), EBUSY);
+        }
+
+        shared_ring r(fd, shared_ring::consumer);
+        BOOST_TEST(r.peer() ==
+            shared_ring::peer_state::alive);
+        BOOST_TEST_EQ(::write(down[1], &c, 1), 1);
+        BOOST_TEST_EQ(join(pid), 0);
+        ::close(up[0]);
+        ::close(up[1]);
+        ::close(down[0]);
+        ::close(down[1]);
+
+        BOOST_TEST(r.peer() ==
+            shared_ring::peer_state::dead);
+
+        // committed data outlives the producer
+        BOOST_TEST(r.wait_readable());
+        BOOST_TEST_EQ(test_to_string(
+            r.data()), "hello");
+        r.consume(5);
+        BOOST_TEST(! r.wait_readable());
+
+        // the role may be taken over
+        shared_ring w(fd, shared_ring::producer);
+        BOOST_TEST(r.peer() ==
+            shared_ring::peer_state::alive);
+        ::close(fd);
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testTimeout();
+        testTransfer();
+        testLateAttach();
+        testDeadPeer();
+    }
+};
+
+TEST_SUITE(
+    shared_ring_test,
+    "boost.buffers.shared_ring");
+
+} // buffers
+} // boost
+
+#endif
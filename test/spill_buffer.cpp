@@ -0,0 +1,251 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/spill_buffer.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/type_traits.hpp>
+#include <boost/system/system_error.hpp>
+#include <boost/static_assert.hpp>
+#include <cstdint>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<spill_buffer>::value);
+
+struct spill_buffer_test
+{
+    static
+    void
+    write(
+        spill_buffer& b,
+        std::string const& s)
+    {
+        b.commit(buffer_copy(
+            b.prepare(s.size()),
+            const_buffer(s.data(), s.size())));
+    }
+
+    // a string which is unlikely to
+    // line up with the window size
+    static
+    std::string
+    make_data(std::size_t n)
+    {
+        std::string s(n, 0);
+        std::uint32_t seed = 1;
+        for(auto& c : s)
+        {
+            seed = seed * 1103515245 + 12345;
+            c = static_cast<char>(seed >> 24);
+        }
+        return s;
+    }
+
+    void
+    testMembers()
+    {
+        auto const& pat = test_pattern();
+
+        // spill_buffer(std::size_t)
+        {
+            spill_buffer b(10);
+            BOOST_TEST_EQ(b.size(), 0);
+            BOOST_TEST_EQ(b.memory_limit(), 10);
+            BOOST_TEST_EQ(b.spilled(), 0);
+            BOOST_TEST_EQ(buffer_size(b.data()), 0);
+            b.commit(1);
+            b.consume(1);
+            BOOST_TEST_EQ(b.size(), 0);
+        }
+
+        // spill_buffer(std::size_t, std::size_t)
+        {
+            spill_buffer b(10, 20);
+            BOOST_TEST_EQ(b.max_size(), 20);
+            write(b, pat);
+            BOOST_TEST_EQ(b.spilled(), 5);
+            BOOST_TEST_THROWS(
+                b.prepare(6),
+                std::length_error);
+            BOOST_TEST_EQ(test_to_string(b.data()), pat);
+        }
+
+        // in memory
+        {
+            spill_buffer b(100);
+            write(b, pat);
+            BOOST_TEST_EQ(b.spilled(), 0);
+            BOOST_TEST_EQ(b.capacity(), 100);
+            auto const cb = b.data();
+            BOOST_TEST_EQ(cb[0].size(), pat.size());
+            BOOST_TEST_EQ(cb[1].size(), 0);
+        }
+
+        // spilling
+        {
+            spill_buffer b(10);
+            write(b, pat);
+            auto const cb = b.data();
+            BOOST_TEST_EQ(cb[0].size(), 10);
+            BOOST_TEST_EQ(cb[1].size(), 5);
+            BOOST_TEST_EQ(b.spilled(), 5);
+            BOOST_TEST_GE(b.capacity(),
+                10 + spill_buffer::window_size);
+            write(b, pat);
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                pat + pat);
+            b.consume(12);
+            BOOST_TEST_EQ(b.spilled(), 18);
+            BOOST_TEST_EQ(b.data()[0].size(), 18);
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                pat.substr(12) + pat);
+        }
+
+        // no memory at all
+        {
+            spill_buffer b(0);
+            write(b, pat);
+            BOOST_TEST_EQ(b.spilled(), pat.size());
+            BOOST_TEST_EQ(test_to_string(b.data()), pat);
+            b.consume(3);
+            write(b, "xyz");
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                pat.substr(3) + "xyz");
+        }
+
+        // readable bytes return to memory
+        {
+            spill_buffer b(20);
+            write(b, pat + pat);
+            b.consume(25);
+            BOOST_TEST_EQ(b.spilled(), 5);
+            write(b, "abc");
+            BOOST_TEST_EQ(b.spilled(), 0);
+            BOOST_TEST_EQ(b.capacity(), 20);
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                pat.substr(10) + "abc");
+        }
+
+        // draining truncates the file
+        {
+            spill_buffer b(10);
+            write(b, pat);
+            b.consume(pat.size());
+            BOOST_TEST_EQ(b.capacity(), 10);
+            write(b, pat);
+            BOOST_TEST_EQ(test_to_string(b.data()), pat);
+        }
+
+        // move
+        {
+            spill_buffer b0(10);
+            write(b0, pat);
+            spill_buffer b1(std::move(b0));
+            BOOST_TEST_EQ(b0.size(), 0);
+            BOOST_TEST_EQ(test_to_string(b1.data()), pat);
+            spill_buffer b2(4);
+            write(b2, "abcdef");
+            b2 = std::move(b1);
+            BOOST_TEST_EQ(b1.size(), 0);
+            BOOST_TEST_EQ(test_to_string(b2.data()), pat);
+            write(b2, "xyz");
+            BOOST_TEST_EQ(test_to_string(b2.data()),
+                pat + "xyz");
+        }
+
+        // bad directory
+        {
+            spill_buffer b(4, std::size_t(-1),
+                "/nonexistent/boost.buffers");
+            write(b, "ab");
+            b.prepare(2);
+            BOOST_TEST_THROWS(
+                b.prepare(3),
+                system::system_error);
+
+            // the failed prepare left
+            // nothing to commit
+            b.commit(3);
+            BOOST_TEST_EQ(b.size(), 2);
+            write(b, "cd");
+            BOOST_TEST_EQ(test_to_string(b.data()), "abcd");
+        }
+    }
+
+    void
+    testStream()
+    {
+        // several windows pass through the file
+        // while the backlog stays larger than
+        // the memory
+        auto const s = make_data(
+            3 * spill_buffer::window_size + 12345);
+        spill_buffer b(4096);
+        std::string out;
+        std::size_t pos = 0;
+        while(pos < s.size())
+        {
+            auto n = s.size() - pos;
+            if(n > 100000)
+                n = 100000;
+            write(b, s.substr(pos, n));
+            pos += n;
+            if(b.size() > 300000)
+            {
+                auto const t = test_to_string(b.data());
+                auto const k = t.size() - 200000;
+                out.append(t, 0, k);
+                b.consume(k);
+            }
+            BOOST_TEST_LE(b.capacity(), 4096 +
+                4 * spill_buffer::window_size);
+        }
+        out += test_to_string(b.data());
+        BOOST_TEST(out == s);
+    }
+
+    void
+    testBuffer()
+    {
+        auto const& pat = test_pattern();
+        for(std::size_t i = 0; i <= pat.size(); ++i)
+        {
+            spill_buffer b(i);
+            write(b, pat.substr(0, i));
+            write(b, pat.substr(i));
+            BOOST_TEST_EQ(test_to_string(
+                b.data()), pat);
+            test_buffer_sequence(b.data());
+        }
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testStream();
+        testBuffer();
+    }
+};
+
+TEST_SUITE(
+    spill_buffer_test,
+    "boost.buffers.spill_buffer");
+
+} // buffers
+} // boost
+
+#endif
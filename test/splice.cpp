@@ -0,0 +1,234 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/splice.hpp>
+
+#ifdef BOOST_BUFFERS_HAS_SPLICE
+
+#include <boost/buffers/const_buffer_pair.hpp>
+#include <boost/buffers/flat_buffer.hpp>
+#include <boost/buffers/pinned_pool.hpp>
+#include <boost/system/system_error.hpp>
+#include <cstring>
+#include <string>
+#include "test_helpers.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace boost {
+namespace buffers {
+
+struct splice_test
+{
+    // both ends of a pipe, closed on destruction
+    struct pipe_pair
+    {
+        int fd[2] = { -1, -1 };
+
+        pipe_pair()
+        {
+            BOOST_TEST_EQ(::pipe2(fd, O_CLOEXEC), 0);
+        }
+
+        ~pipe_pair()
+        {
+            ::close(fd[0]);
+            ::close(fd[1]);
+        }
+    };
+
+    static
+    std::string
+    read_some(int fd, std::size_t n)
+    {
+        std::string s(n, 0);
+        std::size_t pos = 0;
+        while(pos < n)
+        {
+            auto const rv = ::read(
+                fd, &s[pos], n - pos);
+            if(rv <= 0)
+                break;
+            pos += static_cast<std::size_t>(rv);
+        }
+        s.resize(pos);
+        return s;
+    }
+
+    void
+    testVmsplice()
+    {
+        auto const& pat = test_pattern();
+
+        // a buffer sequence
+        {
+            pipe_pair p;
+            const_buffer_pair b(
+                const_buffer(pat.data(), 3),
+                const_buffer(pat.data() + 3,
+                    pat.size() - 3));
+            BOOST_TEST_EQ(vmsplice_some(
+                p.fd[1], b), pat.size());
+            BOOST_TEST_EQ(pipe_pending(p.fd[1]), pat.size());
+            BOOST_TEST_EQ(read_some(
+                p.fd[0], pat.size()), pat);
+            BOOST_TEST_EQ(pipe_pending(p.fd[0]), 0);
+            BOOST_TEST_EQ(vmsplice_some(
+                p.fd[1], const_buffer()), 0);
+        }
+
+        // a dynamic buffer, into a full pipe
+        {
+            pipe_pair p;
+            BOOST_TEST_NE(::fcntl(p.fd[1],
+                F_SETFL, O_NONBLOCK), -1);
+            std::string s;
+            for(int i = 0; i < 30000; ++i)
+                s += pat;
+            auto const total = s.size();
+            flat_buffer b(&s[0], total, total);
+            std::size_t sent = 0;
+            for(;;)
+            {
+                auto const n = vmsplice_from(p.fd[1], b);
+                if(n == 0)
+                    break;
+                sent += n;
+            }
+            BOOST_TEST_GT(sent, 0);
+            BOOST_TEST_LT(sent, total);
+            BOOST_TEST_EQ(b.size(), total - sent);
+            BOOST_TEST_EQ(pipe_pending(p.fd[1]), sent);
+
+            // the pipe still refers to the
+            // string, which is left intact
+            auto const got = read_some(p.fd[0], sent);
+            BOOST_TEST_EQ(got.size(), sent);
+            BOOST_TEST(std::memcmp(got.data(),
+                s.data(), sent) == 0);
+        }
+
+        // gift
+        {
+            pipe_pair p;
+            pinned_pool::options opt;
+            opt.blocks = 1;
+            opt.block_size = 1;
+            pinned_pool pool(opt);
+            auto const b = pool.allocate();
+            std::memset(b.data(), '*', b.size());
+            BOOST_TEST_EQ(vmsplice_some(p.fd[1],
+                const_buffer(b.data(), b.size()), true),
+                b.size());
+            BOOST_TEST_EQ(read_some(p.fd[0], b.size()),
+                std::string(b.size(), '*'));
+            BOOST_TEST_THROWS(vmsplice_some(p.fd[1],
+                const_buffer(b.data(), 1), true),
+                std::invalid_argument);
+            BOOST_TEST_THROWS(vmsplice_some(p.fd[1],
+                const_buffer(static_cast<char*>(
+                    b.data()) + 1, b.size() - 1), true),
+                std::invalid_argument);
+            pool.deallocate(b.data());
+        }
+
+        // errors
+        BOOST_TEST_THROWS(vmsplice_some(-1,
+            const_buffer(pat.data(), pat.size())),
+            system::system_error);
+        BOOST_TEST_THROWS(
+            pipe_pending(-1),
+            system::system_error);
+    }
+
+    void
+    testSplice()
+    {
+        auto const& pat = test_pattern();
+        std::string path = "/tmp/boost.buffers.XXXXXX";
+        auto const fd = ::mkstemp(&path[0]);
+        BOOST_TEST_NE(fd, -1);
+        ::unlink(path.c_str());
+
+        // pipe to file, at an offset
+        {
+            pipe_pair p;
+            BOOST_TEST_EQ(vmsplice_some(p.fd[1],
+                const_buffer(pat.data(), pat.size())),
+                pat.size());
+            std::uint64_t off = 0;
+            BOOST_TEST_EQ(splice_some(p.fd[0], fd,
+                5, nullptr, &off), 5);
+            BOOST_TEST_EQ(off, 5);
+            BOOST_TEST_EQ(splice_some(p.fd[0], fd,
+                100, nullptr, &off), pat.size() - 5);
+            BOOST_TEST_EQ(off, pat.size());
+
+            // the file position is unchanged
+            BOOST_TEST_EQ(::lseek(fd, 0, SEEK_CUR), 0);
+        }
+
+        // file to pipe, at the file position
+        {
+            pipe_pair p;
+            BOOST_TEST_EQ(::lseek(fd, 3, SEEK_SET), 3);
+            BOOST_TEST_EQ(splice_some(fd, p.fd[1],
+                4), 4);
+            BOOST_TEST_EQ(read_some(p.fd[0], 4),
+                pat.substr(3, 4));
+            std::uint64_t off = 10;
+            BOOST_TEST_EQ(splice_some(fd, p.fd[1],
+                100, &off), pat.size() - 10);
+            BOOST_TEST_EQ(off, pat.size());
+            BOOST_TEST_EQ(read_some(p.fd[0],
+                pat.size() - 10), pat.substr(10));
+
+            // end of file
+            BOOST_TEST_EQ(splice_some(fd, p.fd[1],
+                100, &off), 0);
+        }
+
+        // pipe to pipe
+        {
+            pipe_pair p0;
+            pipe_pair p1;
+            BOOST_TEST_EQ(vmsplice_some(p0.fd[1],
+                const_buffer(pat.data(), pat.size())),
+                pat.size());
+            BOOST_TEST_EQ(splice_some(p0.fd[0],
+                p1.fd[1], 100), pat.size());
+            BOOST_TEST_EQ(read_some(p1.fd[0],
+                pat.size()), pat);
+        }
+
+        // errors
+        BOOST_TEST_THROWS(
+            splice_some(fd, fd, 1),
+            system::system_error);
+        ::close(fd);
+    }
+
+    void
+    run()
+    {
+        testVmsplice();
+        testSplice();
+    }
+};
+
+TEST_SUITE(
+    splice_test,
+    "boost.buffers.splice");
+
+} // buffers
+} // boost
+
+#endif
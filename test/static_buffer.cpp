@@ -0,0 +1,152 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/static_buffer.hpp>
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/type_traits.hpp>
+#include <boost/static_assert.hpp>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<
+        static_buffer<16>>::value);
+
+BOOST_STATIC_ASSERT(
+    static_buffer<16>::max_size() == 16);
+
+struct static_buffer_test
+{
+    template<class DynamicBuffer>
+    static
+    void
+    write(
+        DynamicBuffer& b,
+        std::string const& s)
+    {
+        b.commit(buffer_copy(
+            b.prepare(s.size()),
+            const_buffer(s.data(), s.size())));
+    }
+
+    void
+    testMembers()
+    {
+        auto const& pat = test_pattern();
+
+        // static_buffer()
+        {
+            static_buffer<20> b;
+            BOOST_TEST_EQ(b.size(), 0);
+            BOOST_TEST_EQ(b.max_size(), 20);
+            BOOST_TEST_EQ(b.capacity(), 20);
+            BOOST_TEST_EQ(buffer_size(b.data()), 0);
+        }
+
+        // prepare(std::size_t)
+        {
+            static_buffer<20> b;
+            BOOST_TEST_EQ(b.prepare(20).size(), 20);
+            BOOST_TEST_THROWS(
+                b.prepare(21),
+                std::invalid_argument);
+            write(b, pat);
+            BOOST_TEST_THROWS(
+                b.prepare(6),
+                std::invalid_argument);
+            BOOST_TEST_EQ(b.prepare(5).size(), 5);
+        }
+
+        // commit(std::size_t)
+        {
+            static_buffer<20> b;
+            b.prepare(10);
+            b.commit(100);
+            BOOST_TEST_EQ(b.size(), 10);
+            b.commit(1);
+            BOOST_TEST_EQ(b.size(), 10);
+        }
+
+        // consume(std::size_t)
+        {
+            static_buffer<20> b;
+            write(b, pat);
+            b.consume(5);
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                pat.substr(5));
+
+            // the consumed bytes are reclaimed
+            auto const p = static_cast<
+                unsigned char const*>(b.data().data()) - 5;
+            write(b, "0123456789");
+            BOOST_TEST_EQ(b.data().data(), p);
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                pat.substr(5) + "0123456789");
+            b.consume(100);
+            BOOST_TEST_EQ(b.size(), 0);
+        }
+
+        // copy
+        {
+            static_buffer<20> b0;
+            write(b0, pat);
+            b0.consume(3);
+            static_buffer<20> b1(b0);
+            BOOST_TEST_EQ(test_to_string(b1.data()),
+                pat.substr(3));
+            BOOST_TEST_NE(b1.data().data(),
+                b0.data().data());
+            b0.consume(3);
+            static_buffer<20> b2;
+            write(b2, "xyz");
+            b2 = b0;
+            BOOST_TEST_EQ(test_to_string(b2.data()),
+                pat.substr(6));
+            b2 = b2;
+            BOOST_TEST_EQ(test_to_string(b2.data()),
+                pat.substr(6));
+            BOOST_TEST_EQ(b2.prepare(11).size(), 11);
+        }
+    }
+
+    void
+    testBuffer()
+    {
+        auto const& pat = test_pattern();
+        for(std::size_t i = 0; i <= pat.size(); ++i)
+        {
+            static_buffer<15> b;
+            write(b, std::string(i, '-'));
+            b.consume(i);
+            write(b, pat.substr(0, i));
+            write(b, pat.substr(i));
+            BOOST_TEST_EQ(test_to_string(
+                b.data()), pat);
+            test_buffer_sequence(b.data());
+        }
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testBuffer();
+    }
+};
+
+TEST_SUITE(
+    static_buffer_test,
+    "boost.buffers.static_buffer");
+
+} // buffers
+} // boost
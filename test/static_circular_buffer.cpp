@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/static_circular_buffer.hpp>
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/type_traits.hpp>
+#include <boost/static_assert.hpp>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<
+        static_circular_buffer<16>>::value);
+
+struct static_circular_buffer_test
+{
+    template<class DynamicBuffer>
+    static
+    void
+    write(
+        DynamicBuffer& b,
+        std::string const& s)
+    {
+        b.commit(buffer_copy(
+            b.prepare(s.size()),
+            const_buffer(s.data(), s.size())));
+    }
+
+    void
+    testMembers()
+    {
+        auto const& pat = test_pattern();
+
+        // static_circular_buffer()
+        {
+            static_circular_buffer<15> b;
+            BOOST_TEST_EQ(b.size(), 0);
+            BOOST_TEST_EQ(b.max_size(), 15);
+            BOOST_TEST_EQ(b.capacity(), 15);
+        }
+
+        // prepare(std::size_t)
+        {
+            static_circular_buffer<15> b;
+            BOOST_TEST_THROWS(
+                b.prepare(16),
+                std::length_error);
+            write(b, pat.substr(0, 10));
+            b.consume(8);
+            auto const mb = b.prepare(13);
+            BOOST_TEST_EQ(buffer_size(mb), 13);
+            BOOST_TEST_EQ(mb.begin()->size(), 5);
+        }
+
+        // commit(std::size_t)
+        {
+            static_circular_buffer<15> b;
+            b.prepare(15);
+            b.commit(7);
+            BOOST_TEST_EQ(b.size(), 7);
+            BOOST_TEST_EQ(b.capacity(), 8);
+        }
+
+        // consume(std::size_t)
+        {
+            static_circular_buffer<15> b;
+            write(b, pat);
+            b.consume(10);
+            write(b, "abcdefgh");
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                pat.substr(10) + "abcdefgh");
+            b.consume(9);
+            BOOST_TEST_EQ(test_to_string(b.data()),
+                "efgh");
+            b.consume(4);
+            BOOST_TEST_EQ(b.size(), 0);
+            BOOST_TEST_EQ(b.prepare(15).begin()->size(), 15);
+        }
+
+        // copy
+        {
+            static_circular_buffer<15> b0;
+            write(b0, pat);
+            b0.consume(10);
+            write(b0, "abcdefgh");
+            static_circular_buffer<15> b1(b0);
+            BOOST_TEST_EQ(test_to_string(b1.data()),
+                pat.substr(10) + "abcdefgh");
+            BOOST_TEST_EQ(b1.data().begin()->size(), 13);
+            static_circular_buffer<15> b2;
+            write(b2, "xyz");
+            b2 = b0;
+            BOOST_TEST_EQ(test_to_string(b2.data()),
+                pat.substr(10) + "abcdefgh");
+            b2 = b2;
+            BOOST_TEST_EQ(test_to_string(b2.data()),
+                pat.substr(10) + "abcdefgh");
+        }
+    }
+
+    void
+    testBuffer()
+    {
+        auto const& pat = test_pattern();
+        for(std::size_t i = 0; i <= pat.size(); ++i)
+        for(std::size_t j = 0; j <= pat.size(); ++j)
+        {
+            static_circular_buffer<15> b;
+            write(b, std::string(i, '-'));
+            b.consume(i > 0 ? i - 1 : 0);
+            auto const n = b.capacity() < j
+                ? b.capacity() : j;
+            write(b, pat.substr(0, n));
+            b.consume(i > 0 ? 1 : 0);
+            write(b, pat.substr(n,
+                b.capacity() < pat.size() - n
+                    ? b.capacity() : pat.size() - n));
+            if(b.size() == pat.size())
+            {
+                BOOST_TEST_EQ(test_to_string(
+                    b.data()), pat);
+                test_buffer_sequence(b.data());
+            }
+        }
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testBuffer();
+    }
+};
+
+TEST_SUITE(
+    static_circular_buffer_test,
+    "boost.buffers.static_circular_buffer");
+
+} // buffers
+} // boost
@@ -157,13 +157,137 @@ struct string_buffer_test
                 }
                 BOOST_TEST(s.empty());
             }
+
+            // consumed bytes are erased lazily
+            {
+                s = std::string(100, '-') + "12345";
+                {
+                    string_buffer b(&s, std::size_t(-1), 50);
+                    auto const p = s.data();
+                    b.consume(30);
+                    BOOST_TEST_EQ(s.size(), 105);
+                    BOOST_TEST_EQ(b.size(), 75);
+                    BOOST_TEST_EQ(b.data().data(), p + 30);
+                    b.consume(20);
+                    BOOST_TEST_EQ(s.size(), 105);
+                    b.consume(3);
+                    BOOST_TEST_EQ(s.size(), 52);
+                    BOOST_TEST_EQ(b.data().data(), p);
+                    BOOST_TEST_EQ(test_to_string(b.data()),
+                        std::string(47, '-') + "12345");
+                    b.consume(10);
+                    BOOST_TEST_EQ(s.size(), 52);
+                    BOOST_TEST_EQ(test_to_string(b.data()),
+                        std::string(37, '-') + "12345");
+                }
+                BOOST_TEST_EQ(s,
+                    std::string(37, '-') + "12345");
+            }
+
+            // prepared bytes are not moved by erase
+            {
+                s.clear();
+                {
+                    string_buffer b(&s, std::size_t(-1), 0);
+                    b.commit(buffer_copy(
+                        b.prepare(100),
+                        make_buffer("0123456789", 10)));
+                    b.consume(6);
+                    BOOST_TEST_EQ(s.size(), 4);
+                    BOOST_TEST_EQ(test_to_string(
+                        b.data()), "6789");
+                }
+                BOOST_TEST_EQ(s, "6789");
+            }
+
+            // the consumed prefix is reused
+            {
+                s = "12345";
+                auto const cap = s.capacity();
+                std::string const src(cap - 1, 'a');
+                {
+                    string_buffer b(&s);
+                    b.consume(4);
+                    BOOST_TEST_EQ(s.size(), 5);
+                    b.commit(buffer_copy(
+                        b.prepare(cap - 1),
+                        make_buffer(src.data(), src.size())));
+                    BOOST_TEST_EQ(s.capacity(), cap);
+                    BOOST_TEST_EQ(b.size(), cap);
+                    BOOST_TEST_EQ(s.substr(0, 2), "5a");
+                    b.consume(2);
+                    BOOST_TEST_EQ(b.size(), cap - 2);
+                }
+                BOOST_TEST_EQ(s, src.substr(1));
+            }
+
+            // draining in small pieces
+            {
+                s = std::string(1000000, 'x');
+                {
+                    string_buffer b(&s);
+                    for(std::size_t i = 0; i < 999999; ++i)
+                        b.consume(1);
+                    BOOST_TEST_EQ(b.size(), 1);
+                }
+                BOOST_TEST_EQ(s, "x");
+            }
+
+            // prepared space does not fill
+            // the reserved capacity
+            {
+                s.clear();
+                s.reserve(1 << 20);
+                std::string const pad(1000, '-');
+                std::string const rec(100, '*');
+                {
+                    string_buffer b(&s, std::size_t(-1), 0);
+                    b.commit(buffer_copy(
+                        b.prepare(1000),
+                        make_buffer(pad.data(), pad.size())));
+                    for(std::size_t i = 0; i < 2000; ++i)
+                    {
+                        b.commit(buffer_copy(
+                            b.prepare(4096),
+                            make_buffer(rec.data(), rec.size())));
+                        BOOST_TEST_LE(s.size(),
+                            2 * b.size() + 4096);
+                        b.consume(100);
+                    }
+                    BOOST_TEST_EQ(test_to_string(
+                        b.data()), std::string(1000, '*'));
+                }
+                BOOST_TEST_EQ(s, std::string(1000, '*'));
+            }
+        }
+    }
+
+    void
+    testPmr()
+    {
+#ifdef BOOST_BUFFERS_HAS_PMR
+        BOOST_STATIC_ASSERT(
+            is_dynamic_buffer<pmr::string_buffer>::value);
+
+        std::pmr::unsynchronized_pool_resource mr;
+        std::pmr::string s(&mr);
+        {
+            pmr::string_buffer b(&s);
+            auto const& pat = test_pattern();
+            b.commit(buffer_copy(
+                b.prepare(pat.size()),
+                const_buffer(pat.data(), pat.size())));
+            b.consume(3);
         }
+        BOOST_TEST_EQ(std::string(s), test_pattern().substr(3));
+#endif
     }
 
     void
     run()
     {
         testMembers();
+        testPmr();
     }
 };
 
@@ -15,9 +15,15 @@
 #include <boost/buffers/buffer_size.hpp>
 #include <boost/buffers/make_buffer.hpp>
 #include <boost/buffers/range.hpp>
+#include <memory>
 #include <string>
 #include "test_suite.hpp"
 
+#ifdef BOOST_BUFFERS_HAS_POSIX
+#include <cstdlib>
+#include <unistd.h>
+#endif
+
 namespace boost {
 namespace buffers {
 
@@ -30,6 +36,60 @@ test_pattern()
     return pat;
 }
 
+// An allocator which counts the
+// bytes it has outstanding
+template<class T>
+struct test_allocator
+{
+    using value_type = T;
+
+    std::size_t* bytes;
+
+    explicit
+    test_allocator(
+        std::size_t* p) noexcept
+        : bytes(p)
+    {
+    }
+
+    template<class U>
+    test_allocator(
+        test_allocator<U> const& other) noexcept
+        : bytes(other.bytes)
+    {
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        *bytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        *bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template<class U>
+    bool
+    operator==(
+        test_allocator<U> const& other) const noexcept
+    {
+        return bytes == other.bytes;
+    }
+
+    template<class U>
+    bool
+    operator!=(
+        test_allocator<U> const& other) const noexcept
+    {
+        return bytes != other.bytes;
+    }
+};
+
 template<class Buffers>
 std::string
 test_to_string(Buffers const& bs)
@@ -42,6 +102,50 @@ test_to_string(Buffers const& bs)
     return s;
 }
 
+#ifdef BOOST_BUFFERS_HAS_POSIX
+
+// An empty file in dir, open for reading
+// and writing, removed on destruction
+struct test_temp_file
+{
+    std::string path;
+    int fd = -1;
+
+    explicit
+    test_temp_file(
+        char const* dir = "/tmp")
+        : path(std::string(dir) +
+            "/boost.buffers.XXXXXX")
+    {
+        fd = ::mkstemp(&path[0]);
+        BOOST_TEST_NE(fd, -1);
+    }
+
+    ~test_temp_file()
+    {
+        if(fd != -1)
+            ::close(fd);
+        ::unlink(path.c_str());
+    }
+
+    void
+    append(std::string const& s)
+    {
+        std::size_t n = 0;
+        while(n < s.size())
+        {
+            auto const rv = ::write(fd,
+                s.data() + n, s.size() - n);
+            if(rv <= 0)
+                break;
+            n += static_cast<std::size_t>(rv);
+        }
+        BOOST_TEST_EQ(n, s.size());
+    }
+};
+
+#endif
+
 template<class T>
 void
 test_buffer_sequence(T&& t)
@@ -0,0 +1,267 @@
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/CPPAlliance/buffers
+//
+
+// Test that header file is self-contained.
+#include <boost/buffers/vector_buffer.hpp>
+
+#include <boost/buffers/buffer_copy.hpp>
+#include <boost/buffers/type_traits.hpp>
+#include <boost/static_assert.hpp>
+#include "test_helpers.hpp"
+
+namespace boost {
+namespace buffers {
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<vector_buffer>::value);
+
+BOOST_STATIC_ASSERT(
+    is_dynamic_buffer<basic_vector_buffer<
+        std::allocator<unsigned char>>>::value);
+
+struct vector_buffer_test
+{
+    using vector_type =
+        vector_buffer::vector_type;
+
+    static
+    vector_type
+    make_vector(std::string const& s)
+    {
+        return vector_type(s.begin(), s.end());
+    }
+
+    static
+    std::string
+    to_string(vector_type const& v)
+    {
+        return std::string(v.begin(), v.end());
+    }
+
+    template<class DynamicBuffer>
+    static
+    void
+    write(
+        DynamicBuffer& b,
+        std::string const& s)
+    {
+        b.commit(buffer_copy(
+            b.prepare(s.size()),
+            const_buffer(s.data(), s.size())));
+    }
+
+    void
+    testMembers()
+    {
+        auto const& pat = test_pattern();
+
+        // basic_vector_buffer(vector_type*)
+        {
+            vector_type v;
+            {
+                vector_buffer b(&v);
+                BOOST_TEST_EQ(b.size(), 0);
+                BOOST_TEST_EQ(b.max_size(), v.max_size());
+            }
+            BOOST_TEST(v.empty());
+
+            v = make_vector(pat);
+            {
+                vector_buffer b(&v, 10);
+                BOOST_TEST_EQ(b.max_size(), 10);
+                BOOST_TEST_EQ(b.size(), 10);
+                BOOST_TEST_THROWS(
+                    b.prepare(1),
+                    std::invalid_argument);
+            }
+            BOOST_TEST_EQ(to_string(v), pat.substr(0, 10));
+        }
+
+        // basic_vector_buffer(basic_vector_buffer&&)
+        {
+            vector_type v;
+            {
+                vector_buffer b0(&v);
+                vector_buffer b1(std::move(b0));
+                write(b1, pat);
+            }
+            BOOST_TEST_EQ(to_string(v), pat);
+        }
+
+        // prepare, commit
+        {
+            vector_type v;
+            {
+                vector_buffer b(&v);
+                auto const mb = b.prepare(10);
+                BOOST_TEST_EQ(mb.size(), 10);
+                BOOST_TEST_GE(b.capacity(), 10);
+                b.commit(buffer_copy(mb,
+                    const_buffer(pat.data(), 5)));
+                BOOST_TEST_EQ(b.size(), 5);
+                BOOST_TEST_EQ(test_to_string(b.data()),
+                    pat.substr(0, 5));
+            }
+            BOOST_TEST_EQ(to_string(v), pat.substr(0, 5));
+        }
+
+        // prepared bytes are not initialized
+        {
+            vector_type v = make_vector(pat);
+            v.resize(5);
+            BOOST_TEST_GE(v.capacity(), pat.size());
+            auto const p = v.data();
+            {
+                vector_buffer b(&v);
+                auto const mb = b.prepare(pat.size() - 5);
+                BOOST_TEST_EQ(mb.data(), p + 5);
+                BOOST_TEST_EQ(test_to_string(mb),
+                    pat.substr(5));
+            }
+        }
+
+        // consumed bytes are erased lazily
+        {
+            vector_type v = make_vector(
+                std::string(100, '-') + "12345");
+            {
+                vector_buffer b(&v, std::size_t(-1), 50);
+                auto const p = v.data();
+                b.consume(30);
+                BOOST_TEST_EQ(v.size(), 105);
+                BOOST_TEST_EQ(b.data().data(), p + 30);
+                b.consume(23);
+                BOOST_TEST_EQ(v.size(), 52);
+                BOOST_TEST_EQ(b.data().data(), p);
+                BOOST_TEST_EQ(test_to_string(b.data()),
+                    std::string(47, '-') + "12345");
+                b.consume(10);
+            }
+            BOOST_TEST_EQ(to_string(v),
+                std::string(37, '-') + "12345");
+        }
+
+        // prepared bytes are not moved by erase
+        {
+            vector_type v;
+            {
+                vector_buffer b(&v, std::size_t(-1), 0);
+                b.prepare(100);
+                write(b, "0123456789");
+                BOOST_TEST_EQ(v.size(), 100);
+                b.consume(6);
+                BOOST_TEST_EQ(v.size(), 4);
+                BOOST_TEST_EQ(test_to_string(
+                    b.data()), "6789");
+            }
+            BOOST_TEST_EQ(to_string(v), "6789");
+        }
+
+        // the consumed prefix is reused
+        {
+            vector_type v = make_vector(pat);
+            v.shrink_to_fit();
+            auto const cap = v.capacity();
+            {
+                vector_buffer b(&v);
+                b.consume(10);
+                write(b, std::string(cap - 6, '*'));
+                BOOST_TEST_EQ(v.capacity(), cap);
+                BOOST_TEST_EQ(test_to_string(b.data()),
+                    pat.substr(10) + std::string(cap - 6, '*'));
+            }
+            BOOST_TEST_EQ(to_string(v),
+                pat.substr(10) + std::string(cap - 6, '*'));
+        }
+
+        // consume everything
+        {
+            vector_type v = make_vector(pat);
+            {
+                vector_buffer b(&v);
+                b.consume(100);
+                BOOST_TEST_EQ(b.size(), 0);
+            }
+            BOOST_TEST(v.empty());
+        }
+
+        // allocator
+        {
+            using alloc_type = default_init_allocator<
+                unsigned char, test_allocator<unsigned char>>;
+            std::size_t bytes = 0;
+            {
+                std::vector<unsigned char, alloc_type> v{
+                    alloc_type(test_allocator<
+                        unsigned char>(&bytes)) };
+                basic_vector_buffer<alloc_type> b(&v);
+                write(b, pat);
+                BOOST_TEST_GE(bytes, pat.size());
+                BOOST_TEST_EQ(test_to_string(b.data()), pat);
+            }
+            BOOST_TEST_EQ(bytes, 0);
+        }
+    }
+
+    void
+    testBuffer()
+    {
+        auto const& pat = test_pattern();
+        for(std::size_t i = 0; i <= pat.size(); ++i)
+        {
+            vector_type v;
+            vector_buffer b(&v, std::size_t(-1), 0);
+            write(b, std::string(i, '-'));
+            b.consume(i);
+            write(b, pat.substr(0, i));
+            write(b, pat.substr(i));
+            BOOST_TEST_EQ(test_to_string(
+                b.data()), pat);
+            test_buffer_sequence(b.data());
+        }
+    }
+
+    void
+    testPmr()
+    {
+#ifdef BOOST_BUFFERS_HAS_PMR
+        BOOST_STATIC_ASSERT(
+            is_dynamic_buffer<pmr::vector_buffer>::value);
+
+        auto const& pat = test_pattern();
+        std::pmr::unsynchronized_pool_resource mr;
+        std::pmr::polymorphic_allocator<
+            unsigned char> alloc(&mr);
+        pmr::vector_buffer::vector_type v(alloc);
+        {
+            pmr::vector_buffer b(&v);
+            write(b, pat);
+            b.consume(3);
+        }
+        BOOST_TEST_EQ(std::string(v.begin(), v.end()),
+            pat.substr(3));
+        BOOST_TEST(v.get_allocator().resource() == &mr);
+#endif
+    }
+
+    void
+    run()
+    {
+        testMembers();
+        testBuffer();
+        testPmr();
+    }
+};
+
+TEST_SUITE(
+    vector_buffer_test,
+    "boost.buffers.vector_buffer");
+
+} // buffers
+} // boost